@@ -0,0 +1,165 @@
+//
+//  AnalyticsCatalog.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsCatalog.h"
+#include "AnalyticsRouter.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <string>
+
+// %.15g of a double, or an int, with room to spare
+static const size_t kNumberSize = 32;
+
+#define SDKBOX_CATALOG_PARAM_SPEC(type, key, use) \
+    { #key, sizeof(#key) - 1, CatalogTypeOf<type>::value, CatalogUse::use },
+#define SDKBOX_CATALOG_PARAM_TABLE(id, name, category, providers, params) \
+    static const CatalogParamSpec k##id##Params[] = { params { nullptr, 0, CatalogType::Int, CatalogUse::Param } };
+#define SDKBOX_CATALOG_EVENT_SPEC(id, name, category, providers, params) \
+    { #id, name, category, providers, k##id##Params, sizeof(k##id##Params) / sizeof(k##id##Params[0]) - 1 },
+
+SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_PARAM_TABLE, SDKBOX_CATALOG_PARAM_SPEC)
+
+static const CatalogEventSpec kEvents[] = {
+    SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_EVENT_SPEC, SDKBOX_CATALOG_NO_PARAM)
+};
+
+static_assert(sizeof(kEvents) / sizeof(kEvents[0]) == AnalyticsCatalog::kEventCount, "catalog tables out of step");
+
+// the catalog's strings, built once; which providers take an event depends
+// on the router's rules and is looked up on every emit
+struct CatalogNames
+{
+    CatalogNames()
+    {
+        for (int i = 0; i < AnalyticsCatalog::kEventCount; i++)
+        {
+            names[i] = kEvents[i].name;
+            categories[i] = kEvents[i].category;
+        }
+    }
+
+    std::string names[AnalyticsCatalog::kEventCount];
+    std::string categories[AnalyticsCatalog::kEventCount];
+};
+
+static const CatalogNames& catalogNames()
+{
+    static const CatalogNames names;
+    return names;
+}
+
+static const char* typeName(CatalogType type)
+{
+    switch (type)
+    {
+        case CatalogType::Int:    return "int";
+        case CatalogType::Double: return "double";
+        case CatalogType::Bool:   return "bool";
+        case CatalogType::String: return "string";
+    }
+    return "?";
+}
+
+static StringRef format(const CatalogValue& value, char* buf)
+{
+    int length = 0;
+    switch (value.type)
+    {
+        case CatalogType::Int:
+            length = snprintf(buf, kNumberSize, "%d", value.i);
+            break;
+        case CatalogType::Double:
+            length = snprintf(buf, kNumberSize, "%.15g", value.d);
+            break;
+        case CatalogType::Bool:
+            return value.b ? StringRef("true", 4) : StringRef("false", 5);
+        case CatalogType::String:
+            return value.s;
+    }
+    return StringRef(buf, length > 0 ? (size_t)length : 0);
+}
+
+const CatalogEventSpec& AnalyticsCatalog::getSpec(EventId id)
+{
+    return kEvents[id];
+}
+
+int AnalyticsCatalog::emit(EventId id, const CatalogValue* values, size_t count)
+{
+    if (id < 0 || id >= kEventCount)
+    {
+        return 0;
+    }
+    const CatalogEventSpec& spec = kEvents[id];
+    if (count != spec.paramCount)
+    {
+        CCLOG("[AnalyticsCatalog] %s takes %u params, got %u", spec.id, spec.paramCount, (unsigned)count);
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (values[i].type != spec.params[i].type)
+        {
+            CCLOG("[AnalyticsCatalog] %s.%s is %s, got %s", spec.id, spec.params[i].key,
+                  typeName(spec.params[i].type), typeName(values[i].type));
+            return 0;
+        }
+    }
+
+    const CatalogNames& names = catalogNames();
+    auto router = AnalyticsRouter::getInstance();
+    uint32_t routes = router->routesFor(names.names[id]) & spec.providers;
+    if (!routes)
+    {
+        return 0;
+    }
+
+    AnalyticsRouterEvent event(names.names[id]);
+    event.category = names.categories[id];
+
+    char numbers[kMaxParams][kNumberSize];
+    StringRef formatted[kMaxParams];
+    size_t paramCount = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const CatalogValue& value = values[i];
+        switch (spec.params[i].use)
+        {
+            case CatalogUse::Value:
+                event.value = value.i;
+                continue;
+            case CatalogUse::Revenue:
+                event.revenue = (float)value.d;
+                continue;
+            case CatalogUse::Currency:
+                event.currency.assign(value.s.data, value.s.size);
+                continue;
+            case CatalogUse::Label:
+                event.label.assign(value.s.data, value.s.size);
+                break;
+            case CatalogUse::Param:
+                break;
+        }
+        formatted[i] = format(value, numbers[i]);
+        bytes += spec.params[i].keyLength + formatted[i].size;
+        paramCount++;
+    }
+
+    event.params.reserve(paramCount, bytes);
+    for (size_t i = 0; i < count; i++)
+    {
+        const CatalogParamSpec& param = spec.params[i];
+        if (param.use == CatalogUse::Param || param.use == CatalogUse::Label)
+        {
+            event.params.set(param.key, param.keyLength, formatted[i].data, formatted[i].size);
+        }
+    }
+
+    return router->track(event, routes);
+}
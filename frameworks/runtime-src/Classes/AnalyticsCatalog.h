@@ -0,0 +1,200 @@
+//
+//  AnalyticsCatalog.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsCatalog__
+#define __template__AnalyticsCatalog__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "EventParams.h"
+#include "PluginEventBus.h"
+#include "StringInterner.h"
+
+/**
+ * The analytics events the game sends, declared once:
+ *
+ *   EVENT(Id, "name", "category", providers, params)
+ *   PARAM(type, key, use)
+ *
+ * type is int, double, bool or StringRef, and key is also the name of the
+ * field. use says where the value goes in the AnalyticsRouterEvent:
+ *
+ *   Param      params only
+ *   Label      label, and params
+ *   Value      value, must be int
+ *   Revenue    revenue, must be double
+ *   Currency   currency
+ *
+ * category may be empty, the router then uses the provider's rule or the
+ * event name. providers is a mask of kCatalog* bits; the router's rules
+ * from sdkbox_config.json still apply on top of it.
+ *
+ * Each entry becomes a struct AnalyticsCatalog::Id with one field per
+ * PARAM and an AnalyticsCatalog::emit() overload for it, and a function
+ * sdkbox.AnalyticsCatalog.Id in JS and Lua taking the params in order.
+ */
+#define SDKBOX_ANALYTICS_CATALOG(EVENT, PARAM) \
+    EVENT(AdShown, "ad_shown", "ads", kCatalogAllProviders, \
+          PARAM(StringRef, network, Label) \
+          PARAM(StringRef, placement, Param)) \
+    EVENT(RewardGranted, "reward_granted", "ads", kCatalogAllProviders, \
+          PARAM(StringRef, network, Label) \
+          PARAM(StringRef, placement, Param) \
+          PARAM(StringRef, currency, Param) \
+          PARAM(int, amount, Value)) \
+    EVENT(Purchase, "purchase", "iap", kCatalogAllProviders, \
+          PARAM(StringRef, product, Label) \
+          PARAM(StringRef, price, Param) \
+          PARAM(int, cents, Value) \
+          PARAM(double, revenue, Revenue)) \
+    EVENT(Login, "login", "", kCatalogTune, ) \
+    EVENT(FlurryTest, "test event2", "", kCatalogFlurry, \
+          PARAM(StringRef, eKey1, Param) \
+          PARAM(StringRef, eKey2, Param))
+
+static const uint32_t kCatalogFlurry = 1u << (int)SdkPlugin::FlurryAnalytics;
+static const uint32_t kCatalogGoogleAnalytics = 1u << (int)SdkPlugin::GoogleAnalytics;
+static const uint32_t kCatalogKochava = 1u << (int)SdkPlugin::Kochava;
+static const uint32_t kCatalogTune = 1u << (int)SdkPlugin::Tune;
+static const uint32_t kCatalogAllProviders = kCatalogFlurry | kCatalogGoogleAnalytics | kCatalogKochava | kCatalogTune;
+
+enum class CatalogType : uint8_t
+{
+    Int,
+    Double,
+    Bool,
+    String
+};
+
+enum class CatalogUse : uint8_t
+{
+    Param,
+    Label,
+    Value,
+    Revenue,
+    Currency
+};
+
+template <typename T> struct CatalogTypeOf;
+template <> struct CatalogTypeOf<int> { static const CatalogType value = CatalogType::Int; };
+template <> struct CatalogTypeOf<double> { static const CatalogType value = CatalogType::Double; };
+template <> struct CatalogTypeOf<bool> { static const CatalogType value = CatalogType::Bool; };
+template <> struct CatalogTypeOf<StringRef> { static const CatalogType value = CatalogType::String; };
+
+constexpr bool catalogAccepts(CatalogUse use, CatalogType type)
+{
+    return use == CatalogUse::Param
+        || (use == CatalogUse::Value && type == CatalogType::Int)
+        || (use == CatalogUse::Revenue && type == CatalogType::Double)
+        || ((use == CatalogUse::Label || use == CatalogUse::Currency) && type == CatalogType::String);
+}
+
+/**
+ * One parameter value, as the script bridges hand it to
+ * AnalyticsCatalog::emit(). Strings are not copied.
+ */
+struct CatalogValue
+{
+    CatalogValue() : type(CatalogType::Int), i(0) {}
+    CatalogValue(int value) : type(CatalogType::Int), i(value) {}
+    CatalogValue(double value) : type(CatalogType::Double), d(value) {}
+    CatalogValue(bool value) : type(CatalogType::Bool), b(value) {}
+    CatalogValue(StringRef value) : type(CatalogType::String), i(0), s(value) {}
+
+    CatalogType type;
+    union
+    {
+        int i;
+        double d;
+        bool b;
+    };
+    StringRef s;
+};
+
+struct CatalogParamSpec
+{
+    const char* key;
+    uint32_t keyLength;
+    CatalogType type;
+    CatalogUse use;
+};
+
+struct CatalogEventSpec
+{
+    const char* id;
+    const char* name;
+    const char* category;
+    uint32_t providers;
+    const CatalogParamSpec* params;
+    uint32_t paramCount;
+};
+
+#define SDKBOX_CATALOG_NO_PARAM(type, key, use)
+#define SDKBOX_CATALOG_ID(id, name, category, providers, params) k##id,
+#define SDKBOX_CATALOG_FIELD(type, key, use) \
+    type key; \
+    static_assert(catalogAccepts(CatalogUse::use, CatalogTypeOf<type>::value), #key ": type does not fit CatalogUse::" #use);
+#define SDKBOX_CATALOG_STRUCT(id, name, category, providers, params) \
+    struct id \
+    { \
+        params \
+    };
+#define SDKBOX_CATALOG_VALUE(type, key, use) CatalogValue(e.key),
+#define SDKBOX_CATALOG_EMIT(id, name, category, providers, params) \
+    static int emit(const id& e) \
+    { \
+        (void)e; \
+        const CatalogValue values[] = { params CatalogValue() }; \
+        static_assert(sizeof(values) / sizeof(values[0]) - 1 <= kMaxParams, #id " has too many params"); \
+        return emit(k##id, values, sizeof(values) / sizeof(values[0]) - 1); \
+    }
+
+/**
+ * Sends catalog events through AnalyticsRouter:
+ *
+ *   AnalyticsCatalog::emit(AnalyticsCatalog::AdShown{ "AdColony", "video" });
+ *
+ * Names, categories and keys are literals from the catalog and the
+ * parameters are a fixed-size array on the stack, so an emit builds no map
+ * and allocates nothing per key: numbers are formatted on the stack and
+ * the event's params get one arena sized exactly. Which providers accept
+ * an event is looked up in the router's rules on every emit, as for
+ * AnalyticsRouter::track(); they are loaded at launch for every starter kit
+ * type, see MyPluginsMgr::startAnalytics().
+ *
+ * Returns the number of providers the event was queued for. Any thread.
+ */
+class AnalyticsCatalog
+{
+public:
+    // params of one event, so they stay in EventParams' inline entries
+    static const size_t kMaxParams = EventParams::kInlineEntries;
+
+    enum EventId
+    {
+        SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_ID, SDKBOX_CATALOG_NO_PARAM)
+        kEventCount
+    };
+
+    SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_STRUCT, SDKBOX_CATALOG_FIELD)
+
+    SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_EMIT, SDKBOX_CATALOG_VALUE)
+
+    // for the script bridges: count values in the order of getSpec().params,
+    // of the types given there; anything else is logged and not sent
+    static int emit(EventId id, const CatalogValue* values, size_t count);
+
+    static const CatalogEventSpec& getSpec(EventId id);
+};
+
+#undef SDKBOX_CATALOG_ID
+#undef SDKBOX_CATALOG_FIELD
+#undef SDKBOX_CATALOG_STRUCT
+#undef SDKBOX_CATALOG_VALUE
+#undef SDKBOX_CATALOG_EMIT
+
+#endif /* defined(__template__AnalyticsCatalog__) */
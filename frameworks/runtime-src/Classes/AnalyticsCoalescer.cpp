@@ -0,0 +1,320 @@
+//
+//  AnalyticsCoalescer.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsCoalescer.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+// Flurry drops params past this many, see Metrics.cpp
+static const size_t kMaxFlurryParams = 10;
+// the group size on a Flurry summary; an event that sets it itself is not
+// coalesced, see accepts()
+static const char* const kCountKey = "_count";
+
+// FNV-1a, 64 bit
+static const uint64_t kFnvOffset = 14695981039346656037ULL;
+static const uint64_t kFnvPrime = 1099511628211ULL;
+
+static uint64_t hashBytes(uint64_t h, const char* data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        h ^= (unsigned char)data[i];
+        h *= kFnvPrime;
+    }
+    // field separator, so ("ab", "c") and ("a", "bc") differ
+    h ^= 0xff;
+    h *= kFnvPrime;
+    return h;
+}
+
+static uint64_t hashString(uint64_t h, const std::string& s)
+{
+    return hashBytes(h, s.data(), s.size());
+}
+
+// the whole value is a finite number
+static bool parseNumber(const char* value, size_t length, double* out)
+{
+    char buf[32];
+    if (length == 0 || length >= sizeof(buf))
+    {
+        return false;
+    }
+    memcpy(buf, value, length);
+    buf[length] = '\0';
+    char* end = nullptr;
+    double d = strtod(buf, &end);
+    if (end != buf + length || !std::isfinite(d))
+    {
+        return false;
+    }
+    *out = d;
+    return true;
+}
+
+static bool isNumber(const char* value, size_t length)
+{
+    double ignored;
+    return parseNumber(value, length, &ignored);
+}
+
+// numbers only have to be numbers on both sides, their values are aggregated
+static bool sameParams(const EventParams& a, const EventParams& b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    // both sorted by key
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a.keyLengthAt(i) != b.keyLengthAt(i)
+            || memcmp(a.keyAt(i), b.keyAt(i), a.keyLengthAt(i)) != 0)
+        {
+            return false;
+        }
+        bool aNumber = isNumber(a.valueAt(i), a.valueLengthAt(i));
+        if (aNumber != isNumber(b.valueAt(i), b.valueLengthAt(i)))
+        {
+            return false;
+        }
+        if (!aNumber && (a.valueLengthAt(i) != b.valueLengthAt(i)
+            || memcmp(a.valueAt(i), b.valueAt(i), a.valueLengthAt(i)) != 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+AnalyticsCoalescer::AnalyticsCoalescer()
+: _window(0)
+, _maxGroups(0)
+, _providerMask(0)
+, _capacity(0)
+, _coalesced(0)
+{
+}
+
+void AnalyticsCoalescer::configure(int windowMs, size_t slots, uint32_t providerMask)
+{
+    _window = std::chrono::milliseconds(std::max(0, windowMs));
+    _providerMask = providerMask;
+    _used.clear();
+    if (windowMs <= 0 || slots == 0 || providerMask == 0)
+    {
+        _capacity = 0;
+        _maxGroups = 0;
+        _slots.reset();
+        return;
+    }
+
+    // at most half full, so probe chains stay short
+    size_t capacity = 16;
+    while (capacity < slots * 2)
+    {
+        capacity *= 2;
+    }
+    _capacity = capacity;
+    _maxGroups = slots;
+    _slots.reset(new Slot[capacity]);
+    _used.reserve(slots);
+}
+
+bool AnalyticsCoalescer::accepts(const AnalyticsEvent& event) const
+{
+    if (!(_providerMask & (1u << (int)event.provider())))
+    {
+        return false;
+    }
+    switch (event.type)
+    {
+        case AnalyticsEvent::kGALogEvent:
+        case AnalyticsEvent::kKochavaTrackEvent:
+            return true;
+        case AnalyticsEvent::kFlurryLogEvent:
+            // a timed event has to reach Flurry to start its clock. The
+            // summary adds the count, so a full event or one that already
+            // uses the count key is sent as is
+            return !event.timed && event.paramsJson.empty()
+                && event.params.size() < kMaxFlurryParams
+                && !event.params.get(kCountKey);
+        default:
+            return false;
+    }
+}
+
+uint64_t AnalyticsCoalescer::hashOf(const AnalyticsEvent& event)
+{
+    uint64_t h = kFnvOffset;
+    h ^= (uint64_t)event.type;
+    h *= kFnvPrime;
+    h = hashString(h, event.nameString());
+    h = hashString(h, event.actionString());
+    h = hashString(h, event.labelString());
+    for (size_t i = 0; i < event.params.size(); i++)
+    {
+        h = hashBytes(h, event.params.keyAt(i), event.params.keyLengthAt(i));
+        const char* value = event.params.valueAt(i);
+        size_t length = event.params.valueLengthAt(i);
+        if (!isNumber(value, length))
+        {
+            h = hashBytes(h, value, length);
+        }
+    }
+    return h;
+}
+
+bool AnalyticsCoalescer::sameEvent(const AnalyticsEvent& a, const AnalyticsEvent& b)
+{
+    return a.type == b.type
+        && a.nameString() == b.nameString()
+        && a.actionString() == b.actionString()
+        && a.labelString() == b.labelString()
+        && sameParams(a.params, b.params);
+}
+
+bool AnalyticsCoalescer::add(AnalyticsEvent& event, Clock::time_point now)
+{
+    if (_capacity == 0 || !accepts(event))
+    {
+        return false;
+    }
+
+    uint64_t h = hashOf(event);
+    size_t mask = _capacity - 1;
+    for (size_t i = (size_t)h & mask; ; i = (i + 1) & mask)
+    {
+        Slot& slot = _slots[i];
+        if (!slot.used)
+        {
+            if (_used.size() >= _maxGroups)
+            {
+                // full for this window, send it as is
+                return false;
+            }
+            if (_used.empty())
+            {
+                _windowStart = now;
+            }
+            slot.used = true;
+            slot.hash = h;
+            slot.count = 1;
+            slot.sum = event.value;
+            addNumbers(slot, event.params);
+            slot.event = std::move(event);
+            _used.push_back((uint32_t)i);
+            return true;
+        }
+        if (slot.hash == h && sameEvent(slot.event, event))
+        {
+            slot.count++;
+            slot.sum += event.value;
+            addNumbers(slot, event.params);
+            if (event.journalPos != AnalyticsJournal::kInvalidPos)
+            {
+                slot.absorbed.push_back(event.journalPos);
+            }
+            _coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+void AnalyticsCoalescer::addNumbers(Slot& slot, const EventParams& params)
+{
+    bool first = slot.count == 1;
+    size_t next = 0;
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        double d;
+        if (!parseNumber(params.valueAt(i), params.valueLengthAt(i), &d))
+        {
+            continue;
+        }
+        if (first)
+        {
+            slot.numbers.push_back(Number{ i, d, d, d });
+            continue;
+        }
+        // same keys in the same order as the first event of the group
+        Number& n = slot.numbers[next++];
+        n.sum += d;
+        n.min = std::min(n.min, d);
+        n.max = std::max(n.max, d);
+    }
+}
+
+bool AnalyticsCoalescer::isDue(Clock::time_point now) const
+{
+    return !_used.empty() && now - _windowStart >= _window;
+}
+
+void AnalyticsCoalescer::summarize(Slot& slot)
+{
+    if (slot.count == 1)
+    {
+        return;
+    }
+
+    AnalyticsEvent& e = slot.event;
+    char count[16];
+    snprintf(count, sizeof(count), "%u", slot.count);
+    switch (e.type)
+    {
+        case AnalyticsEvent::kGALogEvent:
+            e.value = (int)std::min<int64_t>(std::max<int64_t>(slot.sum, INT_MIN), INT_MAX);
+            break;
+        case AnalyticsEvent::kFlurryLogEvent:
+        {
+            // min and max only while the summary stays within Flurry's
+            // limit and does not overwrite a param of the caller's
+            bool range = e.params.size() + 1 + slot.numbers.size() * 2 <= kMaxFlurryParams;
+            // keys and values are copied out first, set() may move the params
+            std::vector<std::pair<std::string, std::string>> numbers;
+            numbers.reserve(slot.numbers.size() * 3);
+            for (const Number& n : slot.numbers)
+            {
+                std::string key(e.params.keyAt(n.index), e.params.keyLengthAt(n.index));
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%.15g", n.sum);
+                numbers.push_back(std::make_pair(key, std::string(buf)));
+                snprintf(buf, sizeof(buf), "%.15g", n.min);
+                numbers.push_back(std::make_pair(key + "_min", std::string(buf)));
+                snprintf(buf, sizeof(buf), "%.15g", n.max);
+                numbers.push_back(std::make_pair(key + "_max", std::string(buf)));
+                range = range && !e.params.get(key + "_min") && !e.params.get(key + "_max");
+            }
+            for (size_t i = 0; i < numbers.size(); i++)
+            {
+                // sum, min, max per number
+                if (i % 3 == 0 || range)
+                {
+                    e.params.set(numbers[i].first, numbers[i].second);
+                }
+            }
+            e.params.set(kCountKey, count);
+            break;
+        }
+        case AnalyticsEvent::kKochavaTrackEvent:
+        {
+            EventParams value;
+            value.set(std::string("value"), e.action);
+            value.set("count", count);
+            e.action = value.toJson();
+            break;
+        }
+        default:
+            break;
+    }
+}
@@ -0,0 +1,138 @@
+//
+//  AnalyticsCoalescer.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsCoalescer__
+#define __template__AnalyticsCoalescer__
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "AnalyticsEvent.h"
+
+/**
+ * Folds repeats of the same event inside a time window into one summary,
+ * the "coalesce" block of the "analytics" section of sdkbox_config.json:
+ *
+ *   "coalesce": {
+ *       "windowMs": 5000,
+ *       "slots": 256,
+ *       "providers": ["GoogleAnalytics", "FlurryAnalytics"]
+ *   }
+ *
+ * Two events are the same when every field except their numbers matches:
+ * GA category/action/label, the Kochava name and value, or a Flurry event
+ * name and params (non-timed, map params only, fewer than Flurry's 10 and
+ * no "_count" key) where a param whose value is a number may differ. At the
+ * end of the window each group is sent once; a group of one goes out
+ * unchanged, and larger ones carry the aggregate:
+ *
+ *   GA       value is the sum of the values, so totals stay right; its
+ *            logEvent has no field for the count, min or max
+ *   Flurry   params gain "_count"; each numeric param becomes the sum, and
+ *            gains "<key>_min" and "<key>_max" when all of those fit in 10
+ *            params without replacing one of the caller's
+ *   Kochava  the value becomes {"value": "<original>", "count": "<n>"}.
+ *            That changes what the Kochava dashboard receives, so Kochava
+ *            is opt-in: list it under "providers" only if the reports are
+ *            built to read that format
+ *
+ * Held events are sent later than events that are not coalesced, so
+ * coalescing trades per-event ordering and up to windowMs of latency for
+ * fewer SDK calls. The pipeline flushes the table before a session end or
+ * a screen change, so a summary never lands after either.
+ *
+ * Lookups use an open-addressing table sized to twice "slots"; once a
+ * window holds "slots" distinct events, new ones pass straight through.
+ * AnalyticsPipeline owns one and only uses it on its worker thread.
+ */
+class AnalyticsCoalescer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    AnalyticsCoalescer();
+
+    // before the worker starts; 0 slots or no providers turns it off
+    void configure(int windowMs, size_t slots, uint32_t providerMask);
+    bool isEnabled() const { return _capacity > 0; }
+
+    // true when the event was absorbed and must not be delivered now.
+    // The event is moved from in that case.
+    bool add(AnalyticsEvent& event, Clock::time_point now);
+
+    // the window opened by the first held event has elapsed
+    bool isDue(Clock::time_point now) const;
+
+    // hands every group to emit(summary, absorbed) and empties the table;
+    // absorbed are the journal positions of the folded repeats, to be
+    // marked done once the summary is delivered
+    template <typename Emit>
+    void flush(Emit emit)
+    {
+        for (uint32_t index : _used)
+        {
+            Slot& slot = _slots[index];
+            summarize(slot);
+            emit(slot.event, slot.absorbed);
+            // keeps the vector's buffer for the next window
+            slot.absorbed.clear();
+            slot.numbers.clear();
+            slot.event = AnalyticsEvent();
+            slot.used = false;
+        }
+        _used.clear();
+    }
+
+    size_t size() const { return _used.size(); }
+    // events folded into another since startup, any thread
+    uint64_t getCoalescedCount() const { return _coalesced.load(std::memory_order_relaxed); }
+
+private:
+    // a numeric Flurry param, by its position in the sorted params
+    struct Number
+    {
+        size_t index;
+        double sum;
+        double min;
+        double max;
+    };
+
+    struct Slot
+    {
+        Slot() : used(false), hash(0), count(0), sum(0) {}
+
+        bool used;
+        uint64_t hash;
+        AnalyticsEvent event;
+        uint32_t count;
+        // of the GA value
+        int64_t sum;
+        std::vector<Number> numbers;
+        std::vector<uint64_t> absorbed;
+    };
+
+    bool accepts(const AnalyticsEvent& event) const;
+    static void addNumbers(Slot& slot, const EventParams& params);
+    static uint64_t hashOf(const AnalyticsEvent& event);
+    static bool sameEvent(const AnalyticsEvent& a, const AnalyticsEvent& b);
+    static void summarize(Slot& slot);
+
+    std::chrono::milliseconds _window;
+    size_t _maxGroups;
+    uint32_t _providerMask;
+
+    // power of two, 0 when disabled
+    size_t _capacity;
+    std::unique_ptr<Slot[]> _slots;
+    std::vector<uint32_t> _used;
+    Clock::time_point _windowStart;
+    std::atomic<uint64_t> _coalesced;
+};
+
+#endif /* defined(__template__AnalyticsCoalescer__) */
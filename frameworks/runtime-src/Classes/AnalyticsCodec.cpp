@@ -0,0 +1,823 @@
+//
+//  AnalyticsCodec.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsCodec.h"
+
+#include <string.h>
+#include <atomic>
+
+// Append only: journals written by an older build index into this list.
+static const char* const kDictionary[] = {
+    // event names
+    "ad_shown", "reward_granted", "purchase", "login", "session", "metrics",
+    "frame_time", "scene_load", "KochavaCustomEvent", "Startup", "plugin init",
+    "janky", "build", "present", "total",
+    // categories, actions and labels
+    "ads", "iap", "game", "ui", "HelloWorld", "Scene",
+    "AdColony", "Chartboost", "FlurryAnalytics", "GoogleAnalytics", "IAP",
+    "Kochava", "Tune", "Vungle", "video", "v4vc", "reward",
+    // param keys
+    "network", "placement", "currency", "product", "price", "count", "value",
+    "scene", "from", "frames", "p50", "p90", "p95", "p99", "max",
+    "build_ms", "present_ms", "total_ms", "cancelled",
+    // common values
+    "true", "false", "USD", "remove_ads",
+};
+
+static const uint32_t kDictionarySize = sizeof(kDictionary) / sizeof(kDictionary[0]);
+
+// learned entries are numbered from here, so the built-in list can grow
+static const uint64_t kLearnedBase = 1024;
+
+// shorter literals take no more room than an index; longer ones are values
+// more than names
+static const size_t kMinLearnedLength = 3;
+static const size_t kMaxLearnedLength = 64;
+
+// learned storage: a 32-bit count of bytes used, then per entry a length
+// byte and the string
+static const uint32_t kLearnedHeaderSize = 4;
+
+
+// the longest decimal kept as a number, so the mantissa fits in 57 bits
+static const size_t kMaxNumberDigits = 17;
+
+enum
+{
+    kHeaderMarker = 0x80,
+    kHeaderTimed = 0x10,
+    kHeaderJson = 0x20,
+    kHeaderTune = 0x40,
+    kHeaderTypeMask = 0x0f
+};
+
+enum ValueKind
+{
+    kValueLiteral,
+    kValueIndex,
+    kValueInteger,
+    kValueDecimal
+};
+
+static uint32_t hashString(const char* data, size_t length)
+{
+    return StringInterner::hash(StringRef(data, length));
+}
+
+// built-in strings by hash, open addressing; holds index + 1, 0 is free
+static const uint32_t kDictionarySlots = 256;
+
+struct DictionaryTable
+{
+    uint32_t hashes[kDictionarySlots];
+    uint16_t lengths[kDictionarySlots];
+    uint16_t slots[kDictionarySlots];
+
+    DictionaryTable()
+    {
+        static_assert(kDictionarySize * 2 <= kDictionarySlots, "dictionary table too small");
+        static_assert(kDictionarySize <= kLearnedBase, "built-in dictionary overlaps learned entries");
+        memset(slots, 0, sizeof(slots));
+        for (uint32_t i = 0; i < kDictionarySize; i++)
+        {
+            size_t length = strlen(kDictionary[i]);
+            uint32_t h = hashString(kDictionary[i], length);
+            uint32_t s = h & (kDictionarySlots - 1);
+            while (slots[s])
+            {
+                s = (s + 1) & (kDictionarySlots - 1);
+            }
+            hashes[s] = h;
+            lengths[s] = (uint16_t)length;
+            slots[s] = (uint16_t)(i + 1);
+        }
+    }
+
+    int64_t find(uint32_t h, const char* data, size_t length) const
+    {
+        for (uint32_t s = h & (kDictionarySlots - 1); slots[s]; s = (s + 1) & (kDictionarySlots - 1))
+        {
+            if (hashes[s] == h && lengths[s] == length && memcmp(kDictionary[slots[s] - 1], data, length) == 0)
+            {
+                return slots[s] - 1;
+            }
+        }
+        return -1;
+    }
+};
+
+static const DictionaryTable& dictionary()
+{
+    static const DictionaryTable table;
+    return table;
+}
+
+static std::atomic<uint32_t>& learnedBytes(char* storage)
+{
+    return *reinterpret_cast<std::atomic<uint32_t>*>(storage);
+}
+
+AnalyticsCodec::Dictionary::Dictionary()
+: _storage(nullptr)
+, _capacity(0)
+, _count(0)
+{
+    memset(_slots, 0, sizeof(_slots));
+}
+
+void AnalyticsCodec::Dictionary::attach(char* storage, uint32_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _storage = capacity > kLearnedHeaderSize ? storage : nullptr;
+    _capacity = capacity;
+    _count = 0;
+    memset(_slots, 0, sizeof(_slots));
+    if (!_storage)
+    {
+        return;
+    }
+
+    uint32_t used = learnedBytes(_storage).load(std::memory_order_acquire);
+    uint32_t offset = kLearnedHeaderSize;
+    while (offset < used && used <= _capacity && _count < kMaxEntries)
+    {
+        uint32_t length = (uint8_t)_storage[offset];
+        if (length == 0 || offset + 1 + length > used)
+        {
+            break;
+        }
+        index(offset);
+        offset += 1 + length;
+    }
+    // a damaged tail is dropped, records that used it fail to decode
+    learnedBytes(_storage).store(offset, std::memory_order_release);
+}
+
+void AnalyticsCodec::Dictionary::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _count = 0;
+    memset(_slots, 0, sizeof(_slots));
+    if (_storage)
+    {
+        learnedBytes(_storage).store(kLearnedHeaderSize, std::memory_order_release);
+    }
+}
+
+void AnalyticsCodec::Dictionary::index(uint32_t offset)
+{
+    uint32_t h = hashString(_storage + offset + 1, (uint8_t)_storage[offset]);
+    uint32_t s = h & (kSlots - 1);
+    while (_slots[s])
+    {
+        s = (s + 1) & (kSlots - 1);
+    }
+    _hashes[s] = h;
+    _slots[s] = (uint16_t)(_count + 1);
+    _offsets[_count++] = offset;
+}
+
+int64_t AnalyticsCodec::Dictionary::find(const char* data, size_t length, bool learn)
+{
+    static_assert(kMaxEntries * 2 <= kSlots, "learned table too small");
+
+    uint32_t h = hashString(data, length);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_storage)
+    {
+        return -1;
+    }
+    for (uint32_t s = h & (kSlots - 1); _slots[s]; s = (s + 1) & (kSlots - 1))
+    {
+        const char* entry = _storage + _offsets[_slots[s] - 1];
+        if (_hashes[s] == h && (uint8_t)*entry == length && memcmp(entry + 1, data, length) == 0)
+        {
+            return _slots[s] - 1;
+        }
+    }
+
+    uint32_t used = learnedBytes(_storage).load(std::memory_order_relaxed);
+    if (!learn || length < kMinLearnedLength || length > kMaxLearnedLength || _count == kMaxEntries
+        || used + 1 + length > _capacity)
+    {
+        return -1;
+    }
+    _storage[used] = (char)length;
+    memcpy(_storage + used + 1, data, length);
+    index(used);
+    // the entry is in place before a record can refer to it
+    learnedBytes(_storage).store(used + 1 + (uint32_t)length, std::memory_order_release);
+    return _count - 1;
+}
+
+bool AnalyticsCodec::Dictionary::entry(uint64_t index, std::string& s)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (index >= _count)
+    {
+        return false;
+    }
+    const char* entry = _storage + _offsets[index];
+    s.assign(entry + 1, (uint8_t)*entry);
+    return true;
+}
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static void putVarint(std::string& out, uint64_t v)
+{
+    char buf[10];
+    int n = 0;
+    while (v >= 0x80)
+    {
+        buf[n++] = (char)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (char)v;
+    out.append(buf, n);
+}
+
+static void putFloat(std::string& out, float f)
+{
+    out.append(reinterpret_cast<const char*>(&f), sizeof(f));
+}
+
+static bool isSet(float f)
+{
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits != 0;
+}
+
+struct Reader
+{
+    const char*& p;
+    const char* end;
+
+    bool varint(uint64_t& v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7)
+        {
+            uint8_t b = (uint8_t)*p++;
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool signedVarint(int64_t& v)
+    {
+        uint64_t u = 0;
+        if (!varint(u))
+        {
+            return false;
+        }
+        v = unzigzag(u);
+        return true;
+    }
+
+    bool bytes(const char*& data, uint64_t length)
+    {
+        if ((uint64_t)(end - p) < length)
+        {
+            return false;
+        }
+        data = p;
+        p += length;
+        return true;
+    }
+
+    bool float32(float& f)
+    {
+        const char* data = nullptr;
+        if (!bytes(data, sizeof(f)))
+        {
+            return false;
+        }
+        memcpy(&f, data, sizeof(f));
+        return true;
+    }
+};
+
+// "-12", "0", "16.70": no sign on zero, no leading zeros, digits after a dot
+static bool parseNumber(const char* s, size_t length, int64_t& mantissa, uint8_t& scale)
+{
+    size_t i = 0;
+    bool negative = false;
+    if (i < length && s[i] == '-')
+    {
+        negative = true;
+        i++;
+    }
+    size_t intStart = i;
+    while (i < length && s[i] >= '0' && s[i] <= '9')
+    {
+        i++;
+    }
+    size_t intDigits = i - intStart;
+    if (intDigits == 0 || (intDigits > 1 && s[intStart] == '0'))
+    {
+        return false;
+    }
+    size_t fracDigits = 0;
+    if (i < length && s[i] == '.')
+    {
+        i++;
+        size_t fracStart = i;
+        while (i < length && s[i] >= '0' && s[i] <= '9')
+        {
+            i++;
+        }
+        fracDigits = i - fracStart;
+        if (fracDigits == 0)
+        {
+            return false;
+        }
+    }
+    if (i != length || intDigits + fracDigits > kMaxNumberDigits)
+    {
+        return false;
+    }
+
+    int64_t m = 0;
+    for (size_t j = intStart; j < length; j++)
+    {
+        if (s[j] != '.')
+        {
+            m = m * 10 + (s[j] - '0');
+        }
+    }
+    // "-0" and "-0.0" would come back without the sign
+    if (negative && m == 0)
+    {
+        return false;
+    }
+    mantissa = negative ? -m : m;
+    scale = (uint8_t)fracDigits;
+    return true;
+}
+
+static void formatNumber(int64_t mantissa, uint8_t scale, std::string& out)
+{
+    char digits[24];
+    uint64_t m = mantissa < 0 ? (uint64_t)-mantissa : (uint64_t)mantissa;
+    int n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + m % 10);
+        m /= 10;
+    } while (m > 0);
+    // "0.05": the integer part and leading fraction zeros are not in m
+    while (n <= scale)
+    {
+        digits[n++] = '0';
+    }
+
+    out.clear();
+    if (mantissa < 0)
+    {
+        out.push_back('-');
+    }
+    for (int i = n - 1; i >= 0; i--)
+    {
+        out.push_back(digits[i]);
+        if (i == scale && scale > 0)
+        {
+            out.push_back('.');
+        }
+    }
+}
+
+namespace
+{
+    struct Writer
+    {
+        std::string& out;
+        AnalyticsCodec::Dictionary* learned;
+
+        int64_t find(const char* data, size_t length, bool learn)
+        {
+            int64_t i = dictionary().find(hashString(data, length), data, length);
+            if (i < 0 && learned)
+            {
+                i = learned->find(data, length, learn);
+                i = i >= 0 ? (int64_t)kLearnedBase + i : -1;
+            }
+            return i;
+        }
+
+        // names and keys are learned, other strings only looked up
+        void string(const char* data, size_t length, bool learn = false)
+        {
+            if (length == 0)
+            {
+                putVarint(out, 0);
+                return;
+            }
+            int64_t i = find(data, length, learn);
+            if (i >= 0)
+            {
+                putVarint(out, ((uint64_t)i << 1) | 1);
+                return;
+            }
+            putVarint(out, (uint64_t)length << 1);
+            out.append(data, length);
+        }
+
+        void string(const std::string& s, bool learn = false)
+        {
+            string(s.data(), s.size(), learn);
+        }
+
+        void value(const char* data, size_t length)
+        {
+            int64_t mantissa = 0;
+            uint8_t scale = 0;
+            if (length > 0 && parseNumber(data, length, mantissa, scale))
+            {
+                if (scale == 0)
+                {
+                    putVarint(out, (zigzag(mantissa) << 2) | kValueInteger);
+                }
+                else
+                {
+                    putVarint(out, (zigzag(mantissa) << 2) | kValueDecimal);
+                    out.push_back((char)scale);
+                }
+                return;
+            }
+            int64_t i = length > 0 ? find(data, length, false) : -1;
+            if (i >= 0)
+            {
+                putVarint(out, ((uint64_t)i << 2) | kValueIndex);
+                return;
+            }
+            putVarint(out, ((uint64_t)length << 2) | kValueLiteral);
+            out.append(data, length);
+        }
+    };
+
+    struct Parser
+    {
+        Reader in;
+        AnalyticsCodec::Dictionary* learned;
+
+        bool entry(uint64_t i, std::string& s)
+        {
+            if (i >= kLearnedBase)
+            {
+                return learned && learned->entry(i - kLearnedBase, s);
+            }
+            if (i >= kDictionarySize)
+            {
+                return false;
+            }
+            s = kDictionary[i];
+            return true;
+        }
+
+        bool literal(uint64_t length, std::string& s)
+        {
+            const char* data = nullptr;
+            if (!in.bytes(data, length))
+            {
+                return false;
+            }
+            s.assign(data, length);
+            return true;
+        }
+
+        bool string(std::string& s)
+        {
+            uint64_t v = 0;
+            if (!in.varint(v))
+            {
+                return false;
+            }
+            if (v & 1)
+            {
+                return entry(v >> 1, s);
+            }
+            return literal(v >> 1, s);
+        }
+
+        bool value(std::string& s)
+        {
+            uint64_t v = 0;
+            if (!in.varint(v))
+            {
+                return false;
+            }
+            switch (v & 3)
+            {
+                case kValueLiteral:
+                    return literal(v >> 2, s);
+                case kValueIndex:
+                    return entry(v >> 2, s);
+                case kValueInteger:
+                    formatNumber(unzigzag(v >> 2), 0, s);
+                    return true;
+                default:
+                {
+                    const char* scale = nullptr;
+                    if (!in.bytes(scale, 1) || (uint8_t)*scale > kMaxNumberDigits)
+                    {
+                        return false;
+                    }
+                    formatNumber(unzigzag(v >> 2), (uint8_t)*scale, s);
+                    return true;
+                }
+            }
+        }
+    };
+}
+
+// field order of the Tune bitmasks; append only
+enum TuneField
+{
+    kTuneEventName, kTuneEventId, kTuneItems, kTuneRevenue, kTuneCurrencyCode, kTuneRefId,
+    kTuneReceipt, kTuneReceiptSignature, kTuneContentType, kTuneContentId, kTuneSearchString,
+    kTuneTransactionState, kTuneRating, kTuneLevel, kTuneQuantity, kTuneDate1, kTuneDate2,
+    kTuneAttribute1
+};
+
+enum TuneItemField
+{
+    kItemName, kItemUnitPrice, kItemQuantity, kItemRevenue, kItemAttribute1
+};
+
+static void encodeTune(Writer& w, const sdkbox::TuneEvent& t)
+{
+    const std::string* attributes[] = { &t.attribute1, &t.attribute2, &t.attribute3, &t.attribute4, &t.attribute5 };
+    const std::string* strings[] = { &t.currencyCode, &t.refId, &t.receipt, &t.receiptSignature,
+                                     &t.contentType, &t.contentId, &t.searchString };
+
+    uint64_t mask = 0;
+    mask |= (uint64_t)!t.eventName.empty() << kTuneEventName;
+    mask |= (uint64_t)(t.eventId != 0) << kTuneEventId;
+    mask |= (uint64_t)!t.eventItems.empty() << kTuneItems;
+    mask |= (uint64_t)isSet(t.revenue) << kTuneRevenue;
+    for (int i = 0; i < 7; i++)
+    {
+        mask |= (uint64_t)!strings[i]->empty() << (kTuneCurrencyCode + i);
+    }
+    mask |= (uint64_t)(t.transactionState != 0) << kTuneTransactionState;
+    mask |= (uint64_t)isSet(t.rating) << kTuneRating;
+    mask |= (uint64_t)(t.level != 0) << kTuneLevel;
+    mask |= (uint64_t)(t.quantity != 0) << kTuneQuantity;
+    mask |= (uint64_t)(t.timeIntervalSince1970Date1 != 0) << kTuneDate1;
+    mask |= (uint64_t)(t.timeIntervalSince1970Date2 != 0) << kTuneDate2;
+    for (int i = 0; i < 5; i++)
+    {
+        mask |= (uint64_t)!attributes[i]->empty() << (kTuneAttribute1 + i);
+    }
+    putVarint(w.out, mask);
+
+    if (mask & (1ULL << kTuneEventName)) w.string(t.eventName, true);
+    if (mask & (1ULL << kTuneEventId)) putVarint(w.out, zigzag(t.eventId));
+    if (mask & (1ULL << kTuneItems))
+    {
+        putVarint(w.out, t.eventItems.size());
+        for (const sdkbox::TuneEventItem& item : t.eventItems)
+        {
+            const std::string* itemAttributes[] = { &item.attribute1, &item.attribute2, &item.attribute3,
+                                                    &item.attribute4, &item.attribute5 };
+            uint64_t itemMask = 0;
+            itemMask |= (uint64_t)!item.item.empty() << kItemName;
+            itemMask |= (uint64_t)isSet(item.unitPrice) << kItemUnitPrice;
+            itemMask |= (uint64_t)(item.quantity != 0) << kItemQuantity;
+            itemMask |= (uint64_t)isSet(item.revenue) << kItemRevenue;
+            for (int i = 0; i < 5; i++)
+            {
+                itemMask |= (uint64_t)!itemAttributes[i]->empty() << (kItemAttribute1 + i);
+            }
+            putVarint(w.out, itemMask);
+
+            if (itemMask & (1ULL << kItemName)) w.string(item.item);
+            if (itemMask & (1ULL << kItemUnitPrice)) putFloat(w.out, item.unitPrice);
+            if (itemMask & (1ULL << kItemQuantity)) putVarint(w.out, zigzag(item.quantity));
+            if (itemMask & (1ULL << kItemRevenue)) putFloat(w.out, item.revenue);
+            for (int i = 0; i < 5; i++)
+            {
+                if (itemMask & (1ULL << (kItemAttribute1 + i))) w.string(*itemAttributes[i]);
+            }
+        }
+    }
+    if (mask & (1ULL << kTuneRevenue)) putFloat(w.out, t.revenue);
+    for (int i = 0; i < 7; i++)
+    {
+        if (mask & (1ULL << (kTuneCurrencyCode + i))) w.string(*strings[i]);
+    }
+    if (mask & (1ULL << kTuneTransactionState)) putVarint(w.out, zigzag(t.transactionState));
+    if (mask & (1ULL << kTuneRating)) putFloat(w.out, t.rating);
+    if (mask & (1ULL << kTuneLevel)) putVarint(w.out, zigzag(t.level));
+    if (mask & (1ULL << kTuneQuantity)) putVarint(w.out, t.quantity);
+    if (mask & (1ULL << kTuneDate1)) putVarint(w.out, t.timeIntervalSince1970Date1);
+    if (mask & (1ULL << kTuneDate2)) putVarint(w.out, t.timeIntervalSince1970Date2);
+    for (int i = 0; i < 5; i++)
+    {
+        if (mask & (1ULL << (kTuneAttribute1 + i))) w.string(*attributes[i]);
+    }
+}
+
+static bool decodeTune(Parser& r, sdkbox::TuneEvent& t)
+{
+    std::string* attributes[] = { &t.attribute1, &t.attribute2, &t.attribute3, &t.attribute4, &t.attribute5 };
+    std::string* strings[] = { &t.currencyCode, &t.refId, &t.receipt, &t.receiptSignature,
+                               &t.contentType, &t.contentId, &t.searchString };
+    uint64_t mask = 0;
+    int64_t n = 0;
+    uint64_t u = 0;
+    if (!r.in.varint(mask))
+    {
+        return false;
+    }
+
+    if ((mask & (1ULL << kTuneEventName)) && !r.string(t.eventName)) return false;
+    if (mask & (1ULL << kTuneEventId))
+    {
+        if (!r.in.signedVarint(n)) return false;
+        t.eventId = (long)n;
+    }
+    if (mask & (1ULL << kTuneItems))
+    {
+        uint64_t count = 0;
+        // each item takes at least its mask byte
+        if (!r.in.varint(count) || count > (uint64_t)(r.in.end - r.in.p)) return false;
+        t.eventItems.resize((size_t)count);
+        for (sdkbox::TuneEventItem& item : t.eventItems)
+        {
+            std::string* itemAttributes[] = { &item.attribute1, &item.attribute2, &item.attribute3,
+                                              &item.attribute4, &item.attribute5 };
+            uint64_t itemMask = 0;
+            if (!r.in.varint(itemMask)) return false;
+            if ((itemMask & (1ULL << kItemName)) && !r.string(item.item)) return false;
+            if ((itemMask & (1ULL << kItemUnitPrice)) && !r.in.float32(item.unitPrice)) return false;
+            if (itemMask & (1ULL << kItemQuantity))
+            {
+                if (!r.in.signedVarint(n)) return false;
+                item.quantity = (int)n;
+            }
+            if ((itemMask & (1ULL << kItemRevenue)) && !r.in.float32(item.revenue)) return false;
+            for (int i = 0; i < 5; i++)
+            {
+                if ((itemMask & (1ULL << (kItemAttribute1 + i))) && !r.string(*itemAttributes[i])) return false;
+            }
+        }
+    }
+    if ((mask & (1ULL << kTuneRevenue)) && !r.in.float32(t.revenue)) return false;
+    for (int i = 0; i < 7; i++)
+    {
+        if ((mask & (1ULL << (kTuneCurrencyCode + i))) && !r.string(*strings[i])) return false;
+    }
+    if (mask & (1ULL << kTuneTransactionState))
+    {
+        if (!r.in.signedVarint(n)) return false;
+        t.transactionState = (long)n;
+    }
+    if ((mask & (1ULL << kTuneRating)) && !r.in.float32(t.rating)) return false;
+    if (mask & (1ULL << kTuneLevel))
+    {
+        if (!r.in.signedVarint(n)) return false;
+        t.level = (long)n;
+    }
+    if (mask & (1ULL << kTuneQuantity))
+    {
+        if (!r.in.varint(u)) return false;
+        t.quantity = (unsigned long)u;
+    }
+    if (mask & (1ULL << kTuneDate1))
+    {
+        if (!r.in.varint(u)) return false;
+        t.timeIntervalSince1970Date1 = (unsigned long)u;
+    }
+    if (mask & (1ULL << kTuneDate2))
+    {
+        if (!r.in.varint(u)) return false;
+        t.timeIntervalSince1970Date2 = (unsigned long)u;
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        if ((mask & (1ULL << (kTuneAttribute1 + i))) && !r.string(*attributes[i])) return false;
+    }
+    return true;
+}
+
+void AnalyticsCodec::encode(const AnalyticsEvent& e, int64_t base, Dictionary* learned, std::string& out)
+{
+    uint8_t header = kHeaderMarker | (uint8_t)e.type;
+    header |= e.timed ? kHeaderTimed : 0;
+    header |= !e.paramsJson.empty() ? kHeaderJson : 0;
+    header |= e.tune ? kHeaderTune : 0;
+    out.push_back((char)header);
+
+    putVarint(out, zigzag(e.timestampMs - base));
+
+    Writer w = { out, learned };
+    w.string(e.nameString(), true);
+    w.string(e.actionString(), true);
+    w.string(e.labelString(), true);
+    putVarint(out, zigzag(e.value));
+
+    if (!e.paramsJson.empty())
+    {
+        putVarint(out, e.paramsJson.size());
+        out.append(e.paramsJson);
+    }
+
+    putVarint(out, e.params.size());
+    for (size_t i = 0; i < e.params.size(); i++)
+    {
+        w.string(e.params.keyAt(i), e.params.keyLengthAt(i), true);
+        w.value(e.params.valueAt(i), e.params.valueLengthAt(i));
+    }
+
+    if (e.tune)
+    {
+        encodeTune(w, *e.tune);
+    }
+}
+
+bool AnalyticsCodec::decode(const char* data, size_t length, int64_t base, Dictionary* learned, AnalyticsEvent& e)
+{
+    const char* p = data;
+    const char* end = data + length;
+    Parser r = { Reader{ p, end }, learned };
+
+    const char* headerByte = nullptr;
+    if (!r.in.bytes(headerByte, 1))
+    {
+        return false;
+    }
+    uint8_t header = (uint8_t)*headerByte;
+    uint8_t type = header & kHeaderTypeMask;
+    if (!(header & kHeaderMarker) || type == AnalyticsEvent::kNone || type > AnalyticsEvent::kTuneMeasureSession)
+    {
+        return false;
+    }
+    e.type = (AnalyticsEvent::Type)type;
+    e.timed = (header & kHeaderTimed) != 0;
+
+    int64_t timestamp = 0;
+    int64_t value = 0;
+    if (!r.in.signedVarint(timestamp) || !r.string(e.name) || !r.string(e.action) || !r.string(e.label)
+        || !r.in.signedVarint(value))
+    {
+        return false;
+    }
+    e.timestampMs = base + timestamp;
+    e.value = (int)value;
+
+    if (header & kHeaderJson)
+    {
+        uint64_t length = 0;
+        const char* data = nullptr;
+        if (!r.in.varint(length) || !r.in.bytes(data, length))
+        {
+            return false;
+        }
+        e.paramsJson.assign(data, length);
+    }
+
+    uint64_t count = 0;
+    if (!r.in.varint(count) || count > (uint64_t)(end - p))
+    {
+        return false;
+    }
+    std::string key;
+    std::string val;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        if (!r.string(key) || !r.value(val))
+        {
+            return false;
+        }
+        e.params.set(key, val);
+    }
+
+    if (header & kHeaderTune)
+    {
+        e.tune.reset(new sdkbox::TuneEvent());
+        if (!decodeTune(r, *e.tune))
+        {
+            return false;
+        }
+    }
+    return p == end;
+}
@@ -0,0 +1,100 @@
+//
+//  AnalyticsEvent.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsEvent__
+#define __template__AnalyticsEvent__
+
+#include <stdint.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include "AnalyticsJournal.h"
+#include "EventParams.h"
+#include "PluginEventBus.h"
+#include "StringInterner.h"
+
+#include "PluginTune/PluginTune.h"
+
+/**
+ * Delivery class of an event, see AnalyticsPipeline. Critical events are
+ * never dropped; the others are subject to their class's memory budget.
+ */
+enum class AnalyticsPriority : uint8_t
+{
+    Critical,
+    High,
+    Normal,
+    Low
+};
+
+const char* analyticsPriorityName(AnalyticsPriority priority);
+
+/**
+ * One queued analytics call. Which fields are used depends on the type.
+ */
+struct AnalyticsEvent
+{
+    enum Type
+    {
+        kNone,
+        kFlurryLogEvent,        // name, params, timed
+        kFlurryEndTimedEvent,   // name, params
+        kFlurryEndSession,
+        kGALogEvent,            // name = category, action, label, value; interned
+        kGALogScreen,           // name; interned
+        kGALogTiming,           // name = category, value = interval, action = timing name, label; interned
+        kKochavaTrackEvent,     // name, action = value
+        kTuneMeasureEventName,  // name
+        kTuneMeasureEvent,      // tune, or paramsJson from the script bridges
+        kKochavaSpatialEvent,   // name = title, params x, y, z
+        kTuneMeasureEventId,    // value = event id
+        kTuneMeasureSession     // params = TunePreloadData fields, when there is any
+    };
+
+    AnalyticsEvent()
+    : type(kNone)
+    , value(0)
+    , timed(false)
+    , timestampMs(0)
+    , priority(AnalyticsPriority::Normal)
+    , queuedBytes(0)
+    , sequence(0)
+    , journalPos(AnalyticsJournal::kInvalidPos)
+    {
+    }
+
+    SdkPlugin provider() const;
+
+    // the interned handle when set, otherwise the plain field
+    const std::string& nameString() const { return internedName ? internedName.str() : name; }
+    const std::string& actionString() const { return internedAction ? internedAction.str() : action; }
+    const std::string& labelString() const { return internedLabel ? internedLabel.str() : label; }
+
+    Type type;
+    std::string name;
+    std::string action;
+    std::string label;
+    InternedString internedName;
+    InternedString internedAction;
+    InternedString internedLabel;
+    int value;
+    bool timed;
+    EventParams params;
+    std::string paramsJson;
+    std::unique_ptr<sdkbox::TuneEvent> tune;
+    std::chrono::steady_clock::time_point queuedAt;
+    // wall clock, ms since 1970; kept across restarts by the journal
+    int64_t timestampMs;
+    // set by AnalyticsPipeline::enqueue()
+    AnalyticsPriority priority;
+    uint32_t queuedBytes;
+    // enqueue order across all classes, the order of delivery
+    uint64_t sequence;
+    uint64_t journalPos;
+};
+
+#endif /* defined(__template__AnalyticsEvent__) */
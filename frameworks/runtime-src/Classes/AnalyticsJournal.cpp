@@ -0,0 +1,586 @@
+//
+//  AnalyticsJournal.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsJournal.h"
+#include "cocos2d.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <new>
+#include <thread>
+
+static const uint32_t kJournalMagic = 0x4a4e4c41; // "ALNJ"
+static const uint32_t kJournalVersion = 2;
+// no segment headers; its records hold absolute times, i.e. base 0
+static const uint32_t kJournalVersionNoBases = 1;
+
+// record header words: size, length | flags, crc, epoch
+static const uint32_t kRecordHeaderSize = 16;
+static const uint32_t kFlagDone = 0x80000000u;
+static const uint32_t kFlagSkip = 0x40000000u;
+static const uint32_t kLengthMask = 0x3fffffffu;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomic words must map onto the file layout");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic words must map onto the file layout");
+
+struct AnalyticsJournal::FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t segmentSize;
+    uint32_t segmentCount;
+    // end of the last fully written record
+    std::atomic<uint64_t> writePos;
+    // everything before this was delivered or evicted
+    std::atomic<uint64_t> readPos;
+    std::atomic<uint64_t> evicted;
+};
+
+struct AnalyticsJournal::SegmentHeader
+{
+    // the lap the base belongs to, published last
+    std::atomic<uint32_t> epoch;
+    uint32_t unused;
+    std::atomic<int64_t> base;
+};
+
+static std::atomic<uint32_t>& recordWord(char* record, int index)
+{
+    return *reinterpret_cast<std::atomic<uint32_t>*>(record + index * 4);
+}
+
+struct Crc32Table
+{
+    uint32_t entries[256];
+
+    Crc32Table()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+static uint32_t crc32(uint32_t crc, const void* data, size_t length)
+{
+    static const Crc32Table table;
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = table.entries[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t recordCrc(uint32_t epoch, uint32_t length, const void* payload)
+{
+    uint32_t crc = crc32(0, &epoch, sizeof(epoch));
+    crc = crc32(crc, &length, sizeof(length));
+    return crc32(crc, payload, length);
+}
+
+static int64_t wallClockMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void storeMax(std::atomic<uint64_t>& target, uint64_t value)
+{
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+AnalyticsJournal::AnalyticsJournal()
+: _fd(-1)
+, _base(nullptr)
+, _mappedSize(0)
+, _header(nullptr)
+, _segmentSize(0)
+, _segmentCount(0)
+, _dataSize(0)
+, _reserve(0)
+, _evicted(0)
+{
+}
+
+AnalyticsJournal::~AnalyticsJournal()
+{
+    close();
+}
+
+bool AnalyticsJournal::open(const std::string& path, uint32_t segmentSize, uint32_t segmentCount)
+{
+    static_assert(sizeof(FileHeader) <= kSegmentTableOffset, "file header overlaps the segment headers");
+    static_assert(kSegmentTableOffset + kMaxSegments * sizeof(SegmentHeader) <= kHeaderSpaceOffset,
+                  "segment headers overlap the header space");
+
+    if (_base || segmentSize < 1024 || segmentSize % kRecordAlign != 0 || segmentCount < 2
+        || segmentCount > kMaxSegments)
+    {
+        return false;
+    }
+
+    _fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0)
+    {
+        CCLOG("[AnalyticsJournal] cannot open %s", path.c_str());
+        return false;
+    }
+
+    size_t fileSize = kHeaderSize + (size_t)segmentSize * segmentCount;
+
+    // a file from another layout is discarded, truncating zero-fills it
+    uint32_t probe[4];
+    struct stat st;
+    bool reuse = fstat(_fd, &st) == 0 && (size_t)st.st_size == fileSize
+        && pread(_fd, probe, sizeof(probe), 0) == (ssize_t)sizeof(probe)
+        && probe[0] == kJournalMagic && (probe[1] == kJournalVersion || probe[1] == kJournalVersionNoBases)
+        && probe[2] == segmentSize && probe[3] == segmentCount;
+    if (!reuse && (ftruncate(_fd, 0) != 0 || ftruncate(_fd, fileSize) != 0))
+    {
+        CCLOG("[AnalyticsJournal] cannot size %s", path.c_str());
+        close();
+        return false;
+    }
+
+    void* base = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (base == MAP_FAILED)
+    {
+        CCLOG("[AnalyticsJournal] mmap failed for %s", path.c_str());
+        close();
+        return false;
+    }
+
+    _base = static_cast<char*>(base);
+    _mappedSize = fileSize;
+    _segmentSize = segmentSize;
+    _segmentCount = segmentCount;
+    _dataSize = (uint64_t)segmentSize * segmentCount;
+    _header = reinterpret_cast<FileHeader*>(_base);
+
+    if (!reuse)
+    {
+        _header = new (_base) FileHeader();
+        _header->magic = kJournalMagic;
+        _header->version = kJournalVersion;
+        _header->segmentSize = segmentSize;
+        _header->segmentCount = segmentCount;
+        _header->writePos.store(0);
+        _header->readPos.store(0);
+        _header->evicted.store(0);
+    }
+    else if (_header->version == kJournalVersionNoBases)
+    {
+        // every segment replay can still reach gets base 0
+        uint64_t first = _header->readPos.load() / _segmentSize;
+        for (uint64_t segment = first; segment < first + segmentCount; segment++)
+        {
+            publishBase(segment * _segmentSize, 0);
+        }
+        _header->version = kJournalVersion;
+    }
+
+    _reserve.store(_header->writePos.load());
+    _evicted.store(_header->evicted.load());
+    _filled.reset(new std::atomic<uint64_t>[segmentCount]);
+    resetFill(_reserve.load());
+
+    uint64_t reserve = _reserve.load();
+    if (!hasBase(reserve))
+    {
+        publishBase(reserve - reserve % _segmentSize, wallClockMs());
+    }
+    return true;
+}
+
+void AnalyticsJournal::close()
+{
+    if (_base)
+    {
+        munmap(_base, _mappedSize);
+        _base = nullptr;
+        _header = nullptr;
+    }
+    if (_fd >= 0)
+    {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+char* AnalyticsJournal::recordAt(uint64_t pos) const
+{
+    return _base + kHeaderSize + pos % _dataSize;
+}
+
+uint32_t AnalyticsJournal::epochOf(uint64_t pos) const
+{
+    // +1 so the zero-filled file of a fresh journal never looks valid
+    return (uint32_t)(pos / _segmentSize) + 1;
+}
+
+AnalyticsJournal::SegmentHeader& AnalyticsJournal::segmentHeader(uint64_t pos) const
+{
+    SegmentHeader* table = reinterpret_cast<SegmentHeader*>(_base + kSegmentTableOffset);
+    return table[pos / _segmentSize % _segmentCount];
+}
+
+bool AnalyticsJournal::hasBase(uint64_t pos) const
+{
+    return segmentHeader(pos).epoch.load(std::memory_order_acquire) == epochOf(pos);
+}
+
+int64_t AnalyticsJournal::waitForBase(uint64_t pos) const
+{
+    // only spins while the append that entered the segment publishes it;
+    // callers hold a reservation in it, so it cannot be lapped meanwhile
+    while (!hasBase(pos))
+    {
+        std::this_thread::yield();
+    }
+    return segmentHeader(pos).base.load(std::memory_order_relaxed);
+}
+
+void AnalyticsJournal::publishBase(uint64_t segmentStart, int64_t base)
+{
+    SegmentHeader& h = segmentHeader(segmentStart);
+    h.base.store(base, std::memory_order_relaxed);
+    h.epoch.store(epochOf(segmentStart), std::memory_order_release);
+}
+
+int64_t AnalyticsJournal::segmentBase() const
+{
+    if (!_base)
+    {
+        return 0;
+    }
+    // the segment can be lapped while we wait, so look again each time; a
+    // base that changes after this returns is caught by append()
+    for (;;)
+    {
+        uint64_t reserve = _reserve.load(std::memory_order_relaxed);
+        if (hasBase(reserve))
+        {
+            return segmentHeader(reserve).base.load(std::memory_order_relaxed);
+        }
+        std::this_thread::yield();
+    }
+}
+
+char* AnalyticsJournal::headerSpace(uint32_t* capacity) const
+{
+    *capacity = _base ? kHeaderSize - kHeaderSpaceOffset : 0;
+    return _base ? _base + kHeaderSpaceOffset : nullptr;
+}
+
+AnalyticsJournal::RecordState AnalyticsJournal::inspect(uint64_t pos, uint32_t* size, const char** payload, uint32_t* length) const
+{
+    char* r = recordAt(pos);
+    if (recordWord(r, 3).load(std::memory_order_acquire) != epochOf(pos))
+    {
+        return kRecordInvalid;
+    }
+
+    uint32_t s = recordWord(r, 0).load(std::memory_order_relaxed);
+    uint32_t flags = recordWord(r, 1).load(std::memory_order_relaxed);
+    if (s < kRecordHeaderSize || s % kRecordAlign != 0 || pos % _segmentSize + s > _segmentSize)
+    {
+        return kRecordInvalid;
+    }
+    *size = s;
+
+    if (flags & kFlagSkip)
+    {
+        return kRecordSkip;
+    }
+
+    uint32_t len = flags & kLengthMask;
+    if (len > s - kRecordHeaderSize)
+    {
+        return kRecordInvalid;
+    }
+    if (payload)
+    {
+        // only replay pays for the checksum
+        if (recordWord(r, 2).load(std::memory_order_relaxed) != recordCrc(epochOf(pos), len, r + kRecordHeaderSize))
+        {
+            return kRecordInvalid;
+        }
+        *payload = r + kRecordHeaderSize;
+        *length = len;
+    }
+    return (flags & kFlagDone) ? kRecordDone : kRecordPending;
+}
+
+void AnalyticsJournal::replay(const ReplayFunc& fn)
+{
+    if (!_base)
+    {
+        return;
+    }
+
+    uint64_t pos = _header->readPos.load();
+    uint64_t end = _header->writePos.load();
+    uint64_t limit = pos + _dataSize;
+    int replayed = 0;
+
+    while (pos < limit)
+    {
+        uint32_t size = 0;
+        const char* payload = nullptr;
+        uint32_t length = 0;
+        RecordState state = inspect(pos, &size, &payload, &length);
+
+        if (state == kRecordInvalid)
+        {
+            // past the committed end the first bad record is where the
+            // writer stopped; before it, a torn record is papered over so
+            // the read cursor can move past it later
+            if (pos >= end)
+            {
+                break;
+            }
+            writeSkip(pos, kRecordAlign);
+            pos += kRecordAlign;
+            continue;
+        }
+
+        if (state == kRecordPending && !hasBase(pos))
+        {
+            // cannot be decoded without its base
+            recordWord(recordAt(pos), 1).fetch_or(kFlagDone, std::memory_order_relaxed);
+        }
+        else if (state == kRecordPending)
+        {
+            fn(pos, segmentHeader(pos).base.load(), payload, length);
+            replayed++;
+        }
+        pos += size;
+    }
+
+    if (pos > end)
+    {
+        _header->writePos.store(pos);
+    }
+    uint64_t reserve = pos > end ? pos : end;
+    _reserve.store(reserve);
+    resetFill(reserve);
+    if (!hasBase(reserve))
+    {
+        publishBase(reserve - reserve % _segmentSize, wallClockMs());
+    }
+
+    if (replayed > 0)
+    {
+        CCLOG("[AnalyticsJournal] replaying %d undelivered events", replayed);
+    }
+}
+
+// earlier laps are complete, the current segment is filled up to reserve
+void AnalyticsJournal::resetFill(uint64_t reserve)
+{
+    uint64_t current = reserve / _segmentSize;
+    for (uint32_t i = 0; i < _segmentCount; i++)
+    {
+        uint64_t segment = current - current % _segmentCount + i;
+        if (segment < current)
+        {
+            segment += _segmentCount;
+        }
+        uint64_t filled = segment / _segmentCount * _segmentSize;
+        if (segment == current)
+        {
+            filled += reserve % _segmentSize;
+        }
+        _filled[i].store(filled);
+    }
+}
+
+void AnalyticsJournal::writeSkip(uint64_t pos, uint32_t size)
+{
+    char* r = recordAt(pos);
+    recordWord(r, 0).store(size, std::memory_order_relaxed);
+    recordWord(r, 1).store(kFlagSkip, std::memory_order_relaxed);
+    recordWord(r, 2).store(0, std::memory_order_relaxed);
+    recordWord(r, 3).store(epochOf(pos), std::memory_order_release);
+}
+
+// called exactly once per segment boundary, by the append whose
+// reservation reaches it
+void AnalyticsJournal::enterSegment(uint64_t segmentStart)
+{
+    uint64_t segmentEnd = segmentStart + _segmentSize;
+    if (segmentEnd > _dataSize)
+    {
+        // the physical segment is reused, whatever it held from the
+        // previous lap is gone
+        uint64_t oldest = segmentEnd - _dataSize;
+        uint64_t read = _header->readPos.load(std::memory_order_relaxed);
+        if (read < oldest)
+        {
+            storeMax(_header->readPos, oldest);
+            _header->evicted.fetch_add(1, std::memory_order_relaxed);
+            _evicted.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // writers from the previous lap have read their base before filling
+    waitForLap(segmentStart);
+    publishBase(segmentStart, wallClockMs());
+}
+
+void AnalyticsJournal::waitForLap(uint64_t pos) const
+{
+    uint64_t segment = pos / _segmentSize;
+    uint64_t previousLap = segment / _segmentCount * _segmentSize;
+    // only a writer preempted for a whole lap of the ring makes this spin
+    while (_filled[segment % _segmentCount].load(std::memory_order_acquire) < previousLap)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void AnalyticsJournal::fill(uint64_t pos, uint32_t size)
+{
+    _filled[pos / _segmentSize % _segmentCount].fetch_add(size, std::memory_order_release);
+}
+
+void AnalyticsJournal::commit(uint64_t end)
+{
+    storeMax(_header->writePos, end);
+}
+
+uint64_t AnalyticsJournal::append(const void* data, uint32_t length, int64_t base)
+{
+    if (!_base)
+    {
+        return kInvalidPos;
+    }
+
+    uint32_t size = (kRecordHeaderSize + length + kRecordAlign - 1) & ~(kRecordAlign - 1);
+    if (length > kLengthMask || size > _segmentSize)
+    {
+        return kInvalidPos;
+    }
+
+    for (;;)
+    {
+        uint64_t pos = _reserve.fetch_add(size, std::memory_order_relaxed);
+        uint64_t next = pos - pos % _segmentSize + _segmentSize;
+
+        if (pos + size >= next)
+        {
+            enterSegment(next);
+        }
+
+        if (pos + size > next)
+        {
+            // does not fit in what is left of this segment: both halves of
+            // the reservation become skip records and we try again
+            waitForLap(pos);
+            writeSkip(pos, (uint32_t)(next - pos));
+            fill(pos, (uint32_t)(next - pos));
+            waitForLap(next);
+            writeSkip(next, (uint32_t)(pos + size - next));
+            fill(next, (uint32_t)(pos + size - next));
+            commit(pos + size);
+            continue;
+        }
+
+        waitForLap(pos);
+        if (waitForBase(pos) != base)
+        {
+            writeSkip(pos, size);
+            fill(pos, size);
+            commit(pos + size);
+            return kStaleBase;
+        }
+
+        char* r = recordAt(pos);
+        recordWord(r, 0).store(size, std::memory_order_relaxed);
+        recordWord(r, 1).store(length, std::memory_order_relaxed);
+        memcpy(r + kRecordHeaderSize, data, length);
+        recordWord(r, 2).store(recordCrc(epochOf(pos), length, data), std::memory_order_relaxed);
+        recordWord(r, 3).store(epochOf(pos), std::memory_order_release);
+        fill(pos, size);
+        commit(pos + size);
+        return pos;
+    }
+}
+
+void AnalyticsJournal::markDone(uint64_t pos)
+{
+    if (pos == kInvalidPos || !_base)
+    {
+        return;
+    }
+
+    // evicted, and the slot may already belong to a newer record
+    if (pos < _header->readPos.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    char* r = recordAt(pos);
+    if (recordWord(r, 3).load(std::memory_order_acquire) == epochOf(pos))
+    {
+        recordWord(r, 1).fetch_or(kFlagDone, std::memory_order_relaxed);
+    }
+}
+
+void AnalyticsJournal::advance()
+{
+    if (!_base)
+    {
+        return;
+    }
+
+    uint64_t start = _header->readPos.load(std::memory_order_acquire);
+    uint64_t end = _header->writePos.load(std::memory_order_acquire);
+    uint64_t pos = start;
+
+    // stops at the first pending record, or one still being written
+    while (pos < end)
+    {
+        uint32_t size = 0;
+        RecordState state = inspect(pos, &size, nullptr, nullptr);
+        if (state != kRecordDone && state != kRecordSkip)
+        {
+            break;
+        }
+        pos += size;
+    }
+
+    if (pos != start)
+    {
+        storeMax(_header->readPos, pos);
+    }
+}
+
+void AnalyticsJournal::sync()
+{
+    if (_base)
+    {
+        // a hint for power loss, process death is already covered
+        msync(_base, _mappedSize, MS_ASYNC);
+    }
+}
@@ -0,0 +1,133 @@
+//
+//  AnalyticsJournal.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsJournal__
+#define __template__AnalyticsJournal__
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+/**
+ * Append-only, memory-mapped journal of analytics events.
+ *
+ * The file is a header page followed by segmentCount fixed-size segments
+ * used as a ring. Positions are logical byte offsets that only grow; a
+ * record lives at kHeaderSize + pos % dataSize and carries the epoch of the
+ * segment it was written in (pos / segmentSize) and a CRC32 of its payload,
+ * so torn writes and stale records from an earlier lap are rejected.
+ *
+ * Each segment has a header in the header page holding a base timestamp,
+ * the wall clock when the segment was entered. Records keep their time as
+ * a delta from it, so they stay small and still decode one by one. The
+ * rest of the header page is left to the owner for state the records
+ * refer to, such as the codec's learned strings.
+ *
+ *   append()    any thread, lock-free: one fetch_add to reserve, a memcpy
+ *               into the mapping and a release store of the record size
+ *   markDone()  flags a record as delivered in place
+ *   advance()   moves the persisted read cursor over delivered records
+ *   replay()    at open, hands back every record that was never delivered
+ *
+ * Nothing is fsync'd: the pages are shared with the kernel, so a process
+ * that is killed loses nothing that append() returned for. When the writer
+ * enters a segment that still holds unread data the read cursor is pushed
+ * past it, evicting the oldest segment first.
+ */
+class AnalyticsJournal
+{
+public:
+    typedef std::function<void(uint64_t pos, int64_t base, const char* data, uint32_t length)> ReplayFunc;
+
+    static const uint64_t kInvalidPos = ~0ull;
+    // the record was encoded against another segment's base
+    static const uint64_t kStaleBase = ~0ull - 1;
+
+    AnalyticsJournal();
+    ~AnalyticsJournal();
+
+    // creates or reopens the file; false leaves the journal disabled
+    bool open(const std::string& path, uint32_t segmentSize, uint32_t segmentCount);
+    void close();
+
+    bool isOpen() const { return _base != nullptr; }
+
+    // open() thread, before the first append(). Calls fn in write order for
+    // every intact record that was not marked done, with its segment base.
+    void replay(const ReplayFunc& fn);
+
+    // base of the segment being filled, to encode the next record against
+    int64_t segmentBase() const;
+
+    // returns the record position, kInvalidPos when closed or too large.
+    // kStaleBase when the record reached a segment with a different base:
+    // encode it again against segmentBase() and retry.
+    uint64_t append(const void* data, uint32_t length, int64_t base);
+
+    void markDone(uint64_t pos);
+
+    // single consumer
+    void advance();
+
+    // schedules write-back, e.g. when the app goes to the background
+    void sync();
+
+    uint64_t getEvictedSegments() const { return _evicted.load(std::memory_order_relaxed); }
+
+    // owner state kept for the life of the file, zeroed when it is created
+    char* headerSpace(uint32_t* capacity) const;
+
+private:
+    struct FileHeader;
+    struct SegmentHeader;
+
+    enum RecordState
+    {
+        kRecordInvalid,
+        kRecordPending,
+        kRecordDone,
+        kRecordSkip
+    };
+
+    static const uint32_t kHeaderSize = 4096;
+    static const uint32_t kSegmentTableOffset = 64;
+    static const uint32_t kMaxSegments = 32;
+    static const uint32_t kHeaderSpaceOffset = 1024;
+    static const uint32_t kRecordAlign = 16;
+
+    char* recordAt(uint64_t pos) const;
+    uint32_t epochOf(uint64_t pos) const;
+    SegmentHeader& segmentHeader(uint64_t pos) const;
+    bool hasBase(uint64_t pos) const;
+    int64_t waitForBase(uint64_t pos) const;
+    void publishBase(uint64_t segmentStart, int64_t base);
+    RecordState inspect(uint64_t pos, uint32_t* size, const char** payload, uint32_t* length) const;
+    void writeSkip(uint64_t pos, uint32_t size);
+    void enterSegment(uint64_t segmentStart);
+    void resetFill(uint64_t reserve);
+    void waitForLap(uint64_t pos) const;
+    void fill(uint64_t pos, uint32_t size);
+    void commit(uint64_t end);
+
+    int _fd;
+    char* _base;
+    size_t _mappedSize;
+    FileHeader* _header;
+    uint32_t _segmentSize;
+    uint32_t _segmentCount;
+    uint64_t _dataSize;
+
+    std::atomic<uint64_t> _reserve;
+    std::atomic<uint64_t> _evicted;
+    // per physical segment, bytes written into it over all laps. A writer
+    // waits for the previous lap to be complete before reusing it.
+    std::unique_ptr<std::atomic<uint64_t>[]> _filled;
+};
+
+#endif /* defined(__template__AnalyticsJournal__) */
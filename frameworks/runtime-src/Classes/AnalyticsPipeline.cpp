@@ -0,0 +1,1109 @@
+//
+//  AnalyticsPipeline.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsPipeline.h"
+#include "AnalyticsCodec.h"
+#include "AnalyticsSampler.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+
+#include "PluginFlurryAnalytics/PluginFlurryAnalytics.h"
+#include "PluginGoogleAnalytics/PluginGoogleAnalytics.h"
+#include "PluginKochava/PluginKochava.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static uint32_t elapsedUs(Clock::time_point from, Clock::time_point to)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+SdkPlugin AnalyticsEvent::provider() const
+{
+    switch (type)
+    {
+        case kGALogEvent:
+        case kGALogScreen:
+        case kGALogTiming:
+            return SdkPlugin::GoogleAnalytics;
+        case kKochavaTrackEvent:
+        case kKochavaSpatialEvent:
+            return SdkPlugin::Kochava;
+        case kTuneMeasureEventName:
+        case kTuneMeasureEvent:
+        case kTuneMeasureEventId:
+        case kTuneMeasureSession:
+            return SdkPlugin::Tune;
+        default:
+            return SdkPlugin::FlurryAnalytics;
+    }
+}
+
+const char* analyticsPriorityName(AnalyticsPriority priority)
+{
+    switch (priority)
+    {
+        case AnalyticsPriority::Critical: return "critical";
+        case AnalyticsPriority::High:     return "high";
+        case AnalyticsPriority::Normal:   return "normal";
+        case AnalyticsPriority::Low:      return "low";
+    }
+    return "";
+}
+
+// unlimited until configured
+AnalyticsPipeline::PriorityClass::PriorityClass()
+: budget(0)
+, policy(kDropOldest)
+, sampleEvery(1)
+, bytes(0)
+, shed(0)
+, sampleTick(0)
+, queued(0)
+, dropped(0)
+{
+}
+
+// odr-used by std::chrono::milliseconds
+const int AnalyticsPipeline::kFlushIntervalMs;
+
+AnalyticsPipeline::AnalyticsPipeline()
+: _criticalOverflows(0)
+, _sequence(0)
+, _wakeRequested(false)
+, _wakePending(false)
+, _syncRequested(false)
+, _flushRequests(0)
+, _flushesDone(0)
+, _started(false)
+, _journalReady(false)
+, _readyMask(0)
+, _replayedMask(0)
+, _queued(0)
+, _delivered(0)
+, _dropped(0)
+, _sampled(0)
+, _lastFlushUs(0)
+, _maxFlushUs(0)
+, _lastLatencyUs(0)
+{
+    for (auto& slot : _inFlight)
+    {
+        slot.store(kIdleSlot, std::memory_order_relaxed);
+    }
+}
+
+AnalyticsPipeline* AnalyticsPipeline::getInstance()
+{
+    static AnalyticsPipeline *instance = 0;
+    if (!instance)
+    {
+        instance = new AnalyticsPipeline();
+    }
+    return instance;
+}
+
+// true when name is one of critical/high/normal/low
+static bool parsePriority(const rapidjson::Value& name, AnalyticsPriority& priority)
+{
+    for (int c = 0; c < AnalyticsPipeline::kPriorityCount && name.IsString(); c++)
+    {
+        if (strcmp(name.GetString(), analyticsPriorityName((AnalyticsPriority)c)) == 0)
+        {
+            priority = (AnalyticsPriority)c;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AnalyticsPipeline::loadConfig(const std::string& file)
+{
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[AnalyticsPipeline] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& analytics = doc["analytics"];
+
+    if (analytics.HasMember("coalesce") && analytics["coalesce"].IsObject())
+    {
+        const rapidjson::Value& coalesce = analytics["coalesce"];
+        int windowMs = 0;
+        int slots = 0;
+        uint32_t providers = 0;
+        if (coalesce.HasMember("windowMs") && coalesce["windowMs"].IsInt())
+        {
+            windowMs = coalesce["windowMs"].GetInt();
+        }
+        if (coalesce.HasMember("slots") && coalesce["slots"].IsInt())
+        {
+            slots = coalesce["slots"].GetInt();
+        }
+        if (coalesce.HasMember("providers") && coalesce["providers"].IsArray())
+        {
+            const rapidjson::Value& names = coalesce["providers"];
+            for (rapidjson::SizeType i = 0; i < names.Size(); i++)
+            {
+                for (int p = 0; p < kProviderCount && names[i].IsString(); p++)
+                {
+                    if (strcmp(names[i].GetString(), sdkPluginName((SdkPlugin)p)) == 0)
+                    {
+                        providers |= 1u << p;
+                    }
+                }
+            }
+        }
+        _coalescer.configure(windowMs, slots > 0 ? (size_t)slots : 0, providers);
+    }
+
+    if (analytics.HasMember("priority") && analytics["priority"].IsObject())
+    {
+        const rapidjson::Value& priority = analytics["priority"];
+        if (priority.HasMember("classes") && priority["classes"].IsObject())
+        {
+            const rapidjson::Value& classes = priority["classes"];
+            for (auto it = classes.MemberonBegin(); it != classes.MemberonEnd(); ++it)
+            {
+                AnalyticsPriority c;
+                if (!parsePriority(it->name, c) || !it->value.IsObject())
+                {
+                    continue;
+                }
+                if (c == AnalyticsPriority::Critical)
+                {
+                    CCLOG("[AnalyticsPipeline] critical events are never dropped, ignoring its budget");
+                    continue;
+                }
+
+                const rapidjson::Value& cls = it->value;
+                PriorityClass& pc = _classes[(int)c];
+                if (cls.HasMember("budgetKB") && cls["budgetKB"].IsInt())
+                {
+                    pc.budget = (size_t)std::max(0, cls["budgetKB"].GetInt()) * 1024;
+                }
+                if (cls.HasMember("policy") && cls["policy"].IsString())
+                {
+                    const char* policy = cls["policy"].GetString();
+                    if (strcmp(policy, "drop-oldest") == 0)
+                    {
+                        pc.policy = kDropOldest;
+                    }
+                    else if (strcmp(policy, "drop-newest") == 0)
+                    {
+                        pc.policy = kDropNewest;
+                    }
+                    else if (strcmp(policy, "sample") == 0)
+                    {
+                        pc.policy = kSample;
+                    }
+                    else
+                    {
+                        CCLOG("[AnalyticsPipeline] unknown drop policy %s", policy);
+                    }
+                }
+                if (cls.HasMember("sampleEvery") && cls["sampleEvery"].IsInt())
+                {
+                    pc.sampleEvery = (uint32_t)std::max(1, cls["sampleEvery"].GetInt());
+                }
+            }
+        }
+        if (priority.HasMember("events") && priority["events"].IsObject())
+        {
+            const rapidjson::Value& events = priority["events"];
+            for (auto it = events.MemberonBegin(); it != events.MemberonEnd(); ++it)
+            {
+                AnalyticsPriority c;
+                if (it->name.IsString() && parsePriority(it->value, c))
+                {
+                    _priorityByName[it->name.GetString()] = c;
+                }
+            }
+        }
+    }
+}
+
+void AnalyticsPipeline::start()
+{
+    if (_started.exchange(true))
+    {
+        return;
+    }
+    _journalPath = cocos2d::FileUtils::getInstance()->getWritablePath() + "analytics.journal";
+    std::thread([this]() {
+        workerLoop();
+    }).detach();
+}
+
+void AnalyticsPipeline::setProviderReady(SdkPlugin provider)
+{
+    _readyMask.fetch_or(1u << (int)provider, std::memory_order_release);
+    wake();
+}
+
+bool AnalyticsPipeline::flurryLogEvent(const std::string& name, bool timed)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kFlurryLogEvent;
+    e.name = name;
+    e.timed = timed;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::flurryLogEvent(const std::string& name, EventParams params, bool timed)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kFlurryLogEvent;
+    e.name = name;
+    e.params = std::move(params);
+    e.timed = timed;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::flurryEndTimedEvent(const std::string& name)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kFlurryEndTimedEvent;
+    e.name = name;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::flurryEndTimedEvent(const std::string& name, EventParams params)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kFlurryEndTimedEvent;
+    e.name = name;
+    e.params = std::move(params);
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::flurryEndSession()
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kFlurryEndSession;
+    return enqueue(std::move(e));
+}
+
+// falls back to a copy once the table is full
+static void internInto(StringRef s, InternedString& interned, std::string& plain)
+{
+    interned = StringInterner::getInstance()->intern(s);
+    if (!interned)
+    {
+        plain.assign(s.data, s.size);
+    }
+}
+
+bool AnalyticsPipeline::gaLogEvent(StringRef category, StringRef action, StringRef label, int value)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kGALogEvent;
+    internInto(category, e.internedName, e.name);
+    internInto(action, e.internedAction, e.action);
+    internInto(label, e.internedLabel, e.label);
+    e.value = value;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::gaLogEvent(InternedString category, InternedString action, InternedString label, int value)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kGALogEvent;
+    e.internedName = category;
+    e.internedAction = action;
+    e.internedLabel = label;
+    e.value = value;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::gaLogScreen(StringRef title)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kGALogScreen;
+    internInto(title, e.internedName, e.name);
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::gaLogScreen(InternedString title)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kGALogScreen;
+    e.internedName = title;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::gaLogTiming(StringRef category, int interval, StringRef name, StringRef label)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kGALogTiming;
+    internInto(category, e.internedName, e.name);
+    e.value = interval;
+    internInto(name, e.internedAction, e.action);
+    internInto(label, e.internedLabel, e.label);
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::gaLogTiming(InternedString category, int interval, InternedString name, InternedString label)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kGALogTiming;
+    e.internedName = category;
+    e.value = interval;
+    e.internedAction = name;
+    e.internedLabel = label;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::kochavaTrackEvent(const std::string& name, const std::string& value)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kKochavaTrackEvent;
+    e.name = name;
+    e.action = value;
+    return enqueue(std::move(e));
+}
+
+static void setFloat(EventParams& params, const char* key, float value)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%g", value);
+    params.set(key, buf);
+}
+
+bool AnalyticsPipeline::kochavaSpatialEvent(const std::string& title, float x, float y, float z)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kKochavaSpatialEvent;
+    e.name = title;
+    setFloat(e.params, "x", x);
+    setFloat(e.params, "y", y);
+    setFloat(e.params, "z", z);
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::tuneMeasureEventName(const std::string& name)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kTuneMeasureEventName;
+    e.name = name;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::tuneMeasureEvent(const sdkbox::TuneEvent& event)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kTuneMeasureEvent;
+    e.tune.reset(new sdkbox::TuneEvent(event));
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::tuneMeasureEventJson(const std::string& eventJson)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kTuneMeasureEvent;
+    e.paramsJson = eventJson;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::tuneMeasureEventId(int eventId)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kTuneMeasureEventId;
+    e.value = eventId;
+    return enqueue(std::move(e));
+}
+
+// TunePreloadData travels as params, which the journal already knows how
+// to store
+static const struct
+{
+    const char* key;
+    std::string sdkbox::TunePreloadData::*field;
+} kPreloadFields[] = {
+    { "publisherId", &sdkbox::TunePreloadData::publisherId },
+    { "offerId", &sdkbox::TunePreloadData::offerId },
+    { "agencyId", &sdkbox::TunePreloadData::agencyId },
+    { "publisherReferenceId", &sdkbox::TunePreloadData::publisherReferenceId },
+    { "publisherSub1", &sdkbox::TunePreloadData::publisherSub1 },
+    { "publisherSub2", &sdkbox::TunePreloadData::publisherSub2 },
+    { "publisherSub3", &sdkbox::TunePreloadData::publisherSub3 },
+    { "publisherSub4", &sdkbox::TunePreloadData::publisherSub4 },
+    { "publisherSub5", &sdkbox::TunePreloadData::publisherSub5 },
+    { "publisherSubAd", &sdkbox::TunePreloadData::publisherSubAd },
+    { "publisherSubAdgroup", &sdkbox::TunePreloadData::publisherSubAdgroup },
+    { "publisherSubCampaign", &sdkbox::TunePreloadData::publisherSubCampaign },
+    { "publisherSubKeyword", &sdkbox::TunePreloadData::publisherSubKeyword },
+    { "publisherSubPublisher", &sdkbox::TunePreloadData::publisherSubPublisher },
+    { "publisherSubSite", &sdkbox::TunePreloadData::publisherSubSite },
+    { "advertiserSubAd", &sdkbox::TunePreloadData::advertiserSubAd },
+    { "advertiserSubAdgroup", &sdkbox::TunePreloadData::advertiserSubAdgroup },
+    { "advertiserSubCampaign", &sdkbox::TunePreloadData::advertiserSubCampaign },
+    { "advertiserSubKeyword", &sdkbox::TunePreloadData::advertiserSubKeyword },
+    { "advertiserSubPublisher", &sdkbox::TunePreloadData::advertiserSubPublisher },
+    { "advertiserSubSite", &sdkbox::TunePreloadData::advertiserSubSite },
+};
+
+bool AnalyticsPipeline::tuneMeasureSession()
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kTuneMeasureSession;
+    return enqueue(std::move(e));
+}
+
+bool AnalyticsPipeline::tuneMeasureSession(const sdkbox::TunePreloadData& preload)
+{
+    AnalyticsEvent e;
+    e.type = AnalyticsEvent::kTuneMeasureSession;
+    for (const auto& f : kPreloadFields)
+    {
+        const std::string& value = preload.*f.field;
+        if (!value.empty())
+        {
+            e.params.set(f.key, strlen(f.key), value.data(), value.size());
+        }
+    }
+    return enqueue(std::move(e));
+}
+
+AnalyticsPriority AnalyticsPipeline::classify(const AnalyticsEvent& event) const
+{
+    if (!_priorityByName.empty())
+    {
+        const std::string* name = &event.nameString();
+        if (event.type == AnalyticsEvent::kGALogEvent)
+        {
+            name = &event.actionString();
+        }
+        else if (event.type == AnalyticsEvent::kTuneMeasureEvent && event.tune)
+        {
+            name = &event.tune->eventName;
+        }
+        auto it = _priorityByName.find(*name);
+        if (it != _priorityByName.end())
+        {
+            return it->second;
+        }
+    }
+
+    switch (event.type)
+    {
+        case AnalyticsEvent::kTuneMeasureEvent:
+            return AnalyticsPriority::Critical;
+        case AnalyticsEvent::kTuneMeasureSession:
+        case AnalyticsEvent::kTuneMeasureEventName:
+        case AnalyticsEvent::kTuneMeasureEventId:
+        case AnalyticsEvent::kKochavaTrackEvent:
+        case AnalyticsEvent::kKochavaSpatialEvent:
+        case AnalyticsEvent::kFlurryEndSession:
+            return AnalyticsPriority::High;
+        case AnalyticsEvent::kGALogScreen:
+        case AnalyticsEvent::kGALogTiming:
+            return AnalyticsPriority::Low;
+        default:
+            return AnalyticsPriority::Normal;
+    }
+}
+
+// what the event holds on the heap plus its own size; string capacity is
+// not portable to measure, so sizes are used
+uint32_t AnalyticsPipeline::footprint(const AnalyticsEvent& event)
+{
+    size_t bytes = sizeof(AnalyticsEvent) + event.name.size() + event.action.size() + event.label.size()
+        + event.paramsJson.size() + event.params.heapBytes();
+    if (event.tune)
+    {
+        bytes += sizeof(sdkbox::TuneEvent) + event.tune->eventItems.size() * sizeof(sdkbox::TuneEventItem)
+            + event.tune->receipt.size() + event.tune->receiptSignature.size();
+    }
+    return (uint32_t)bytes;
+}
+
+// false when the policy of an over-budget class rejects the event
+bool AnalyticsPipeline::admit(PriorityClass& pc, uint32_t bytes)
+{
+    if (pc.budget == 0 || pc.bytes.load(std::memory_order_relaxed) + bytes <= pc.budget)
+    {
+        return true;
+    }
+    switch (pc.policy)
+    {
+        case kDropNewest:
+            return false;
+        case kSample:
+            return pc.sampleTick.fetch_add(1, std::memory_order_relaxed) % pc.sampleEvery == 0;
+        case kDropOldest:
+            // the consumer owns the head of the ring, so the worker does it
+            pc.shed.fetch_add(1, std::memory_order_relaxed);
+            wake();
+            return true;
+    }
+    return true;
+}
+
+// Publishes a lower bound of the number the caller is about to take: the
+// bound is read before the slot is claimed and the number after, so the
+// number is never below it. drain() reads the counter first and the slots
+// second, so any number it sees as taken is either covered by its slot or
+// already pushed.
+size_t AnalyticsPipeline::claimInFlight()
+{
+    for (;;)
+    {
+        uint64_t lowerBound = _sequence.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i < kInFlightSlots; i++)
+        {
+            uint64_t idle = kIdleSlot;
+            if (_inFlight[i].compare_exchange_strong(idle, lowerBound, std::memory_order_seq_cst))
+            {
+                return i;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool AnalyticsPipeline::enqueue(AnalyticsEvent&& event)
+{
+    event.priority = classify(event);
+
+    // withheld on purpose, so neither journaled nor reported as a failure
+    if (event.priority != AnalyticsPriority::Critical
+        && AnalyticsSampler::getInstance()->sample(event) != AnalyticsSampler::kKeep)
+    {
+        _sampled.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    event.queuedAt = Clock::now();
+    if (event.timestampMs == 0)
+    {
+        event.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    event.queuedBytes = footprint(event);
+
+    int c = (int)event.priority;
+    PriorityClass& pc = _classes[c];
+    if (!admit(pc, event.queuedBytes))
+    {
+        pc.dropped.fetch_add(1, std::memory_order_relaxed);
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (event.journalPos == AnalyticsJournal::kInvalidPos && _journalReady.load(std::memory_order_acquire))
+    {
+        std::string record;
+        // one allocation for a typical event instead of one per doubling
+        record.reserve(128);
+        for (;;)
+        {
+            int64_t base = _journal.segmentBase();
+            AnalyticsCodec::encode(event, base, &_learned, record);
+            event.journalPos = _journal.append(record.data(), (uint32_t)record.size(), base);
+            // only when the record reached a segment entered after the base was read
+            if (event.journalPos != AnalyticsJournal::kStaleBase)
+            {
+                break;
+            }
+            record.clear();
+        }
+    }
+
+    uint64_t journalPos = event.journalPos;
+    uint32_t bytes = event.queuedBytes;
+    pc.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    // holds drain() below this event's number until the push is done
+    size_t slot = claimInFlight();
+    event.sequence = _sequence.fetch_add(1, std::memory_order_seq_cst);
+
+    // push() leaves the event alone when it fails
+    if (!_rings[c].push(std::move(event)))
+    {
+        if (event.priority == AnalyticsPriority::Critical)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_overflowMutex);
+                _criticalOverflow.push_back(std::move(event));
+            }
+            _inFlight[slot].store(kIdleSlot, std::memory_order_release);
+            _criticalOverflows.fetch_add(1, std::memory_order_relaxed);
+            pc.queued.fetch_add(1, std::memory_order_relaxed);
+            _queued.fetch_add(1, std::memory_order_relaxed);
+            wake();
+            return true;
+        }
+
+        _inFlight[slot].store(kIdleSlot, std::memory_order_release);
+        // a dropped event is not replayed either
+        pc.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        _journal.markDone(journalPos);
+        pc.dropped.fetch_add(1, std::memory_order_relaxed);
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        wake();
+        return false;
+    }
+    _inFlight[slot].store(kIdleSlot, std::memory_order_release);
+    pc.queued.fetch_add(1, std::memory_order_relaxed);
+    _queued.fetch_add(1, std::memory_order_relaxed);
+
+    // one wake-up per batch, not per event; critical ones go out right away
+    if (c == (int)AnalyticsPriority::Critical || _rings[c].size() >= kBatchSize)
+    {
+        wake();
+    }
+    return true;
+}
+
+void AnalyticsPipeline::flush()
+{
+    _syncRequested.store(true, std::memory_order_relaxed);
+    wake();
+}
+
+bool AnalyticsPipeline::flushAndWait(int budgetMs)
+{
+    if (!_started.load())
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    uint64_t request = ++_flushRequests;
+    _syncRequested.store(true, std::memory_order_relaxed);
+    _wakeRequested = true;
+    _cond.notify_one();
+    return _flushedCond.wait_for(lock, std::chrono::milliseconds(budgetMs), [this, request]() {
+        return _flushesDone >= request;
+    });
+}
+
+void AnalyticsPipeline::wake()
+{
+    if (_wakePending.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _wakeRequested = true;
+    _cond.notify_one();
+}
+
+void AnalyticsPipeline::workerLoop()
+{
+    openJournal();
+
+    for (;;)
+    {
+        uint64_t flushRequests;
+        bool waited;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs), [this]() {
+                return _wakeRequested;
+            });
+            _wakeRequested = false;
+            flushRequests = _flushRequests;
+            waited = _flushRequests > _flushesDone;
+        }
+        _wakePending.store(false, std::memory_order_release);
+
+        drain();
+
+        // a flushAndWait() that came in after the last check still counts
+        bool flushRequested = _syncRequested.exchange(false, std::memory_order_relaxed) || waited;
+        if (flushRequested || _coalescer.isDue(Clock::now()))
+        {
+            flushCoalesced();
+        }
+
+        if (_journalReady.load(std::memory_order_relaxed))
+        {
+            _journal.advance();
+            if (flushRequested)
+            {
+                _journal.sync();
+            }
+        }
+
+        if (waited)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _flushesDone = flushRequests;
+            _flushedCond.notify_all();
+        }
+    }
+}
+
+// session control and timed events belong to the run that logged them; the
+// session they refer to is over by the next launch
+static bool replayable(const AnalyticsEvent& e)
+{
+    switch (e.type)
+    {
+        case AnalyticsEvent::kFlurryEndSession:
+        case AnalyticsEvent::kFlurryEndTimedEvent:
+        case AnalyticsEvent::kTuneMeasureSession:
+            return false;
+        case AnalyticsEvent::kFlurryLogEvent:
+            return !e.timed;
+        default:
+            return true;
+    }
+}
+
+// worker thread
+void AnalyticsPipeline::openJournal()
+{
+    if (!_journal.open(_journalPath, kJournalSegmentSize, kJournalSegmentCount))
+    {
+        return;
+    }
+
+    uint32_t capacity = 0;
+    char* storage = _journal.headerSpace(&capacity);
+    _learned.attach(storage, capacity);
+
+    // what the last run never delivered goes ahead of anything new
+    int replayed = 0;
+    _journal.replay([this, &replayed](uint64_t pos, int64_t base, const char* data, uint32_t length) {
+        AnalyticsEvent e;
+        if (!AnalyticsCodec::decode(data, length, base, &_learned, e) || !replayable(e))
+        {
+            _journal.markDone(pos);
+            return;
+        }
+        e.journalPos = pos;
+        e.queuedAt = Clock::now();
+        park(std::move(e), true);
+        replayed++;
+    });
+
+    // no record left refers to a learned string, start over
+    if (replayed == 0)
+    {
+        _learned.clear();
+    }
+
+    _journalReady.store(true, std::memory_order_release);
+}
+
+// worker thread
+void AnalyticsPipeline::drain()
+{
+    uint32_t ready = _readyMask.load(std::memory_order_acquire);
+
+    // replay what was parked while a provider was initializing, before
+    // anything newer for the same provider
+    uint32_t newlyReady = ready & ~_replayedMask;
+    if (newlyReady)
+    {
+        for (int p = 0; p < kProviderCount; p++)
+        {
+            if ((newlyReady & (1u << p)) && !_parked[p].empty())
+            {
+                for (auto& e : _parked[p])
+                {
+                    deliver(e);
+                }
+                std::vector<AnalyticsEvent>().swap(_parked[p]);
+            }
+        }
+        _replayedMask |= newlyReady;
+    }
+
+    // The limit is the lowest number that may not be in its ring yet: the
+    // next one, or the bound of a producer still between taking a number
+    // and pushing it. Everything below it was pushed before the rings are
+    // popped; the rest waits for the next drain, so no event overtakes one
+    // numbered before it, across threads too.
+    uint64_t limit = _sequence.load(std::memory_order_seq_cst);
+    for (auto& slot : _inFlight)
+    {
+        limit = std::min(limit, slot.load(std::memory_order_seq_cst));
+    }
+
+    // bounded to what is queued now so a busy producer cannot pin the worker
+    auto start = Clock::now();
+    AnalyticsEvent e;
+    for (int c = 0; c < kPriorityCount; c++)
+    {
+        PriorityClass& pc = _classes[c];
+        uint32_t shed = pc.shed.exchange(0, std::memory_order_relaxed);
+        size_t n = _rings[c].size();
+        while (n-- > 0 && _rings[c].pop(e))
+        {
+            pc.bytes.fetch_sub(e.queuedBytes, std::memory_order_relaxed);
+            if (shed > 0)
+            {
+                shed--;
+                _journal.markDone(e.journalPos);
+                pc.dropped.fetch_add(1, std::memory_order_relaxed);
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            _batch.push_back(std::move(e));
+        }
+
+        if (c == (int)AnalyticsPriority::Critical)
+        {
+            std::lock_guard<std::mutex> lock(_overflowMutex);
+            for (auto& o : _criticalOverflow)
+            {
+                pc.bytes.fetch_sub(o.queuedBytes, std::memory_order_relaxed);
+                _batch.push_back(std::move(o));
+            }
+            _criticalOverflow.clear();
+        }
+    }
+
+    if (_batch.empty())
+    {
+        return;
+    }
+
+    std::sort(_batch.begin(), _batch.end(), [](const AnalyticsEvent& a, const AnalyticsEvent& b) {
+        return a.sequence < b.sequence;
+    });
+    size_t due = 0;
+    while (due < _batch.size() && _batch[due].sequence < limit)
+    {
+        due++;
+    }
+    if (due == 0)
+    {
+        return;
+    }
+    _lastLatencyUs.store(elapsedUs(_batch[0].queuedAt, start), std::memory_order_relaxed);
+    for (size_t i = 0; i < due; i++)
+    {
+        route(_batch[i], ready, start);
+    }
+    _batch.erase(_batch.begin(), _batch.begin() + due);
+
+    uint32_t took = elapsedUs(start, Clock::now());
+    _lastFlushUs.store(took, std::memory_order_relaxed);
+    if (took > _maxFlushUs.load(std::memory_order_relaxed))
+    {
+        _maxFlushUs.store(took, std::memory_order_relaxed);
+    }
+}
+
+// what was held before these belongs to the session or screen they close
+static bool closesWindow(const AnalyticsEvent& e)
+{
+    return e.type == AnalyticsEvent::kFlurryEndSession
+        || e.type == AnalyticsEvent::kTuneMeasureSession
+        || e.type == AnalyticsEvent::kGALogScreen;
+}
+
+// worker thread
+void AnalyticsPipeline::route(AnalyticsEvent& e, uint32_t ready, Clock::time_point now)
+{
+    if (ready & (1u << (int)e.provider()))
+    {
+        if (closesWindow(e) && _coalescer.size() > 0)
+        {
+            flushCoalesced();
+        }
+        if (!_coalescer.add(e, now))
+        {
+            deliver(e);
+        }
+    }
+    else
+    {
+        park(std::move(e), false);
+    }
+}
+
+// worker thread
+void AnalyticsPipeline::park(AnalyticsEvent&& e, bool replayed)
+{
+    std::vector<AnalyticsEvent>& parked = _parked[(int)e.provider()];
+    // replayed events are bounded by the journal size already
+    if (!replayed && parked.size() >= kMaxParked)
+    {
+        _journal.markDone(e.journalPos);
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    parked.push_back(std::move(e));
+}
+
+// worker thread
+void AnalyticsPipeline::deliver(AnalyticsEvent& e)
+{
+    switch (e.type)
+    {
+        case AnalyticsEvent::kFlurryLogEvent:
+            if (e.params.empty() && !e.timed)
+            {
+                sdkbox::PluginFlurryAnalytics::logEvent(e.name);
+            }
+            else if (e.params.empty())
+            {
+                sdkbox::PluginFlurryAnalytics::logEvent(e.name, e.timed);
+            }
+            else
+            {
+                std::map<std::string, std::string> params = e.params.toMap();
+                sdkbox::PluginFlurryAnalytics::logEvent(e.name, params, e.timed);
+            }
+            break;
+        case AnalyticsEvent::kFlurryEndTimedEvent:
+            if (e.params.empty())
+            {
+                sdkbox::PluginFlurryAnalytics::endTimedEvent(e.name);
+            }
+            else
+            {
+                std::map<std::string, std::string> params = e.params.toMap();
+                sdkbox::PluginFlurryAnalytics::endTimedEvent(e.name, params);
+            }
+            break;
+        case AnalyticsEvent::kFlurryEndSession:
+            sdkbox::PluginFlurryAnalytics::endSession();
+            break;
+        case AnalyticsEvent::kGALogEvent:
+            sdkbox::PluginGoogleAnalytics::logEvent(e.nameString(), e.actionString(), e.labelString(), e.value);
+            break;
+        case AnalyticsEvent::kGALogScreen:
+            sdkbox::PluginGoogleAnalytics::logScreen(e.nameString());
+            break;
+        case AnalyticsEvent::kGALogTiming:
+            sdkbox::PluginGoogleAnalytics::logTiming(e.nameString(), e.value, e.actionString(), e.labelString());
+            break;
+        case AnalyticsEvent::kKochavaTrackEvent:
+            sdkbox::PluginKochava::trackEvent(e.name.c_str(), e.action.c_str());
+            break;
+        case AnalyticsEvent::kKochavaSpatialEvent:
+        {
+            const char* x = e.params.get("x");
+            const char* y = e.params.get("y");
+            const char* z = e.params.get("z");
+            sdkbox::PluginKochava::spatialEvent(e.name.c_str(), x ? (float)atof(x) : 0.0f,
+                                                y ? (float)atof(y) : 0.0f, z ? (float)atof(z) : 0.0f);
+            break;
+        }
+        case AnalyticsEvent::kTuneMeasureEventName:
+            sdkbox::PluginTune::measureEventName(e.name);
+            break;
+        case AnalyticsEvent::kTuneMeasureEvent:
+            if (e.tune)
+            {
+                sdkbox::PluginTune::measureEvent(*e.tune);
+            }
+            else
+            {
+                sdkbox::PluginTune::measureEventForScript(e.paramsJson);
+            }
+            break;
+        case AnalyticsEvent::kTuneMeasureEventId:
+            sdkbox::PluginTune::measureEventId(e.value);
+            break;
+        case AnalyticsEvent::kTuneMeasureSession:
+            if (!e.params.empty())
+            {
+                sdkbox::TunePreloadData preload;
+                for (const auto& f : kPreloadFields)
+                {
+                    if (const char* value = e.params.get(f.key, strlen(f.key)))
+                    {
+                        preload.*f.field = value;
+                    }
+                }
+                sdkbox::PluginTune::setPreloadData(preload);
+            }
+            sdkbox::PluginTune::measureSession();
+            break;
+        case AnalyticsEvent::kNone:
+            return;
+    }
+    _journal.markDone(e.journalPos);
+    _delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+// worker thread
+void AnalyticsPipeline::flushCoalesced()
+{
+    _coalescer.flush([this](AnalyticsEvent& summary, const std::vector<uint64_t>& absorbed) {
+        deliver(summary);
+        for (uint64_t pos : absorbed)
+        {
+            _journal.markDone(pos);
+        }
+    });
+}
+
+AnalyticsPipeline::Stats AnalyticsPipeline::getStats() const
+{
+    Stats s;
+    s.queueDepth = 0;
+    for (int c = 0; c < kPriorityCount; c++)
+    {
+        const PriorityClass& pc = _classes[c];
+        ClassStats& cs = s.classes[c];
+        cs.queueDepth = _rings[c].size();
+        cs.queuedBytes = pc.bytes.load(std::memory_order_relaxed);
+        cs.budgetBytes = pc.budget;
+        cs.queued = pc.queued.load(std::memory_order_relaxed);
+        cs.dropped = pc.dropped.load(std::memory_order_relaxed);
+        s.queueDepth += cs.queueDepth;
+    }
+    s.criticalOverflows = _criticalOverflows.load(std::memory_order_relaxed);
+    s.queued = _queued.load(std::memory_order_relaxed);
+    s.delivered = _delivered.load(std::memory_order_relaxed);
+    s.dropped = _dropped.load(std::memory_order_relaxed);
+    s.sampled = _sampled.load(std::memory_order_relaxed);
+    s.coalesced = _coalescer.getCoalescedCount();
+    s.lastFlushMs = _lastFlushUs.load(std::memory_order_relaxed) / 1000.0;
+    s.maxFlushMs = _maxFlushUs.load(std::memory_order_relaxed) / 1000.0;
+    s.lastLatencyMs = _lastLatencyUs.load(std::memory_order_relaxed) / 1000.0;
+    return s;
+}
+
+void AnalyticsPipeline::printStats() const
+{
+    Stats s = getStats();
+    CCLOG("[AnalyticsPipeline] depth %d, queued %llu, delivered %llu, dropped %llu, sampled %llu, coalesced %llu",
+          (int)s.queueDepth, (unsigned long long)s.queued, (unsigned long long)s.delivered,
+          (unsigned long long)s.dropped, (unsigned long long)s.sampled, (unsigned long long)s.coalesced);
+    CCLOG("[AnalyticsPipeline] flush %.2f ms (max %.2f ms), latency %.2f ms",
+          s.lastFlushMs, s.maxFlushMs, s.lastLatencyMs);
+    for (int c = 0; c < kPriorityCount; c++)
+    {
+        const ClassStats& cs = s.classes[c];
+        CCLOG("[AnalyticsPipeline]   %-8s depth %d, %d/%d bytes, queued %llu, dropped %llu",
+              analyticsPriorityName((AnalyticsPriority)c), (int)cs.queueDepth, (int)cs.queuedBytes,
+              (int)cs.budgetBytes, (unsigned long long)cs.queued, (unsigned long long)cs.dropped);
+    }
+    if (s.criticalOverflows)
+    {
+        CCLOG("[AnalyticsPipeline]   critical overflows %llu", (unsigned long long)s.criticalOverflows);
+    }
+    AnalyticsSampler::getInstance()->printStats();
+}
@@ -0,0 +1,272 @@
+//
+//  AnalyticsPipeline.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsPipeline__
+#define __template__AnalyticsPipeline__
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AnalyticsCoalescer.h"
+#include "AnalyticsCodec.h"
+#include "AnalyticsEvent.h"
+#include "AnalyticsJournal.h"
+#include "MpscRing.h"
+
+/**
+ * Asynchronous front end for Flurry, Google Analytics, Kochava and Tune.
+ *
+ * Game code writes into a bounded lock-free ring and returns immediately;
+ * a worker thread wakes up when a batch has accumulated (or every
+ * kFlushIntervalMs) and forwards the events to the SDKs. Events
+ * for a provider that has not finished init are parked on the worker and
+ * replayed once setProviderReady() is called for it.
+ *
+ * Events are queued by priority class, each class in its own ring. The
+ * class decides how soon the worker wakes up and what is dropped under
+ * pressure, not the order: every event is numbered when it is queued, and
+ * the worker delivers what it drained in that order across all classes, so
+ * a session end never overtakes the events logged before it. Every class
+ * but Critical has a memory budget and a policy for when it is over it, the
+ * "priority" block of the "analytics" section of sdkbox_config.json:
+ *
+ *   "priority": {
+ *       "classes": {
+ *           "normal": { "budgetKB": 128, "policy": "drop-oldest" },
+ *           "low": { "budgetKB": 32, "policy": "sample", "sampleEvery": 4 }
+ *       },
+ *       "events": { "purchase": "critical", "ad_shown": "low" }
+ *   }
+ *
+ *   drop-oldest   the new event is queued and the oldest one of the class
+ *                 is discarded at the next drain
+ *   drop-newest   the new event is discarded
+ *   sample        one in sampleEvery new events is queued
+ *
+ * "events" picks the class by event name (the GA action, the Tune event
+ * name); otherwise Tune measureEvent() calls, which carry the revenue, are
+ * Critical, other Tune calls, Kochava events and Flurry session ends High,
+ * GA screens and timings Low, and the rest Normal. A Critical event is
+ * never dropped or sampled: when its ring is full it goes to an unbounded
+ * overflow list. Other classes still drop the newest event when their
+ * ring is full.
+ *
+ * AnalyticsSampler runs first, for all but Critical, and may withhold an
+ * event by configuration; such events are counted as sampled, not dropped.
+ * On the worker, AnalyticsCoalescer can hold repeats of an event and send
+ * them as one. What it holds is sent before a Flurry session end, a Tune
+ * session or a GA screen is delivered.
+ *
+ * Every event is also appended to an AnalyticsJournal in the writable path
+ * and flagged there once delivered, so whatever was still queued when the
+ * process died is replayed on the next launch. Session ends, Tune sessions
+ * and timed Flurry events are not; they only mean something in the run that
+ * logged them.
+ */
+class AnalyticsPipeline
+{
+public:
+    struct ClassStats
+    {
+        size_t queueDepth;
+        // approximate, see footprint()
+        size_t queuedBytes;
+        size_t budgetBytes;
+        uint64_t queued;
+        uint64_t dropped;
+    };
+
+    enum DropPolicy
+    {
+        kDropOldest,
+        kDropNewest,
+        kSample
+    };
+
+    static const int kPriorityCount = (int)AnalyticsPriority::Low + 1;
+
+    struct Stats
+    {
+        size_t queueDepth;
+        uint64_t queued;
+        uint64_t delivered;
+        uint64_t dropped;
+        // sampled out or rate limited, see AnalyticsSampler::getStats()
+        uint64_t sampled;
+        // folded into another event by the coalescer
+        uint64_t coalesced;
+        // wall time of the last batch / slowest batch so far
+        double lastFlushMs;
+        double maxFlushMs;
+        // enqueue to delivery of the oldest event in the last batch
+        double lastLatencyMs;
+        ClassStats classes[kPriorityCount];
+        // Critical events that found their ring full
+        uint64_t criticalOverflows;
+    };
+
+    static AnalyticsPipeline* getInstance();
+
+    // GL thread, before start(): the "coalesce" and "priority" blocks of
+    // the "analytics" section, see AnalyticsCoalescer
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+
+    // spawns the worker, call once before the providers are initialized
+    void start();
+
+    // providers call this at the end of their init, any thread
+    void setProviderReady(SdkPlugin provider);
+
+    // false when the event was dropped
+    bool flurryLogEvent(const std::string& name, bool timed = false);
+    // pass params with std::move to hand the arena over without a copy
+    bool flurryLogEvent(const std::string& name, EventParams params, bool timed = false);
+    bool flurryEndTimedEvent(const std::string& name);
+    bool flurryEndTimedEvent(const std::string& name, EventParams params);
+    bool flurryEndSession();
+
+    // Google Analytics strings are interned, so a repeated category, action
+    // or label is never copied. Hot call sites can intern once up front and
+    // pass the handles, which skips the hash lookup as well.
+    bool gaLogEvent(StringRef category, StringRef action, StringRef label, int value);
+    bool gaLogEvent(InternedString category, InternedString action, InternedString label, int value);
+    bool gaLogScreen(StringRef title);
+    bool gaLogScreen(InternedString title);
+    bool gaLogTiming(StringRef category, int interval, StringRef name, StringRef label);
+    bool gaLogTiming(InternedString category, int interval, InternedString name, InternedString label);
+
+    bool kochavaTrackEvent(const std::string& name, const std::string& value);
+    bool kochavaSpatialEvent(const std::string& title, float x, float y, float z);
+
+    bool tuneMeasureEventName(const std::string& name);
+    bool tuneMeasureEvent(const sdkbox::TuneEvent& event);
+    bool tuneMeasureEventJson(const std::string& eventJson);
+    bool tuneMeasureEventId(int eventId);
+    // measureSession(), after setPreloadData() when preload is given, so
+    // the session keeps its place among the events queued around it
+    bool tuneMeasureSession();
+    bool tuneMeasureSession(const sdkbox::TunePreloadData& preload);
+
+    // any thread, never blocks. Returns false when the event was dropped;
+    // an event the sampler withholds still returns true.
+    bool enqueue(AnalyticsEvent&& event);
+
+    // wake the worker now instead of waiting for a full batch, and have it
+    // send what the coalescer holds and schedule the journal for write-back
+    void flush();
+    // flush() and wait up to budgetMs for the worker to finish it; true if
+    // it did. Blocks, so not on the GL thread.
+    bool flushAndWait(int budgetMs);
+
+    Stats getStats() const;
+    void printStats() const;
+
+private:
+    AnalyticsPipeline();
+
+    // per class
+    static const size_t kCapacity = 256;
+    static const size_t kBatchSize = 32;
+    static const int kFlushIntervalMs = 500;
+    // per provider, while it is still initializing
+    static const size_t kMaxParked = 256;
+    static const uint32_t kJournalSegmentSize = 64 * 1024;
+    static const uint32_t kJournalSegmentCount = 8;
+    static const int kProviderCount = (int)SdkPlugin::Vungle + 1;
+    // producers that can be between numbering an event and pushing it at
+    // once; more wait for a slot
+    static const size_t kInFlightSlots = 16;
+    static const uint64_t kIdleSlot = UINT64_MAX;
+
+    struct PriorityClass
+    {
+        PriorityClass();
+
+        size_t budget;
+        DropPolicy policy;
+        uint32_t sampleEvery;
+
+        std::atomic<size_t> bytes;
+        // drop-oldest requests from producers, served by the worker
+        std::atomic<uint32_t> shed;
+        std::atomic<uint32_t> sampleTick;
+        std::atomic<uint64_t> queued;
+        std::atomic<uint64_t> dropped;
+    };
+
+    AnalyticsPriority classify(const AnalyticsEvent& event) const;
+    static uint32_t footprint(const AnalyticsEvent& event);
+    bool admit(PriorityClass& pc, uint32_t bytes);
+    size_t claimInFlight();
+
+    void workerLoop();
+    void openJournal();
+    void drain();
+    void route(AnalyticsEvent& e, uint32_t ready, std::chrono::steady_clock::time_point now);
+    void park(AnalyticsEvent&& event, bool replayed);
+    void deliver(AnalyticsEvent& event);
+    void flushCoalesced();
+    void wake();
+
+    MpscRing<AnalyticsEvent, kCapacity> _rings[kPriorityCount];
+    PriorityClass _classes[kPriorityCount];
+    // read-only once the worker runs
+    std::unordered_map<std::string, AnalyticsPriority> _priorityByName;
+
+    std::mutex _overflowMutex;
+    std::vector<AnalyticsEvent> _criticalOverflow;
+    std::atomic<uint64_t> _criticalOverflows;
+    // the next AnalyticsEvent::sequence
+    std::atomic<uint64_t> _sequence;
+    // per producer that is numbering and pushing an event: a number no
+    // higher than the one it takes, or kIdleSlot
+    std::atomic<uint64_t> _inFlight[kInFlightSlots];
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _wakeRequested;
+    std::atomic<bool> _wakePending;
+    std::atomic<bool> _syncRequested;
+    // flushAndWait() requests, and the last one the worker finished; _mutex
+    uint64_t _flushRequests;
+    uint64_t _flushesDone;
+    std::condition_variable _flushedCond;
+    std::atomic<bool> _started;
+
+    // opened and replayed on the worker, appends start once it is ready
+    AnalyticsJournal _journal;
+    std::string _journalPath;
+    std::atomic<bool> _journalReady;
+    // strings learned by the records, kept in the journal's header page
+    AnalyticsCodec::Dictionary _learned;
+
+    std::atomic<uint32_t> _readyMask;
+
+    // worker thread only
+    uint32_t _replayedMask;
+    std::vector<AnalyticsEvent> _parked[kProviderCount];
+    // one drain's events in sequence order, reused; what is left after a
+    // drain was numbered after it started and goes out with the next one
+    std::vector<AnalyticsEvent> _batch;
+    AnalyticsCoalescer _coalescer;
+
+    std::atomic<uint64_t> _queued;
+    std::atomic<uint64_t> _delivered;
+    std::atomic<uint64_t> _dropped;
+    std::atomic<uint64_t> _sampled;
+    std::atomic<uint32_t> _lastFlushUs;
+    std::atomic<uint32_t> _maxFlushUs;
+    std::atomic<uint32_t> _lastLatencyUs;
+};
+
+#endif /* defined(__template__AnalyticsPipeline__) */
@@ -0,0 +1,240 @@
+//
+//  AnalyticsRouter.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsRouter.h"
+#include "AnalyticsPipeline.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+class FlurryAdapter : public AnalyticsAdapter
+{
+public:
+    bool send(const AnalyticsRouterEvent& event, const AnalyticsRule&) override
+    {
+        auto analytics = AnalyticsPipeline::getInstance();
+        if (event.params.empty())
+        {
+            return analytics->flurryLogEvent(event.name);
+        }
+        return analytics->flurryLogEvent(event.name, event.params);
+    }
+};
+
+class GoogleAnalyticsAdapter : public AnalyticsAdapter
+{
+public:
+    bool send(const AnalyticsRouterEvent& event, const AnalyticsRule& rule) override
+    {
+        const std::string& category = !event.category.empty() ? event.category
+            : (!rule.category.empty() ? rule.category : event.name);
+        return AnalyticsPipeline::getInstance()->gaLogEvent(category, event.name, event.label, event.value);
+    }
+};
+
+class KochavaAdapter : public AnalyticsAdapter
+{
+public:
+    bool send(const AnalyticsRouterEvent& event, const AnalyticsRule&) override
+    {
+        return AnalyticsPipeline::getInstance()->kochavaTrackEvent(
+            event.name, event.params.empty() ? event.label : event.params.toJson());
+    }
+};
+
+class TuneAdapter : public AnalyticsAdapter
+{
+public:
+    bool send(const AnalyticsRouterEvent& event, const AnalyticsRule&) override
+    {
+        auto analytics = AnalyticsPipeline::getInstance();
+        if (event.revenue == 0)
+        {
+            return analytics->tuneMeasureEventName(event.name);
+        }
+
+        sdkbox::TuneEvent tuneEvent;
+        tuneEvent.eventName = event.name;
+        tuneEvent.revenue = event.revenue;
+        tuneEvent.currencyCode = event.currency;
+        tuneEvent.contentId = event.label;
+        return analytics->tuneMeasureEvent(tuneEvent);
+    }
+};
+
+bool AnalyticsRule::accepts(const std::string& eventName) const
+{
+    if (!enabled || exclude.count(eventName))
+    {
+        return false;
+    }
+    return events.empty() || events.count(eventName) > 0;
+}
+
+static void readNames(const rapidjson::Value& value, std::unordered_set<std::string>& names)
+{
+    if (!value.IsArray())
+    {
+        return;
+    }
+    for (rapidjson::SizeType i = 0; i < value.Size(); i++)
+    {
+        if (value[i].IsString())
+        {
+            names.insert(value[i].GetString());
+        }
+    }
+}
+
+static void readRule(const rapidjson::Value& value, AnalyticsRule& rule)
+{
+    if (!value.IsObject())
+    {
+        return;
+    }
+    if (value.HasMember("enabled") && value["enabled"].IsBool())
+    {
+        rule.enabled = value["enabled"].GetBool();
+    }
+    if (value.HasMember("events"))
+    {
+        readNames(value["events"], rule.events);
+    }
+    if (value.HasMember("exclude"))
+    {
+        readNames(value["exclude"], rule.exclude);
+    }
+    if (value.HasMember("category") && value["category"].IsString())
+    {
+        rule.category = value["category"].GetString();
+    }
+}
+
+AnalyticsRouter::AnalyticsRouter()
+: _enabled(true)
+{
+    _routes[0].provider = SdkPlugin::FlurryAnalytics;
+    _routes[0].adapter.reset(new FlurryAdapter());
+    _routes[1].provider = SdkPlugin::GoogleAnalytics;
+    _routes[1].adapter.reset(new GoogleAnalyticsAdapter());
+    _routes[2].provider = SdkPlugin::Kochava;
+    _routes[2].adapter.reset(new KochavaAdapter());
+    _routes[3].provider = SdkPlugin::Tune;
+    _routes[3].adapter.reset(new TuneAdapter());
+}
+
+AnalyticsRouter* AnalyticsRouter::getInstance()
+{
+    static AnalyticsRouter *instance = 0;
+    if (!instance)
+    {
+        instance = new AnalyticsRouter();
+    }
+    return instance;
+}
+
+void AnalyticsRouter::loadConfig(const std::string& file)
+{
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[AnalyticsRouter] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& analytics = doc["analytics"];
+    if (analytics.HasMember("enabled") && analytics["enabled"].IsBool())
+    {
+        _enabled = analytics["enabled"].GetBool();
+    }
+    if (!analytics.HasMember("providers") || !analytics["providers"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& providers = analytics["providers"];
+    for (int i = 0; i < kRouteCount; i++)
+    {
+        const char* name = sdkPluginName(_routes[i].provider);
+        if (providers.HasMember(name))
+        {
+            readRule(providers[name], _routes[i].rule);
+        }
+    }
+}
+
+int AnalyticsRouter::track(const AnalyticsRouterEvent& event)
+{
+    return track(event, routesFor(event.name));
+}
+
+int AnalyticsRouter::track(const AnalyticsRouterEvent& event, uint32_t routes)
+{
+    int queued = 0;
+    for (int i = 0; i < kRouteCount; i++)
+    {
+        const Route& route = _routes[i];
+        if ((routes & (1u << (int)route.provider)) && route.adapter->send(event, route.rule))
+        {
+            queued++;
+        }
+    }
+    return queued;
+}
+
+uint32_t AnalyticsRouter::routesFor(const std::string& eventName) const
+{
+    if (!_enabled)
+    {
+        return 0;
+    }
+
+    uint32_t routes = 0;
+    for (int i = 0; i < kRouteCount; i++)
+    {
+        if (_routes[i].rule.accepts(eventName))
+        {
+            routes |= 1u << (int)_routes[i].provider;
+        }
+    }
+    return routes;
+}
+
+int AnalyticsRouter::track(const std::string& name, EventParams params)
+{
+    AnalyticsRouterEvent event(name);
+    event.params = std::move(params);
+    return track(event);
+}
+
+const AnalyticsRule& AnalyticsRouter::getRule(SdkPlugin provider) const
+{
+    for (int i = 0; i < kRouteCount; i++)
+    {
+        if (_routes[i].provider == provider)
+        {
+            return _routes[i].rule;
+        }
+    }
+    // not an analytics provider
+    static const AnalyticsRule none = []() {
+        AnalyticsRule rule;
+        rule.enabled = false;
+        return rule;
+    }();
+    return none;
+}
@@ -0,0 +1,124 @@
+//
+//  AnalyticsRouter.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsRouter__
+#define __template__AnalyticsRouter__
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include "EventParams.h"
+#include "PluginEventBus.h"
+
+/**
+ * Per-provider routing rule, the "analytics" section of sdkbox_config.json:
+ *
+ *   "analytics": {
+ *       "providers": {
+ *           "GoogleAnalytics": { "category": "game" },
+ *           "Kochava": { "events": ["purchase"] },
+ *           "Tune": { "exclude": ["ad_shown"] },
+ *           "FlurryAnalytics": { "enabled": false }
+ *       }
+ *   }
+ *
+ * A provider that is not listed gets every event.
+ */
+struct AnalyticsRule
+{
+    AnalyticsRule() : enabled(true) {}
+
+    bool accepts(const std::string& eventName) const;
+
+    bool enabled;
+    // when not empty, only these events are sent
+    std::unordered_set<std::string> events;
+    std::unordered_set<std::string> exclude;
+    // Google Analytics category for events that do not set one
+    std::string category;
+};
+
+/**
+ * One logical analytics event, described once by the game.
+ */
+struct AnalyticsRouterEvent
+{
+    explicit AnalyticsRouterEvent(const std::string& eventName)
+    : name(eventName)
+    , value(0)
+    , revenue(0)
+    {
+    }
+
+    std::string name;
+    // Google Analytics category and label; the label doubles as the
+    // Kochava value when there are no params
+    std::string category;
+    std::string label;
+    int value;
+    // Tune revenue, sent as a TuneEvent when non-zero
+    float revenue;
+    std::string currency;
+    EventParams params;
+};
+
+class AnalyticsAdapter
+{
+public:
+    virtual ~AnalyticsAdapter() {}
+
+    // converts the event for its provider and queues it on AnalyticsPipeline
+    virtual bool send(const AnalyticsRouterEvent& event, const AnalyticsRule& rule) = 0;
+};
+
+/**
+ * Fans one event out to every analytics provider whose rule accepts it.
+ *
+ * Each provider has an adapter that converts the event once and hands it to
+ * AnalyticsPipeline, so batching and the journal apply to routed events as
+ * to direct ones. Rules are read once by loadConfig() on the GL thread and
+ * are immutable afterwards; track() can then be called from any thread.
+ */
+class AnalyticsRouter
+{
+public:
+    static AnalyticsRouter* getInstance();
+
+    // GL thread, before the first track(). Missing file or section keeps
+    // the defaults: every provider gets every event.
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+
+    // returns the number of providers the event was queued for
+    int track(const AnalyticsRouterEvent& event);
+    int track(const std::string& name, EventParams params = EventParams());
+    // only to the providers in routes, a routesFor() mask; skips the rule
+    // lookups for callers that keep the mask, see AnalyticsCatalog
+    int track(const AnalyticsRouterEvent& event, uint32_t routes);
+
+    // bit (1 << SdkPlugin) per provider whose rule accepts the event
+    uint32_t routesFor(const std::string& eventName) const;
+
+    const AnalyticsRule& getRule(SdkPlugin provider) const;
+
+private:
+    AnalyticsRouter();
+
+    struct Route
+    {
+        SdkPlugin provider;
+        AnalyticsRule rule;
+        std::unique_ptr<AnalyticsAdapter> adapter;
+    };
+
+    static const int kRouteCount = 4;
+
+    bool _enabled;
+    Route _routes[kRouteCount];
+};
+
+#endif /* defined(__template__AnalyticsRouter__) */
@@ -0,0 +1,352 @@
+//
+//  AnalyticsSampler.cpp
+//  template
+//
+//
+//
+
+#include "AnalyticsSampler.h"
+#include "AnalyticsPipeline.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+
+static const char* kInstallIdKey = "sdkbox_analytics_install_id";
+
+static int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// murmur3 finalizer, spreads user/rule combinations evenly over 32 bits
+static uint32_t mix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+static void readRate(const rapidjson::Value& value, float& rate, int& perMinute, int& burst)
+{
+    if (value.HasMember("rate") && value["rate"].IsNumber())
+    {
+        rate = std::min(1.0f, std::max(0.0f, (float)value["rate"].GetDouble()));
+    }
+    if (value.HasMember("perMinute") && value["perMinute"].IsInt())
+    {
+        perMinute = std::max(0, value["perMinute"].GetInt());
+    }
+    if (value.HasMember("burst") && value["burst"].IsInt())
+    {
+        burst = std::max(1, value["burst"].GetInt());
+    }
+}
+
+AnalyticsSampler::Rule::Rule()
+: nameHash(0)
+, rate(1)
+, threshold(1ULL << 32)
+, intervalNs(0)
+, burstNs(0)
+, nextNs(0)
+, kept(0)
+, sampledOut(0)
+, rateLimited(0)
+{
+}
+
+void AnalyticsSampler::Rule::configure(float sampleRate, int perMinute, int burst)
+{
+    rate = sampleRate;
+    threshold = (uint64_t)((double)sampleRate * 4294967296.0);
+    if (perMinute > 0)
+    {
+        intervalNs = 60000000000LL / perMinute;
+        // a minute's worth of credit unless told otherwise
+        burstNs = (int64_t)((burst > 0 ? burst : perMinute) - 1) * intervalNs;
+    }
+    else
+    {
+        intervalNs = 0;
+        burstNs = 0;
+    }
+}
+
+AnalyticsSampler::RuleSet::RuleSet()
+: count(0)
+{
+}
+
+AnalyticsSampler::AnalyticsSampler()
+: _userHash(0)
+, _ruleSet(nullptr)
+{
+    _ruleSets.emplace_back(new RuleSet());
+    _ruleSet.store(_ruleSets.back().get(), std::memory_order_release);
+}
+
+AnalyticsSampler* AnalyticsSampler::getInstance()
+{
+    static AnalyticsSampler *instance = 0;
+    if (!instance)
+    {
+        instance = new AnalyticsSampler();
+    }
+    return instance;
+}
+
+void AnalyticsSampler::loadConfig(const std::string& file)
+{
+    auto userDefault = cocos2d::UserDefault::getInstance();
+    std::string installId = userDefault->getStringForKey(kInstallIdKey);
+    if (installId.empty())
+    {
+        uint64_t seed = (uint64_t)std::chrono::system_clock::now().time_since_epoch().count() ^ (uint64_t)nowNs();
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%08x%08x", mix((uint32_t)(seed >> 32)), mix((uint32_t)seed));
+        installId = buf;
+        userDefault->setStringForKey(kInstallIdKey, installId);
+        userDefault->flush();
+    }
+    if (_userHash.load(std::memory_order_relaxed) == 0)
+    {
+        setUserId(installId);
+    }
+
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[AnalyticsSampler] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& analytics = doc["analytics"];
+    if (!analytics.HasMember("sampling") || !analytics["sampling"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& sampling = analytics["sampling"];
+    std::unique_ptr<RuleSet> set(new RuleSet());
+    float rate = 1;
+    int perMinute = 0;
+    int burst = 0;
+    readRate(sampling, rate, perMinute, burst);
+    set->defaultRule.configure(rate, perMinute, burst);
+
+    const rapidjson::Value* events = nullptr;
+    if (sampling.HasMember("events") && sampling["events"].IsArray())
+    {
+        events = &sampling["events"];
+        set->rules.reset(new Rule[events->Size()]);
+    }
+
+    auto strings = StringInterner::getInstance();
+    for (rapidjson::SizeType i = 0; events && i < events->Size(); i++)
+    {
+        const rapidjson::Value& event = (*events)[i];
+        if (!event.IsObject() || !event.HasMember("name") || !event["name"].IsString())
+        {
+            continue;
+        }
+
+        Rule& rule = set->rules[set->count];
+        rule.name = strings->intern(event["name"].GetString());
+        if (!rule.name)
+        {
+            continue;
+        }
+        rule.nameHash = StringInterner::hash(rule.name.str());
+
+        // unset fields fall back to no sampling and no limit, not to the default rule
+        float eventRate = 1;
+        int eventPerMinute = 0;
+        int eventBurst = 0;
+        readRate(event, eventRate, eventPerMinute, eventBurst);
+        rule.configure(eventRate, eventPerMinute, eventBurst);
+        set->count++;
+    }
+
+    // fully built before it is published
+    _ruleSet.store(set.get(), std::memory_order_release);
+    _ruleSets.push_back(std::move(set));
+}
+
+void AnalyticsSampler::setUserId(const std::string& userId)
+{
+    // 0 means "not set yet"
+    _userHash.store(StringInterner::hash(userId) | 1, std::memory_order_relaxed);
+}
+
+AnalyticsSampler::Rule& AnalyticsSampler::ruleFor(RuleSet& set, const AnalyticsEvent& event)
+{
+    if (set.count == 0)
+    {
+        return set.defaultRule;
+    }
+
+    InternedString name = event.internedName;
+    if (!name)
+    {
+        // no insert: names without a rule never reach the table from here
+        name = StringInterner::getInstance()->find(event.name);
+        if (!name)
+        {
+            return set.defaultRule;
+        }
+    }
+    for (size_t i = 0; i < set.count; i++)
+    {
+        if (set.rules[i].name == name)
+        {
+            return set.rules[i];
+        }
+    }
+    return set.defaultRule;
+}
+
+bool AnalyticsSampler::takeToken(Rule& rule)
+{
+    int64_t now = nowNs();
+    int64_t next = rule.nextNs.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        int64_t start = std::max(next, now);
+        if (start - now > rule.burstNs)
+        {
+            return false;
+        }
+        if (rule.nextNs.compare_exchange_weak(next, start + rule.intervalNs, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+}
+
+AnalyticsSampler::Decision AnalyticsSampler::decide(Rule& rule)
+{
+    if (rule.threshold <= 0xffffffffULL
+        && mix(_userHash.load(std::memory_order_relaxed) ^ rule.nameHash) >= rule.threshold)
+    {
+        return kSampledOut;
+    }
+    if (rule.intervalNs > 0 && !takeToken(rule))
+    {
+        return kRateLimited;
+    }
+    return kKeep;
+}
+
+AnalyticsSampler::Decision AnalyticsSampler::decideTimedEnd(const AnalyticsEvent& event)
+{
+    std::lock_guard<std::mutex> lock(_timedMutex);
+    auto it = _droppedTimed.find(event.name);
+    if (it == _droppedTimed.end())
+    {
+        // the start got through, or was never seen by this process
+        return kKeep;
+    }
+    Decision decision = it->second;
+    _droppedTimed.erase(it);
+    return decision;
+}
+
+void AnalyticsSampler::count(Rule& rule, Decision decision)
+{
+    switch (decision)
+    {
+        case kKeep:
+            rule.kept.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case kSampledOut:
+            rule.sampledOut.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case kRateLimited:
+            rule.rateLimited.fetch_add(1, std::memory_order_relaxed);
+            break;
+    }
+}
+
+AnalyticsSampler::Decision AnalyticsSampler::sample(const AnalyticsEvent& event)
+{
+    if (event.type == AnalyticsEvent::kFlurryEndSession || event.type == AnalyticsEvent::kTuneMeasureSession)
+    {
+        return kKeep;
+    }
+
+    Rule& rule = ruleFor(*_ruleSet.load(std::memory_order_acquire), event);
+    Decision decision;
+    if (event.type == AnalyticsEvent::kFlurryEndTimedEvent)
+    {
+        decision = decideTimedEnd(event);
+    }
+    else
+    {
+        decision = decide(rule);
+        if (event.type == AnalyticsEvent::kFlurryLogEvent && event.timed)
+        {
+            // a kept start also clears what an earlier, unended one left
+            std::lock_guard<std::mutex> lock(_timedMutex);
+            if (decision == kKeep)
+            {
+                _droppedTimed.erase(event.name);
+            }
+            else
+            {
+                _droppedTimed[event.name] = decision;
+            }
+        }
+    }
+
+    count(rule, decision);
+    return decision;
+}
+
+std::vector<AnalyticsSampler::RuleStats> AnalyticsSampler::getStats() const
+{
+    const RuleSet& set = *_ruleSet.load(std::memory_order_acquire);
+    std::vector<RuleStats> stats;
+    stats.reserve(set.count + 1);
+    for (size_t i = 0; i <= set.count; i++)
+    {
+        const Rule& rule = i < set.count ? set.rules[i] : set.defaultRule;
+        RuleStats s;
+        if (rule.name)
+        {
+            s.name = rule.name.str();
+        }
+        s.rate = rule.rate;
+        s.kept = rule.kept.load(std::memory_order_relaxed);
+        s.sampledOut = rule.sampledOut.load(std::memory_order_relaxed);
+        s.rateLimited = rule.rateLimited.load(std::memory_order_relaxed);
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void AnalyticsSampler::printStats() const
+{
+    for (const RuleStats& s : getStats())
+    {
+        CCLOG("[AnalyticsSampler] %s: rate %.2f, kept %llu, sampled out %llu, rate limited %llu",
+              s.name.empty() ? "(default)" : s.name.c_str(), s.rate,
+              (unsigned long long)s.kept, (unsigned long long)s.sampledOut, (unsigned long long)s.rateLimited);
+    }
+}
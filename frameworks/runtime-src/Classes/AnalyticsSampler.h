@@ -0,0 +1,136 @@
+//
+//  AnalyticsSampler.h
+//  template
+//
+//
+//
+
+#ifndef __template__AnalyticsSampler__
+#define __template__AnalyticsSampler__
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "StringInterner.h"
+
+struct AnalyticsEvent;
+
+/**
+ * Client-side volume control in front of the providers, the "sampling"
+ * block of the "analytics" section of sdkbox_config.json:
+ *
+ *   "sampling": {
+ *       "rate": 1.0,
+ *       "events": [
+ *           { "name": "Combat", "rate": 0.25, "perMinute": 120, "burst": 20 },
+ *           { "name": "KochavaCustomEvent", "perMinute": 30 }
+ *       ]
+ *   }
+ *
+ * An event is matched by its name: the event name for Flurry, Kochava and
+ * Tune, the category or screen name for Google Analytics. Unlisted events
+ * use the top-level rate and, if given, perMinute/burst.
+ *
+ * "rate" is decided per user: a hash of the user id and the rule name either
+ * keeps every event of that type for this user or none of them, so the
+ * numbers a provider sees stay self-consistent and can be scaled by 1/rate.
+ * "perMinute" and "burst" form a token bucket on top of that.
+ *
+ * loadConfig() builds a new rule set on the GL thread and publishes it with
+ * one atomic store; a published set is never changed or freed, so sample()
+ * can keep using the one it loaded. sample() is lock-free: an acquire load
+ * for the rule set, a relaxed load for the user hash, a compare against the
+ * rule's threshold and, for rate-limited rules, one CAS.
+ *
+ * The end of a timed Flurry event gets the decision its start got: it is
+ * dropped if and only if the start was. Only timed events take a lock.
+ */
+class AnalyticsSampler
+{
+public:
+    enum Decision
+    {
+        kKeep,
+        kSampledOut,
+        kRateLimited
+    };
+
+    struct RuleStats
+    {
+        std::string name;       // empty for the default rule
+        float rate;
+        uint64_t kept;
+        uint64_t sampledOut;
+        uint64_t rateLimited;
+    };
+
+    static AnalyticsSampler* getInstance();
+
+    // GL thread, before AnalyticsPipeline::start(). Also loads or creates
+    // the install id used for sampling until setUserId() is called.
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+
+    // an account id makes sampling stick to the player across devices
+    void setUserId(const std::string& userId);
+
+    // any thread, counts the decision
+    Decision sample(const AnalyticsEvent& event);
+
+    std::vector<RuleStats> getStats() const;
+    void printStats() const;
+
+private:
+    AnalyticsSampler();
+
+    struct Rule
+    {
+        Rule();
+
+        void configure(float sampleRate, int perMinute, int burst);
+
+        InternedString name;
+        uint32_t nameHash;
+        float rate;
+        // keep when the user/rule hash is below this, 2^32 keeps everyone
+        uint64_t threshold;
+        // token bucket as a theoretical arrival time (GCRA): one token every
+        // intervalNs, at most burstNs of credit. intervalNs 0 = no limit.
+        int64_t intervalNs;
+        int64_t burstNs;
+        std::atomic<int64_t> nextNs;
+
+        std::atomic<uint64_t> kept;
+        std::atomic<uint64_t> sampledOut;
+        std::atomic<uint64_t> rateLimited;
+    };
+
+    struct RuleSet
+    {
+        RuleSet();
+
+        Rule defaultRule;
+        std::unique_ptr<Rule[]> rules;
+        size_t count;
+    };
+
+    Rule& ruleFor(RuleSet& set, const AnalyticsEvent& event);
+    bool takeToken(Rule& rule);
+    Decision decide(Rule& rule);
+    Decision decideTimedEnd(const AnalyticsEvent& event);
+    void count(Rule& rule, Decision decision);
+
+    std::atomic<uint32_t> _userHash;
+    std::atomic<RuleSet*> _ruleSet;
+    // every set ever published, sample() may still hold an older one
+    std::vector<std::unique_ptr<RuleSet>> _ruleSets;
+
+    // names of timed events whose start was dropped, and how
+    std::mutex _timedMutex;
+    std::unordered_map<std::string, Decision> _droppedTimed;
+};
+
+#endif /* defined(__template__AnalyticsSampler__) */
@@ -2,6 +2,9 @@
 #include "SimpleAudioEngine.h"
 
 #include "MyPluginsMgr.h"
+#include "MainThreadQueue.h"
+#include "FrameTimeCollector.h"
+#include "SceneLoadTracker.h"
 #include "HelloWorldScene.h"
 
 #if (SDKBOX_STARTER_KIT_TYPE == kSdkboxStarterKitTypeJs)
@@ -48,14 +51,24 @@ bool AppDelegate::applicationDidFinishLaunching()
     //
     director->setDisplayStats(true);
 
+    // plugin listeners post to this queue, it is drained once per frame
+    MainThreadQueue::getInstance()->start();
 
+    // frame pacing per scene, reported on scene change and backgrounding
+    FrameTimeCollector::getInstance()->start();
+    // build and first-frame time of every scene presented through it
+    SceneLoadTracker::getInstance()->start();
+
+    // the script bindings send through the same analytics pipeline
+    MyPluginsMgr::getInstance()->startAnalytics();
     
 #if (SDKBOX_STARTER_KIT_TYPE == kSdkboxStarterKitTypeCpp)
     // init plugins
     MyPluginsMgr::getInstance()->init();
     
     FileUtils::getInstance()->addSearchPath("res");
-    director->runWithScene(HelloWorld::createScene());
+    auto sceneLoad = SceneLoadTracker::getInstance();
+    sceneLoad->runWithScene(sceneLoad->build("HelloWorld", &HelloWorld::createScene));
     
 #elif (SDKBOX_STARTER_KIT_TYPE == kSdkboxStarterKitTypeJs)
     
@@ -92,6 +105,10 @@ void AppDelegate::applicationDidEnterBackground()
     director->getEventDispatcher()->dispatchCustomEvent("game_on_hide");
     SimpleAudioEngine::getInstance()->pauseBackgroundMusic();
     SimpleAudioEngine::getInstance()->pauseAllEffects();    
+
+    // before the plugins flush analytics, so the report goes out with it
+    FrameTimeCollector::getInstance()->pause();
+    MyPluginsMgr::getInstance()->applicationDidEnterBackground();
 }
 
 // this function will be called when the app is active again
@@ -103,5 +120,6 @@ void AppDelegate::applicationWillEnterForeground()
     SimpleAudioEngine::getInstance()->resumeBackgroundMusic();
     SimpleAudioEngine::getInstance()->resumeAllEffects();
     
+    FrameTimeCollector::getInstance()->resume();
     MyPluginsMgr::getInstance()->applicationWillEnterForeground();
 }
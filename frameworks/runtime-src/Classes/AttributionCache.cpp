@@ -0,0 +1,201 @@
+//
+//  AttributionCache.cpp
+//  template
+//
+//
+//
+
+#include "AttributionCache.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+USING_NS_CC;
+
+static const char* kFileName = "kochava_attribution.cache";
+static const char* kMagic = "KATT1\n";
+
+// "<length>:<bytes>"
+static void appendField(std::string& out, const std::string& field)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u:", (unsigned)field.size());
+    out += buf;
+    out += field;
+}
+
+static bool readField(const std::string& in, size_t& pos, std::string& field)
+{
+    size_t colon = in.find(':', pos);
+    if (colon == std::string::npos || colon == pos)
+    {
+        return false;
+    }
+    char* end = nullptr;
+    unsigned long length = strtoul(in.c_str() + pos, &end, 10);
+    if (end != in.c_str() + colon || length > in.size() - colon - 1)
+    {
+        return false;
+    }
+    field.assign(in, colon + 1, length);
+    pos = colon + 1 + length;
+    return true;
+}
+
+static std::string serialize(const AttributionSnapshot& snapshot)
+{
+    std::string out = kMagic;
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lld\n", (long long)snapshot.receivedAtMs);
+    out += buf;
+    for (const auto& kv : snapshot.values)
+    {
+        appendField(out, kv.first);
+        appendField(out, kv.second);
+    }
+    return out;
+}
+
+static bool deserialize(const std::string& in, AttributionSnapshot& snapshot)
+{
+    size_t magicLength = strlen(kMagic);
+    if (in.compare(0, magicLength, kMagic) != 0)
+    {
+        return false;
+    }
+    size_t newline = in.find('\n', magicLength);
+    if (newline == std::string::npos)
+    {
+        return false;
+    }
+    snapshot.receivedAtMs = strtoll(in.c_str() + magicLength, nullptr, 10);
+
+    size_t pos = newline + 1;
+    std::string key;
+    std::string value;
+    while (pos < in.size())
+    {
+        if (!readField(in, pos, key) || !readField(in, pos, value))
+        {
+            return false;
+        }
+        snapshot.values[key] = value;
+    }
+    return true;
+}
+
+const std::string* AttributionSnapshot::get(const std::string& key) const
+{
+    auto it = values.find(key);
+    return it != values.end() ? &it->second : nullptr;
+}
+
+AttributionCache::AttributionCache()
+: _current(nullptr)
+{
+}
+
+AttributionCache* AttributionCache::getInstance()
+{
+    static AttributionCache *instance = 0;
+    if (!instance)
+    {
+        instance = new AttributionCache();
+    }
+    return instance;
+}
+
+void AttributionCache::load()
+{
+    {
+        std::lock_guard<std::mutex> lock(_saveMutex);
+        _path = FileUtils::getInstance()->getWritablePath() + kFileName;
+    }
+
+    FILE* file = fopen(_path.c_str(), "rb");
+    if (!file)
+    {
+        return;
+    }
+    std::string content;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        content.append(buf, n);
+    }
+    fclose(file);
+
+    AttributionSnapshot* snapshot = new AttributionSnapshot();
+    if (!deserialize(content, *snapshot))
+    {
+        CCLOG("[AttributionCache] discarding unreadable %s", _path.c_str());
+        delete snapshot;
+        return;
+    }
+    snapshot->restored = true;
+
+    // the SDK may have been quicker
+    const AttributionSnapshot* expected = nullptr;
+    if (!_current.compare_exchange_strong(expected, snapshot, std::memory_order_acq_rel))
+    {
+        delete snapshot;
+    }
+}
+
+void AttributionCache::publish(const std::map<std::string, std::string>& values)
+{
+    AttributionSnapshot* snapshot = new AttributionSnapshot();
+    snapshot->values = values;
+    snapshot->receivedAtMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    swap(snapshot);
+    CCLOG("[AttributionCache] %u attribution values", (unsigned)values.size());
+
+    std::thread([this, snapshot]() {
+        save(snapshot);
+    }).detach();
+}
+
+void AttributionCache::swap(const AttributionSnapshot* snapshot)
+{
+    const AttributionSnapshot* old = _current.exchange(snapshot, std::memory_order_acq_rel);
+    if (old)
+    {
+        // readers may still hold it
+        std::lock_guard<std::mutex> lock(_mutex);
+        _retired.push_back(old);
+    }
+}
+
+// background thread
+void AttributionCache::save(const AttributionSnapshot* snapshot)
+{
+    std::lock_guard<std::mutex> lock(_saveMutex);
+    // a later publish() has the file now
+    if (_path.empty() || _current.load(std::memory_order_acquire) != snapshot)
+    {
+        return;
+    }
+
+    std::string content = serialize(*snapshot);
+    std::string tmp = _path + ".tmp";
+    FILE* file = fopen(tmp.c_str(), "wb");
+    if (!file)
+    {
+        CCLOG("[AttributionCache] cannot write %s", tmp.c_str());
+        return;
+    }
+    bool ok = fwrite(content.data(), 1, content.size(), file) == content.size();
+    ok = fclose(file) == 0 && ok;
+    // replaces the old file in one step, a crash leaves one or the other
+    if (!ok || rename(tmp.c_str(), _path.c_str()) != 0)
+    {
+        CCLOG("[AttributionCache] cannot write %s", _path.c_str());
+        remove(tmp.c_str());
+    }
+}
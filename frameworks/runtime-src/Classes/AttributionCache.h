@@ -0,0 +1,77 @@
+//
+//  AttributionCache.h
+//  template
+//
+//
+//
+
+#ifndef __template__AttributionCache__
+#define __template__AttributionCache__
+
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Kochava attribution as of one delivery. Never changes once published.
+ */
+struct AttributionSnapshot
+{
+    AttributionSnapshot() : receivedAtMs(0), restored(false) {}
+
+    // nullptr when the key is not there
+    const std::string* get(const std::string& key) const;
+
+    std::map<std::string, std::string> values;
+    // wall clock, ms since 1970, when the SDK delivered it
+    int64_t receivedAtMs;
+    // read from the cache file, not delivered by the SDK this launch
+    bool restored;
+};
+
+/**
+ * The last attribution Kochava delivered, so game code need not poll
+ * PluginKochava::retrieveAttribution().
+ *
+ * publish() builds a new snapshot and swaps it in with one atomic store;
+ * get() is a single atomic load, so any thread can read without locking.
+ * Replaced snapshots are kept, not freed, so a pointer from get() stays
+ * valid for the life of the process; attribution changes a handful of
+ * times per install at most. Each snapshot is also written to the
+ * writable path, off the calling thread, and load() brings it back on the
+ * next launch before the SDK has said anything.
+ */
+class AttributionCache
+{
+public:
+    static AttributionCache* getInstance();
+
+    // GL thread, at startup, before Kochava is initialized
+    void load();
+
+    // the Kochava attribution callback; any thread
+    void publish(const std::map<std::string, std::string>& values);
+
+    // nullptr until there is something, any thread
+    const AttributionSnapshot* get() const { return _current.load(std::memory_order_acquire); }
+
+private:
+    AttributionCache();
+
+    void swap(const AttributionSnapshot* snapshot);
+    void save(const AttributionSnapshot* snapshot);
+
+    std::atomic<const AttributionSnapshot*> _current;
+    // set by load()
+    std::string _path;
+
+    std::mutex _mutex;
+    std::vector<const AttributionSnapshot*> _retired;
+    // serializes writers of the cache file
+    std::mutex _saveMutex;
+};
+
+#endif /* defined(__template__AttributionCache__) */
@@ -0,0 +1,135 @@
+//
+//  DeviceIdentifiers.cpp
+//  template
+//
+//
+
+#include "DeviceIdentifiers.h"
+#include "cocos2d.h"
+
+#include <thread>
+
+#include "Sdkbox/Sdkbox.h"
+#include "PluginAdColony/PluginAdColony.h"
+#include "PluginTune/PluginTune.h"
+
+DeviceIdentifiers::DeviceIdentifiers()
+: _current(nullptr)
+, _started(false)
+, _readyMask(0)
+{
+    _ready = _readyPromise.get_future().share();
+}
+
+DeviceIdentifiers* DeviceIdentifiers::getInstance()
+{
+    static DeviceIdentifiers *instance = 0;
+    if (!instance)
+    {
+        instance = new DeviceIdentifiers();
+    }
+    return instance;
+}
+
+void DeviceIdentifiers::start()
+{
+    if (_started.exchange(true))
+    {
+        return;
+    }
+
+    std::thread([this]() {
+        fetch();
+        _readyPromise.set_value();
+    }).detach();
+}
+
+void DeviceIdentifiers::setProviderReady(SdkPlugin provider)
+{
+    uint32_t bit = 1u << (int)provider;
+    if (_readyMask.fetch_or(bit) & bit)
+    {
+        return;
+    }
+    // before start() the first fetch reads it anyway
+    if (_started.load())
+    {
+        std::thread([this]() {
+            fetch();
+        }).detach();
+    }
+}
+
+void DeviceIdentifiers::refreshIfTrackingChanged()
+{
+    const DeviceIds* ids = get();
+    // the first fetch is still running, it will see the new setting
+    if (!ids)
+    {
+        return;
+    }
+    if (sdkbox::device::isAdvertisingTrackingEnabled() != ids->trackingEnabled)
+    {
+        CCLOG("[DeviceIdentifiers] ad tracking setting changed, fetching again");
+        fetch();
+    }
+}
+
+// background thread
+void DeviceIdentifiers::fetch()
+{
+    std::lock_guard<std::mutex> lock(_fetchMutex);
+
+    DeviceIds* ids = new DeviceIds();
+    const char* advertisingId = sdkbox::device::getAdvertisingIdentifier();
+    ids->advertisingId = advertisingId ? advertisingId : "";
+    ids->trackingEnabled = sdkbox::device::isAdvertisingTrackingEnabled();
+    ids->providers = _readyMask.load();
+    if (ids->providers & (1u << (int)SdkPlugin::AdColony))
+    {
+        ids->adColonyAdvertisingId = sdkbox::PluginAdColony::getAdvertisingIdentifier();
+        ids->adColonyDeviceId = sdkbox::PluginAdColony::getUniqueDeviceID();
+        ids->vendorId = sdkbox::PluginAdColony::getVendorIdentifier();
+    }
+    if (ids->providers & (1u << (int)SdkPlugin::Tune))
+    {
+        ids->matId = sdkbox::PluginTune::matId();
+    }
+
+    const DeviceIds* old = _current.exchange(ids, std::memory_order_acq_rel);
+    if (old)
+    {
+        // readers may still hold it
+        _retired.push_back(old);
+    }
+}
+
+const DeviceIds* DeviceIdentifiers::getFrom(SdkPlugin provider) const
+{
+    const DeviceIds* ids = get();
+    return ids && (ids->providers & (1u << (int)provider)) ? ids : nullptr;
+}
+
+std::string DeviceIdentifiers::adColonyAdvertisingId() const
+{
+    const DeviceIds* ids = getFrom(SdkPlugin::AdColony);
+    return ids ? ids->adColonyAdvertisingId : sdkbox::PluginAdColony::getAdvertisingIdentifier();
+}
+
+std::string DeviceIdentifiers::adColonyDeviceId() const
+{
+    const DeviceIds* ids = getFrom(SdkPlugin::AdColony);
+    return ids ? ids->adColonyDeviceId : sdkbox::PluginAdColony::getUniqueDeviceID();
+}
+
+std::string DeviceIdentifiers::vendorId() const
+{
+    const DeviceIds* ids = getFrom(SdkPlugin::AdColony);
+    return ids ? ids->vendorId : sdkbox::PluginAdColony::getVendorIdentifier();
+}
+
+std::string DeviceIdentifiers::matId() const
+{
+    const DeviceIds* ids = getFrom(SdkPlugin::Tune);
+    return ids ? ids->matId : sdkbox::PluginTune::matId();
+}
@@ -0,0 +1,101 @@
+//
+//  DeviceIdentifiers.h
+//  template
+//
+//
+
+#ifndef __template__DeviceIdentifiers__
+#define __template__DeviceIdentifiers__
+
+#include <stdint.h>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "PluginEventBus.h"
+
+/**
+ * The device and advertising identifiers as of one fetch. Never changes
+ * once published.
+ */
+struct DeviceIds
+{
+    DeviceIds() : trackingEnabled(false), providers(0) {}
+
+    // sdkbox::device
+    std::string advertisingId;
+    bool trackingEnabled;
+    // PluginAdColony
+    std::string adColonyAdvertisingId;
+    std::string adColonyDeviceId;
+    std::string vendorId;
+    // PluginTune::matId()
+    std::string matId;
+    // bit (1 << SdkPlugin) per SDK the ids above were read from; the
+    // others were not initialized yet and are left empty
+    uint32_t providers;
+};
+
+/**
+ * The identifiers the SDKs hand out, fetched once instead of crossing into
+ * JNI/ObjC on every call; on Android the advertising id may even wait on
+ * Google Play Services.
+ *
+ * start() fetches them all on a background thread. get() is a single
+ * atomic load and returns nullptr until that is done; ready() is for code
+ * that would rather wait. refreshIfTrackingChanged() asks the platform for
+ * the tracking setting alone and fetches everything again only when it
+ * differs, as the advertising id is reset or zeroed with it. Replaced
+ * snapshots are kept, not freed, so a pointer from get() stays valid.
+ *
+ * AdColony and Tune ids are only read once setProviderReady() has been
+ * called for them, as the SDKs hand out empty ones before their init; a
+ * provider that becomes ready after a fetch starts another. The accessors
+ * below are for the script bindings: the snapshot's value when it has
+ * one, the SDK's own otherwise.
+ */
+class DeviceIdentifiers
+{
+public:
+    static DeviceIdentifiers* getInstance();
+
+    // GL thread; returns at once
+    void start();
+
+    // AdColony or Tune, right after its init; any thread
+    void setProviderReady(SdkPlugin provider);
+
+    // on foreground, off the GL thread
+    void refreshIfTrackingChanged();
+
+    // nullptr until the first fetch is done, any thread
+    const DeviceIds* get() const { return _current.load(std::memory_order_acquire); }
+
+    // becomes ready with the first fetch
+    std::shared_future<void> ready() const { return _ready; }
+
+    std::string adColonyAdvertisingId() const;
+    std::string adColonyDeviceId() const;
+    std::string vendorId() const;
+    std::string matId() const;
+
+private:
+    DeviceIdentifiers();
+
+    void fetch();
+    // the current snapshot, if it has the provider's ids
+    const DeviceIds* getFrom(SdkPlugin provider) const;
+
+    std::atomic<const DeviceIds*> _current;
+    std::atomic<bool> _started;
+    std::atomic<uint32_t> _readyMask;
+    std::promise<void> _readyPromise;
+    std::shared_future<void> _ready;
+
+    // one fetch at a time
+    std::mutex _fetchMutex;
+    std::vector<const DeviceIds*> _retired;
+};
+
+#endif /* defined(__template__DeviceIdentifiers__) */
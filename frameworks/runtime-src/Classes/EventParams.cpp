@@ -0,0 +1,305 @@
+//
+//  EventParams.cpp
+//  template
+//
+//
+//
+
+#include "EventParams.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <tuple>
+
+static const uint32_t kMinArenaCapacity = 64;
+
+// same order as std::string::compare
+static int compareKey(const char* a, size_t aLength, const char* b, size_t bLength)
+{
+    int r = memcmp(a, b, std::min(aLength, bLength));
+    if (r != 0)
+    {
+        return r;
+    }
+    return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+}
+
+EventParams::EventParams()
+: _entries(_inline)
+, _count(0)
+, _capacity(kInlineEntries)
+, _arena(nullptr)
+, _used(0)
+, _arenaCapacity(0)
+{
+}
+
+EventParams::EventParams(std::initializer_list<std::pair<const char*, const char*>> entries)
+: EventParams()
+{
+    size_t bytes = 0;
+    for (const auto& kv : entries)
+    {
+        bytes += strlen(kv.first) + strlen(kv.second);
+    }
+    reserve(entries.size(), bytes);
+
+    for (const auto& kv : entries)
+    {
+        set(kv.first, kv.second);
+    }
+}
+
+EventParams::EventParams(const EventParams& other)
+: EventParams()
+{
+    if (other._count > kInlineEntries)
+    {
+        growEntries(other._count);
+    }
+    memcpy(_entries, other._entries, other._count * sizeof(Entry));
+    _count = other._count;
+
+    if (other._used > 0)
+    {
+        growArena(other._used);
+        memcpy(_arena, other._arena, other._used);
+        _used = other._used;
+    }
+}
+
+EventParams::EventParams(EventParams&& other)
+: EventParams()
+{
+    swap(other);
+}
+
+EventParams::~EventParams()
+{
+    if (!isInline())
+    {
+        free(_entries);
+    }
+    free(_arena);
+}
+
+EventParams& EventParams::operator=(EventParams other)
+{
+    swap(other);
+    return *this;
+}
+
+void EventParams::swap(EventParams& other)
+{
+    bool inlineHere = isInline();
+    bool inlineThere = other.isInline();
+    Entry* here = _entries;
+    Entry* there = other._entries;
+
+    std::swap(_inline, other._inline);
+    _entries = inlineThere ? _inline : there;
+    other._entries = inlineHere ? other._inline : here;
+
+    std::swap(_count, other._count);
+    std::swap(_capacity, other._capacity);
+    std::swap(_arena, other._arena);
+    std::swap(_used, other._used);
+    std::swap(_arenaCapacity, other._arenaCapacity);
+}
+
+void EventParams::reserve(size_t count, size_t bytes)
+{
+    growEntries(count);
+    // each key and value is NUL-terminated
+    growArena(bytes + count * 2);
+}
+
+void EventParams::clear()
+{
+    // keeps both buffers for reuse
+    _count = 0;
+    _used = 0;
+}
+
+size_t EventParams::lowerBound(const char* key, size_t keyLength) const
+{
+    size_t lo = 0;
+    size_t hi = _count;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        const Entry& e = _entries[mid];
+        if (compareKey(_arena + e.keyOffset, e.keyLength, key, keyLength) < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void EventParams::set(const char* key, size_t keyLength, const char* value, size_t valueLength)
+{
+    size_t i = lowerBound(key, keyLength);
+    if (i < _count && compareKey(keyAt(i), _entries[i].keyLength, key, keyLength) == 0)
+    {
+        // the old value stays in the arena until clear()
+        _entries[i].valueOffset = store(value, valueLength);
+        _entries[i].valueLength = (uint32_t)valueLength;
+        return;
+    }
+
+    growArena(keyLength + valueLength + 2);
+    growEntries(_count + 1);
+
+    Entry e;
+    e.keyOffset = store(key, keyLength);
+    e.keyLength = (uint32_t)keyLength;
+    e.valueOffset = store(value, valueLength);
+    e.valueLength = (uint32_t)valueLength;
+
+    memmove(_entries + i + 1, _entries + i, (_count - i) * sizeof(Entry));
+    _entries[i] = e;
+    _count++;
+}
+
+void EventParams::set(const char* key, const char* value)
+{
+    set(key, strlen(key), value, strlen(value));
+}
+
+void EventParams::set(const std::string& key, const std::string& value)
+{
+    set(key.data(), key.size(), value.data(), value.size());
+}
+
+const char* EventParams::get(const char* key, size_t keyLength) const
+{
+    size_t i = lowerBound(key, keyLength);
+    if (i < _count && compareKey(keyAt(i), _entries[i].keyLength, key, keyLength) == 0)
+    {
+        return valueAt(i);
+    }
+    return nullptr;
+}
+
+const char* EventParams::get(const std::string& key) const
+{
+    return get(key.data(), key.size());
+}
+
+std::map<std::string, std::string> EventParams::toMap() const
+{
+    std::map<std::string, std::string> map;
+    for (size_t i = 0; i < _count; i++)
+    {
+        // already sorted, every insert lands at the end
+        map.emplace_hint(map.end(),
+                         std::piecewise_construct,
+                         std::forward_as_tuple(keyAt(i), keyLengthAt(i)),
+                         std::forward_as_tuple(valueAt(i), valueLengthAt(i)));
+    }
+    return map;
+}
+
+static void appendJsonString(std::string& out, const char* s, size_t length)
+{
+    out += '"';
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = s[i];
+        switch (c)
+        {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                }
+                else
+                {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+std::string EventParams::toJson() const
+{
+    std::string json = "{";
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (i > 0)
+        {
+            json += ',';
+        }
+        appendJsonString(json, keyAt(i), keyLengthAt(i));
+        json += ':';
+        appendJsonString(json, valueAt(i), valueLengthAt(i));
+    }
+    json += '}';
+    return json;
+}
+
+uint32_t EventParams::store(const char* data, size_t length)
+{
+    growArena(length + 1);
+    uint32_t offset = _used;
+    memcpy(_arena + offset, data, length);
+    _arena[offset + length] = '\0';
+    _used += (uint32_t)(length + 1);
+    return offset;
+}
+
+void EventParams::growArena(size_t needed)
+{
+    if (_used + needed <= _arenaCapacity)
+    {
+        return;
+    }
+
+    size_t capacity = std::max<size_t>(std::max<size_t>(_arenaCapacity * 2, kMinArenaCapacity), _used + needed);
+    // entries hold offsets, so moving the block is fine
+    char* arena = static_cast<char*>(realloc(_arena, capacity));
+    if (!arena)
+    {
+        // what operator new does when built without exceptions
+        abort();
+    }
+    _arena = arena;
+    _arenaCapacity = (uint32_t)capacity;
+}
+
+void EventParams::growEntries(size_t needed)
+{
+    if (needed <= _capacity)
+    {
+        return;
+    }
+
+    size_t capacity = std::max(_capacity * 2, needed);
+    Entry* entries = static_cast<Entry*>(malloc(capacity * sizeof(Entry)));
+    if (!entries)
+    {
+        abort();
+    }
+    memcpy(entries, _entries, _count * sizeof(Entry));
+    if (!isInline())
+    {
+        free(_entries);
+    }
+    _entries = entries;
+    _capacity = capacity;
+}
@@ -0,0 +1,96 @@
+//
+//  EventParams.h
+//  template
+//
+//
+//
+
+#ifndef __template__EventParams__
+#define __template__EventParams__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+
+/**
+ * String key/value parameters of one analytics event.
+ *
+ * Entries are kept sorted by key in a small inline vector, and all key and
+ * value bytes live in a single arena owned by the event, so an event with up
+ * to kInlineEntries parameters costs one allocation however it is built.
+ * Keys and values are NUL-terminated in the arena. Setting an existing key
+ * replaces its value, like std::map::operator[].
+ */
+class EventParams
+{
+public:
+    static const size_t kInlineEntries = 8;
+
+    EventParams();
+    // sizes the arena exactly, e.g. EventParams{{"level", "3"}, {"mode", "hard"}}
+    EventParams(std::initializer_list<std::pair<const char*, const char*>> entries);
+    EventParams(const EventParams& other);
+    EventParams(EventParams&& other);
+    ~EventParams();
+
+    EventParams& operator=(EventParams other);
+    void swap(EventParams& other);
+
+    // optional, lets callers that know the totals get away with one allocation
+    void reserve(size_t count, size_t bytes);
+
+    void set(const char* key, size_t keyLength, const char* value, size_t valueLength);
+    void set(const char* key, const char* value);
+    void set(const std::string& key, const std::string& value);
+
+    // nullptr when the key is not set
+    const char* get(const char* key, size_t keyLength) const;
+    const char* get(const std::string& key) const;
+
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+    void clear();
+
+    // in key order
+    const char* keyAt(size_t i) const { return _arena + _entries[i].keyOffset; }
+    uint32_t keyLengthAt(size_t i) const { return _entries[i].keyLength; }
+    const char* valueAt(size_t i) const { return _arena + _entries[i].valueOffset; }
+    uint32_t valueLengthAt(size_t i) const { return _entries[i].valueLength; }
+
+    // allocated outside the object, for memory accounting
+    size_t heapBytes() const { return (isInline() ? 0 : _capacity * sizeof(Entry)) + _arenaCapacity; }
+
+    // the SDKs take std::map; only built where the call is actually made
+    std::map<std::string, std::string> toMap() const;
+    // a flat JSON object of strings, for the SDK calls that take JSON
+    std::string toJson() const;
+
+private:
+    struct Entry
+    {
+        uint32_t keyOffset;
+        uint32_t keyLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+    };
+
+    size_t lowerBound(const char* key, size_t keyLength) const;
+    uint32_t store(const char* data, size_t length);
+    void growArena(size_t needed);
+    void growEntries(size_t needed);
+    bool isInline() const { return _entries == _inline; }
+
+    Entry* _entries;
+    size_t _count;
+    size_t _capacity;
+    Entry _inline[kInlineEntries];
+
+    char* _arena;
+    uint32_t _used;
+    uint32_t _arenaCapacity;
+};
+
+#endif /* defined(__template__EventParams__) */
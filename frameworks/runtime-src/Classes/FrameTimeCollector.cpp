@@ -0,0 +1,153 @@
+//
+//  FrameTimeCollector.cpp
+//  template
+//
+//
+//
+
+#include "FrameTimeCollector.h"
+#include "AnalyticsPipeline.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+
+USING_NS_CC;
+
+static void setMs(EventParams& params, const char* key, int64_t us)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%.1f", us / 1000.0);
+    params.set(key, buf);
+}
+
+static void setNumber(EventParams& params, const char* key, uint64_t value)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value);
+    params.set(key, buf);
+}
+
+static int toMs(int64_t us)
+{
+    return (int)((us + 500) / 1000);
+}
+
+FrameTimeCollector::FrameTimeCollector()
+: _listener(nullptr)
+, _janky(0)
+, _jankyThresholdUs(0)
+, _scene(nullptr)
+, _hasLast(false)
+{
+}
+
+FrameTimeCollector* FrameTimeCollector::getInstance()
+{
+    static FrameTimeCollector *instance = 0;
+    if (!instance)
+    {
+        instance = new FrameTimeCollector();
+    }
+    return instance;
+}
+
+void FrameTimeCollector::start()
+{
+    if (_listener)
+    {
+        return;
+    }
+
+    _listener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        onAfterDraw();
+    });
+}
+
+void FrameTimeCollector::pause()
+{
+    report();
+    _hasLast = false;
+}
+
+void FrameTimeCollector::resume()
+{
+    _hasLast = false;
+}
+
+// GL thread, once per frame
+void FrameTimeCollector::onAfterDraw()
+{
+    auto now = std::chrono::steady_clock::now();
+    Scene* scene = Director::getInstance()->getRunningScene();
+    if (scene != _scene || (scene && scene->getName() != _sceneName))
+    {
+        switchScene(scene);
+        _last = now;
+        _hasLast = true;
+        return;
+    }
+
+    if (_hasLast)
+    {
+        int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(now - _last).count();
+        _frames.record(us);
+        if (us > _jankyThresholdUs)
+        {
+            _janky++;
+        }
+    }
+    _last = now;
+    _hasLast = true;
+}
+
+void FrameTimeCollector::switchScene(Scene* scene)
+{
+    report();
+
+    _scene = scene;
+    _sceneName = scene ? scene->getName() : std::string();
+    // read per scene, a game may lower the frame rate for a menu
+    _jankyThresholdUs = (int64_t)(Director::getInstance()->getAnimationInterval() * 1.5 * 1000000);
+}
+
+void FrameTimeCollector::report()
+{
+    uint32_t janky = _janky;
+    _janky = 0;
+    MetricHistogram::Summary s = _frames.takeSummary();
+    if (!_scene || s.count < kMinFrames)
+    {
+        return;
+    }
+
+    static InternedString category = StringInterner::getInstance()->intern("frame_time");
+    static InternedString jankyAction = StringInterner::getInstance()->intern("janky");
+    static InternedString p50 = StringInterner::getInstance()->intern("p50");
+    static InternedString p95 = StringInterner::getInstance()->intern("p95");
+    static InternedString p99 = StringInterner::getInstance()->intern("p99");
+
+    std::string name = _sceneName.empty() ? "Scene" : _sceneName;
+    InternedString scene = StringInterner::getInstance()->intern(name);
+
+    auto analytics = AnalyticsPipeline::getInstance();
+    if (scene)
+    {
+        analytics->gaLogTiming(category, toMs(s.p50), scene, p50);
+        analytics->gaLogTiming(category, toMs(s.p95), scene, p95);
+        analytics->gaLogTiming(category, toMs(s.p99), scene, p99);
+        analytics->gaLogEvent(category, jankyAction, scene, (int)janky);
+    }
+
+    EventParams params;
+    params.set("scene", name);
+    setNumber(params, "frames", s.count);
+    setMs(params, "p50", s.p50);
+    setMs(params, "p95", s.p95);
+    setMs(params, "p99", s.p99);
+    setMs(params, "max", s.max);
+    setNumber(params, "janky", janky);
+    analytics->flurryLogEvent("frame_time", std::move(params));
+
+    CCLOG("[FrameTimeCollector] %s: %llu frames, p50 %.1fms p95 %.1fms p99 %.1fms, %u janky",
+          name.c_str(), (unsigned long long)s.count, s.p50 / 1000.0, s.p95 / 1000.0, s.p99 / 1000.0, janky);
+}
@@ -0,0 +1,81 @@
+//
+//  FrameTimeCollector.h
+//  template
+//
+//
+//
+
+#ifndef __template__FrameTimeCollector__
+#define __template__FrameTimeCollector__
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include "Metrics.h"
+
+namespace cocos2d
+{
+    class EventListenerCustom;
+    class Scene;
+}
+
+/**
+ * Field data on frame pacing, per scene.
+ *
+ * The time between two Director::EVENT_AFTER_DRAW events is recorded into
+ * a MetricHistogram, in microseconds. When the running scene changes, or
+ * the app goes to the background, the frames of the scene so far are
+ * reported through AnalyticsPipeline and the histogram starts over:
+ *
+ *   GA       logTiming("frame_time", ms, <scene>, "p50"/"p95"/"p99") and
+ *            logEvent("frame_time", "janky", <scene>, <janky frames>)
+ *   Flurry   "frame_time" with scene, frames, p50, p95, p99, max (ms with
+ *            one decimal) and janky
+ *
+ * A frame is janky when it took over 1.5 animation intervals, so at least
+ * one vsync was missed. Scenes are told apart by Node::getName(), unnamed
+ * ones are reported as "Scene". The frame a scene is switched in is not
+ * recorded, it holds the load of the new scene rather than its pacing.
+ *
+ * The per-frame cost is a clock read, a pointer compare and the histogram
+ * record, all on the GL thread.
+ */
+class FrameTimeCollector
+{
+public:
+    static FrameTimeCollector* getInstance();
+
+    // GL thread, once the Director exists
+    void start();
+
+    // GL thread; pause() reports the current scene and stops the clock
+    // until resume(), so the time in the background is not a frame
+    void pause();
+    void resume();
+
+private:
+    FrameTimeCollector();
+
+    // below this many frames a scene is not reported, its percentiles
+    // would say nothing
+    static const uint64_t kMinFrames = 30;
+
+    void onAfterDraw();
+    void switchScene(cocos2d::Scene* scene);
+    void report();
+
+    cocos2d::EventListenerCustom* _listener;
+    MetricHistogram _frames;
+    uint32_t _janky;
+    int64_t _jankyThresholdUs;
+
+    // compared by address, and by name in case a new scene reuses the
+    // address of the one before it; never dereferenced once replaced
+    cocos2d::Scene* _scene;
+    std::string _sceneName;
+
+    std::chrono::steady_clock::time_point _last;
+    bool _hasLast;
+};
+
+#endif /* defined(__template__FrameTimeCollector__) */
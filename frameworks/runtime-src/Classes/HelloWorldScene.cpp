@@ -12,6 +12,8 @@ Scene* HelloWorld::createScene()
 {
     // 'scene' is an autorelease object
     auto scene = Scene::create();
+    // reported by FrameTimeCollector under this name
+    scene->setName("HelloWorld");
     
     // 'layer' is an autorelease object
     auto layer = HelloWorld::create();
@@ -51,10 +53,10 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("video", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventAdColony1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventAdColony1);
        });
        auto *item1 = MenuItemFont::create("v4vc", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventAdColony2);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventAdColony2);
        });
 
        
@@ -81,11 +83,11 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("default", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventChartboost1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventChartboost1);
        });
 
        auto *item1 = MenuItemFont::create("Level-Complete", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventChartboost2);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventChartboost2);
        });
 
        
@@ -112,7 +114,7 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("test", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventFA1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventFA1);
        });
        
        
@@ -139,7 +141,7 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("test", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventGA1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventGA1);
        });
        
        
@@ -166,7 +168,7 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("purchase", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventIAP1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventIAP1);
        });
        
        auto *menu = CCMenu::create(name, item, nullptr);
@@ -192,7 +194,7 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("test", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventKochava1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventKochava1);
        });
        
        
@@ -219,7 +221,7 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("test", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventTune1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventTune1);
        });
        
        
@@ -246,11 +248,11 @@ bool HelloWorld::init()
        name->setAnchorPoint(cocos2d::Point(0,0.5));
        
        auto *item = MenuItemFont::create("ad1", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventVungle1);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventVungle1);
        });
 
        auto *item1 = MenuItemFont::create("ad2", [](Ref*){
-           Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventVungle2);
+           MenuEventRouter::getInstance()->dispatch(kMenuEventVungle2);
        });
        
        auto *menu = CCMenu::create(name, item, item1, nullptr);
@@ -298,11 +300,11 @@ bool HelloWorld::init()
 //        name->setAnchorPoint(cocos2d::Point(0,0.5));
 //        
 //        auto *item = MenuItemFont::create("check", [](Ref*){
-//            Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventAgeCheg1);
+//            MenuEventRouter::getInstance()->dispatch(kMenuEventAgeCheg1);
 //        });
 //        
 //        auto *item2 = MenuItemFont::create("associateData", [](Ref*){
-//            Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(kMenuEventAgeCheg2);
+//            MenuEventRouter::getInstance()->dispatch(kMenuEventAgeCheg2);
 //        });
 //        
 //        auto menu = Menu::create(name, item, item2, nullptr);
@@ -325,13 +327,13 @@ bool HelloWorld::init()
 
 void HelloWorld::onButton1Click(Ref *sender)
 {
-    getEventDispatcher()->dispatchCustomEvent(kMenuEvent1);
+    MenuEventRouter::getInstance()->dispatch(kMenuEvent1);
     
     CCLOG("Button1 Click");
 }
 
 void HelloWorld::onButton2Click(Ref *sender)
 {
-    getEventDispatcher()->dispatchCustomEvent(kMenuEvent2);
+    MenuEventRouter::getInstance()->dispatch(kMenuEvent2);
     CCLOG("Button2 Click");
 }
\ No newline at end of file
@@ -0,0 +1,165 @@
+//
+//  LocationSink.cpp
+//  template
+//
+//
+//
+
+#include "LocationSink.h"
+#include "Metrics.h"
+#include "UserProfile.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+#include <algorithm>
+#include <cmath>
+
+USING_NS_CC;
+
+static const double kEarthRadiusMeters = 6371008.8;
+static const double kDegreesToRadians = 3.14159265358979323846 / 180.0;
+
+static const double kDefaultMinDistanceMeters = 100;
+static const double kDefaultMinIntervalSec = 60;
+
+LocationSink::LocationSink()
+: _minDistanceMeters(kDefaultMinDistanceMeters)
+, _minIntervalSec(kDefaultMinIntervalSec)
+, _hasLast(false)
+, _lastLatitude(0)
+, _lastLongitude(0)
+{
+    _stats.received = 0;
+    _stats.forwarded = 0;
+    _stats.suppressed = 0;
+    _stats.invalid = 0;
+}
+
+LocationSink* LocationSink::getInstance()
+{
+    static LocationSink *instance = 0;
+    if (!instance)
+    {
+        instance = new LocationSink();
+    }
+    return instance;
+}
+
+void LocationSink::loadConfig(const std::string& file)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[LocationSink] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& analytics = doc["analytics"];
+    if (!analytics.HasMember("location") || !analytics["location"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& location = analytics["location"];
+    double minDistanceMeters = kDefaultMinDistanceMeters;
+    double minIntervalSec = kDefaultMinIntervalSec;
+    if (location.HasMember("minDistanceMeters") && location["minDistanceMeters"].IsNumber())
+    {
+        minDistanceMeters = location["minDistanceMeters"].GetDouble();
+    }
+    if (location.HasMember("minIntervalSec") && location["minIntervalSec"].IsNumber())
+    {
+        minIntervalSec = location["minIntervalSec"].GetDouble();
+    }
+    setThresholds(minDistanceMeters, minIntervalSec);
+}
+
+void LocationSink::setThresholds(double minDistanceMeters, double minIntervalSec)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _minDistanceMeters = std::max(0.0, minDistanceMeters);
+    _minIntervalSec = std::max(0.0, minIntervalSec);
+}
+
+double LocationSink::distanceMeters(double latitude1, double longitude1, double latitude2, double longitude2)
+{
+    double phi1 = latitude1 * kDegreesToRadians;
+    double phi2 = latitude2 * kDegreesToRadians;
+    double dPhi = phi2 - phi1;
+    double dLambda = (longitude2 - longitude1) * kDegreesToRadians;
+
+    double s = std::sin(dPhi / 2);
+    double t = std::sin(dLambda / 2);
+    double h = s * s + std::cos(phi1) * std::cos(phi2) * t * t;
+    // rounding can push h just past 1 for antipodal points
+    return 2 * kEarthRadiusMeters * std::asin(std::sqrt(std::min(1.0, h)));
+}
+
+bool LocationSink::update(double latitude, double longitude, double altitude,
+                          float horizontalAccuracy, float verticalAccuracy)
+{
+    static MetricCounter* received = Metrics::getInstance()->counter("location_received");
+    static MetricCounter* forwarded = Metrics::getInstance()->counter("location_forwarded");
+    static MetricCounter* suppressed = Metrics::getInstance()->counter("location_suppressed");
+
+    received->add();
+    Clock::time_point now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.received++;
+
+        // NaN fails both comparisons
+        if (!(std::fabs(latitude) <= 90) || !(std::fabs(longitude) <= 180))
+        {
+            _stats.invalid++;
+            return false;
+        }
+
+        if (_hasLast)
+        {
+            double elapsedSec = std::chrono::duration<double>(now - _lastTime).count();
+            if (elapsedSec < _minIntervalSec
+                || distanceMeters(_lastLatitude, _lastLongitude, latitude, longitude) < _minDistanceMeters)
+            {
+                _stats.suppressed++;
+                suppressed->add();
+                return false;
+            }
+        }
+
+        _hasLast = true;
+        _lastLatitude = latitude;
+        _lastLongitude = longitude;
+        _lastTime = now;
+        _stats.forwarded++;
+    }
+
+    forwarded->add();
+    UserProfile::getInstance()->setLocation(latitude, longitude, altitude, horizontalAccuracy, verticalAccuracy);
+    return true;
+}
+
+void LocationSink::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _hasLast = false;
+    }
+    UserProfile::getInstance()->clearLocation();
+}
+
+LocationSink::Stats LocationSink::getStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
@@ -0,0 +1,77 @@
+//
+//  LocationSink.h
+//  template
+//
+//
+//
+
+#ifndef __template__LocationSink__
+#define __template__LocationSink__
+
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+/**
+ * Where location fixes go, instead of PluginTune::setLatitude() and
+ * PluginFlurryAnalytics::setLatitude().
+ *
+ * A fix is forwarded when it is at least minDistanceMeters (haversine) from
+ * the last one forwarded and at least minIntervalSec after it; the first
+ * fix of the process, or after clear(), always is. Anything else is
+ * suppressed. Forwarded fixes go to
+ * UserProfile, which hands the same fix to Tune and Flurry on its
+ * background thread once they are up.
+ *
+ * Thresholds come from the "location" block of the "analytics" section of
+ * sdkbox_config.json. Counts are in getStats() and in the Metrics counters
+ * location_received, location_forwarded and location_suppressed.
+ *
+ * Any thread.
+ */
+class LocationSink
+{
+public:
+    struct Stats
+    {
+        uint64_t received;
+        uint64_t forwarded;
+        uint64_t suppressed;
+        // out of range or NaN, dropped
+        uint64_t invalid;
+    };
+
+    static LocationSink* getInstance();
+
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+    void setThresholds(double minDistanceMeters, double minIntervalSec);
+
+    // true if forwarded
+    bool update(double latitude, double longitude, double altitude = 0,
+                float horizontalAccuracy = 0, float verticalAccuracy = 0);
+    // forgets the last fix, here and in UserProfile; the next one is
+    // forwarded however close and soon it is
+    void clear();
+
+    Stats getStats();
+
+    // great-circle distance on a spherical Earth
+    static double distanceMeters(double latitude1, double longitude1, double latitude2, double longitude2);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    LocationSink();
+
+    std::mutex _mutex;
+    double _minDistanceMeters;
+    double _minIntervalSec;
+    bool _hasLast;
+    double _lastLatitude;
+    double _lastLongitude;
+    Clock::time_point _lastTime;
+    Stats _stats;
+};
+
+#endif /* defined(__template__LocationSink__) */
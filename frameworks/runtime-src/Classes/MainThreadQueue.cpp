@@ -0,0 +1,87 @@
+//
+//  MainThreadQueue.cpp
+//  template
+//
+//
+//
+
+#include "MainThreadQueue.h"
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+MainThreadQueue::MainThreadQueue()
+: _overflows(0)
+, _overflowing(false)
+, _started(false)
+{
+}
+
+MainThreadQueue* MainThreadQueue::getInstance()
+{
+    static MainThreadQueue *instance = 0;
+    if (!instance)
+    {
+        instance = new MainThreadQueue();
+    }
+    return instance;
+}
+
+void MainThreadQueue::start()
+{
+    if (_started)
+    {
+        return;
+    }
+    _started = true;
+
+    Director::getInstance()->getScheduler()->schedule([this](float) {
+        drain();
+    }, this, 0, false, "MainThreadQueue");
+}
+
+void MainThreadQueue::post(Task&& task)
+{
+    // once a task has overflowed, later ones queue behind it
+    if (!_overflowing.load(std::memory_order_acquire) && _ring.push(std::move(task)))
+    {
+        return;
+    }
+
+    unsigned n = _overflows.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0)
+    {
+        CCLOG("[MainThreadQueue] ring full, queueing to the overflow list");
+    }
+    std::lock_guard<std::mutex> lock(_overflowMutex);
+    _overflow.push_back(std::move(task));
+    _overflowing.store(true, std::memory_order_release);
+}
+
+// GL thread, once per frame
+void MainThreadQueue::drain()
+{
+    size_t n = _ring.size();
+    Task task;
+    while (n-- > 0 && _ring.pop(task))
+    {
+        task();
+        task = nullptr;
+    }
+
+    // the overflow list was posted after everything in the ring
+    if (!_overflowing.load(std::memory_order_acquire) || _ring.size() > 0)
+    {
+        return;
+    }
+    std::vector<Task> overflow;
+    {
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        overflow.swap(_overflow);
+        _overflowing.store(false, std::memory_order_release);
+    }
+    for (auto& t : overflow)
+    {
+        t();
+    }
+}
@@ -0,0 +1,71 @@
+//
+//  MainThreadQueue.h
+//  template
+//
+//
+//
+
+#ifndef __template__MainThreadQueue__
+#define __template__MainThreadQueue__
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "MpscRing.h"
+#include "SmallFunction.h"
+
+/**
+ * Hands plugin callbacks over to the GL thread.
+ *
+ * SDK listeners fire on whatever thread the vendor SDK uses. post() is
+ * lock-free from any thread; the queue is drained once per frame from the
+ * Director's scheduler, in post order. Only the tasks already queued when
+ * a drain starts run in that frame, so a task posting more work cannot
+ * stall the frame.
+ *
+ * The ring cells and the task storage are preallocated, so post() itself
+ * does not allocate, but whatever the task captures is the caller's: a
+ * std::string copied into the capture (zone ids, JSON payloads) is still
+ * allocated when it is longer than the small string buffer.
+ *
+ * If the ring is ever full the task goes to a locked overflow list, which
+ * does allocate, and is counted as an overflow. Until that list is drained
+ * every post goes there too, and it only runs once the ring is empty, so
+ * post order holds across the two.
+ */
+class MainThreadQueue
+{
+public:
+    // large enough for a listener capturing a Product plus a message
+    typedef SmallFunction<void(), 256> Task;
+
+    static MainThreadQueue* getInstance();
+
+    // GL thread, once the Director exists. Tasks posted before start() wait
+    // for the first drain.
+    void start();
+
+    // any thread
+    void post(Task&& task);
+
+    size_t getPendingCount() const { return _ring.size(); }
+    unsigned getOverflowCount() const { return _overflows.load(std::memory_order_relaxed); }
+
+private:
+    MainThreadQueue();
+
+    void drain();
+
+    static const size_t kCapacity = 256;
+
+    MpscRing<Task, kCapacity> _ring;
+    std::atomic<unsigned> _overflows;
+
+    // set while _overflow holds tasks
+    std::atomic<bool> _overflowing;
+    std::mutex _overflowMutex;
+    std::vector<Task> _overflow;
+    bool _started;
+};
+
+#endif /* defined(__template__MainThreadQueue__) */
@@ -0,0 +1,127 @@
+//
+//  MenuEvent.cpp
+//  template
+//
+//
+//
+
+#include "MenuEvent.h"
+#include "cocos2d.h"
+
+constexpr bool menuEventIdsUnique(const MenuEventId* ids, size_t n, size_t i = 0, size_t j = 1)
+{
+    return i >= n ? true
+         : j >= n ? menuEventIdsUnique(ids, n, i + 1, i + 2)
+         : (ids[i] != ids[j] && menuEventIdsUnique(ids, n, i, j + 1));
+}
+
+#define MENU_EVENT_ID(var, name) var,
+static constexpr MenuEventId s_menuEventIds[] = { MENU_EVENT_LIST(MENU_EVENT_ID) };
+#undef MENU_EVENT_ID
+
+static_assert(menuEventIdsUnique(s_menuEventIds, sizeof(s_menuEventIds) / sizeof(s_menuEventIds[0])),
+              "menu event names hash to the same id, rename one of them");
+
+MenuEventRouter::MenuEventRouter()
+{
+    for (int i = 0; i < kCapacity; i++)
+    {
+        _slots[i].id = 0;
+        _slots[i].used = false;
+    }
+}
+
+MenuEventRouter* MenuEventRouter::getInstance()
+{
+    static MenuEventRouter *instance = 0;
+    if (!instance)
+    {
+        instance = new MenuEventRouter();
+    }
+    return instance;
+}
+
+// slot holding id, or the free slot where it would go, -1 when full
+int MenuEventRouter::find(MenuEventId id) const
+{
+    for (int n = 0; n < kCapacity; n++)
+    {
+        int i = (id + n) & (kCapacity - 1);
+        if (!_slots[i].used || _slots[i].id == id)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void MenuEventRouter::addListener(MenuEventId id, const Handler& handler)
+{
+    int i = find(id);
+    if (i < 0)
+    {
+        CCLOG("[MenuEvent] router full, %s dropped", getName(id));
+        return;
+    }
+    _slots[i].id = id;
+    _slots[i].used = true;
+    _slots[i].handler = handler;
+}
+
+void MenuEventRouter::removeListener(MenuEventId id)
+{
+    int i = find(id);
+    if (i < 0 || !_slots[i].used)
+    {
+        return;
+    }
+    _slots[i].handler = nullptr;
+
+    // backward shift deletion keeps every probe chain intact
+    int hole = i;
+    for (int n = 1; n < kCapacity; n++)
+    {
+        int j = (i + n) & (kCapacity - 1);
+        if (!_slots[j].used)
+        {
+            break;
+        }
+        int home = _slots[j].id & (kCapacity - 1);
+        if (((j - home) & (kCapacity - 1)) >= ((j - hole) & (kCapacity - 1)))
+        {
+            _slots[hole].id = _slots[j].id;
+            _slots[hole].handler.swap(_slots[j].handler);
+            hole = j;
+        }
+    }
+    _slots[hole].used = false;
+    _slots[hole].id = 0;
+    _slots[hole].handler = nullptr;
+}
+
+void MenuEventRouter::dispatch(MenuEventId id) const
+{
+    int i = find(id);
+    if (i < 0 || !_slots[i].used)
+    {
+        CCLOG("[MenuEvent] no listener for %s", getName(id));
+        return;
+    }
+    _slots[i].handler();
+}
+
+const char* MenuEventRouter::getName(MenuEventId id)
+{
+#if COCOS2D_DEBUG > 0
+#define MENU_EVENT_NAME(var, name) case var: return name;
+    switch (id)
+    {
+        MENU_EVENT_LIST(MENU_EVENT_NAME)
+        default: break;
+    }
+#undef MENU_EVENT_NAME
+#else
+    (void)id;
+#endif
+    return "<event>";
+}
@@ -0,0 +1,85 @@
+//
+//  MenuEvent.h
+//  template
+//
+//
+//
+
+#ifndef __template__MenuEvent__
+#define __template__MenuEvent__
+
+#include <stdint.h>
+#include <functional>
+
+typedef uint32_t MenuEventId;
+
+// FNV-1a, evaluated by the compiler for every id below
+constexpr MenuEventId menuEventHash(const char* s, MenuEventId h = 2166136261u)
+{
+    return *s ? menuEventHash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+#define MENU_EVENT_LIST(X) \
+    X(kMenuEvent1,           "b1") \
+    X(kMenuEvent2,           "b2") \
+    X(kMenuEventAdColony1,   "adcolony1") \
+    X(kMenuEventAdColony2,   "adcolony2") \
+    X(kMenuEventChartboost1, "chartboost1") \
+    X(kMenuEventChartboost2, "chartboost2") \
+    X(kMenuEventFA1,         "fa1") \
+    X(kMenuEventGA1,         "ga1") \
+    X(kMenuEventIAP1,        "iap1") \
+    X(kMenuEventKochava1,    "kochava1") \
+    X(kMenuEventTune1,       "tune1") \
+    X(kMenuEventVungle1,     "vungle1") \
+    X(kMenuEventVungle2,     "vungle2") \
+    X(kMenuEventAgeCheg1,    "agecheg1") \
+    X(kMenuEventAgeCheg2,    "agecheg2")
+
+// integral constants, no storage and no static initializer per TU
+#define MENU_EVENT_DECLARE(var, name) constexpr MenuEventId var = menuEventHash(name);
+MENU_EVENT_LIST(MENU_EVENT_DECLARE)
+#undef MENU_EVENT_DECLARE
+
+/**
+ * Routes menu events from HelloWorld to the MyPluginsMgr handlers.
+ *
+ * Handlers live in a fixed open-addressed table keyed by the event id, so
+ * dispatch is a masked index plus a short probe: no string hashing, no
+ * EventCustom and no allocation.
+ */
+class MenuEventRouter
+{
+public:
+    typedef std::function<void()> Handler;
+
+    static MenuEventRouter* getInstance();
+
+    // one handler per event, a second call replaces the first
+    void addListener(MenuEventId id, const Handler& handler);
+    void removeListener(MenuEventId id);
+
+    // GL thread only
+    void dispatch(MenuEventId id) const;
+
+    // event name for logging, only kept in debug builds
+    static const char* getName(MenuEventId id);
+
+private:
+    MenuEventRouter();
+
+    static const int kCapacity = 32;
+
+    struct Slot
+    {
+        MenuEventId id;
+        bool used;
+        Handler handler;
+    };
+
+    int find(MenuEventId id) const;
+
+    Slot _slots[kCapacity];
+};
+
+#endif /* defined(__template__MenuEvent__) */
@@ -0,0 +1,237 @@
+//
+//  Metrics.cpp
+//  template
+//
+//
+//
+
+#include "Metrics.h"
+#include "AnalyticsPipeline.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+USING_NS_CC;
+
+// Flurry drops params past this many
+static const size_t kMaxFlurryParams = 10;
+
+static void setNumber(EventParams& params, const char* key, int64_t value)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%lld", (long long)value);
+    params.set(key, buf);
+}
+
+MetricHistogram::MetricHistogram()
+: _count(0)
+, _sum(0)
+, _max(0)
+{
+    for (int i = 0; i < kBucketCount; i++)
+    {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int MetricHistogram::bucketFor(uint64_t value)
+{
+    if (value < (uint64_t)kSubBuckets)
+    {
+        return (int)value;
+    }
+    value = std::min<uint64_t>(value, (1ULL << kMaxValueBits) - 1);
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + (int)((value >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t MetricHistogram::bucketValue(int bucket)
+{
+    if (bucket < kSubBuckets)
+    {
+        return bucket;
+    }
+    int shift = bucket / kSubBuckets - 1;
+    uint64_t lower = (uint64_t)(kSubBuckets + bucket % kSubBuckets) << shift;
+    return lower + ((1ULL << shift) >> 1);
+}
+
+void MetricHistogram::record(int64_t value)
+{
+    if (value < 0)
+    {
+        value = 0;
+    }
+    _buckets[bucketFor((uint64_t)value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    int64_t max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+MetricHistogram::Summary MetricHistogram::takeSummary()
+{
+    Summary s;
+    s.count = 0;
+    s.sum = _sum.exchange(0, std::memory_order_relaxed);
+    s.max = _max.exchange(0, std::memory_order_relaxed);
+    _count.store(0, std::memory_order_relaxed);
+
+    uint32_t counts[kBucketCount];
+    for (int i = 0; i < kBucketCount; i++)
+    {
+        counts[i] = _buckets[i].exchange(0, std::memory_order_relaxed);
+        s.count += counts[i];
+    }
+
+    s.p50 = s.p90 = s.p95 = s.p99 = 0;
+    if (s.count == 0)
+    {
+        return s;
+    }
+
+    const double quantiles[] = { 0.50, 0.90, 0.95, 0.99 };
+    int64_t* results[] = { &s.p50, &s.p90, &s.p95, &s.p99 };
+    const int n = sizeof(quantiles) / sizeof(quantiles[0]);
+    uint64_t seen = 0;
+    int q = 0;
+    for (int i = 0; i < kBucketCount && q < n; i++)
+    {
+        seen += counts[i];
+        while (q < n && seen >= (uint64_t)(quantiles[q] * s.count + 0.5) && seen > 0)
+        {
+            // a bucket midpoint can be above the largest sample in it
+            *results[q] = std::min<int64_t>((int64_t)bucketValue(i), s.max);
+            q++;
+        }
+    }
+    return s;
+}
+
+Metrics::Metrics()
+: _started(false)
+{
+}
+
+Metrics* Metrics::getInstance()
+{
+    static Metrics *instance = 0;
+    if (!instance)
+    {
+        instance = new Metrics();
+    }
+    return instance;
+}
+
+void Metrics::start(float intervalSec)
+{
+    if (_started)
+    {
+        return;
+    }
+    _started = true;
+
+    Director::getInstance()->getScheduler()->schedule([this](float) {
+        flush();
+    }, this, intervalSec, false, "Metrics");
+}
+
+MetricCounter* Metrics::counter(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_ptr<MetricCounter>& metric = _counters[name];
+    if (!metric)
+    {
+        metric.reset(new MetricCounter());
+    }
+    return metric.get();
+}
+
+MetricGauge* Metrics::gauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_ptr<MetricGauge>& metric = _gauges[name];
+    if (!metric)
+    {
+        metric.reset(new MetricGauge());
+    }
+    return metric.get();
+}
+
+MetricHistogram* Metrics::histogram(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_ptr<MetricHistogram>& metric = _histograms[name];
+    if (!metric)
+    {
+        metric.reset(new MetricHistogram());
+    }
+    return metric.get();
+}
+
+void Metrics::flush()
+{
+    auto analytics = AnalyticsPipeline::getInstance();
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& kv : _histograms)
+    {
+        MetricHistogram::Summary s = kv.second->takeSummary();
+        if (s.count == 0)
+        {
+            continue;
+        }
+
+        EventParams params;
+        setNumber(params, "count", (int64_t)s.count);
+        setNumber(params, "p50", s.p50);
+        setNumber(params, "p90", s.p90);
+        setNumber(params, "p99", s.p99);
+        setNumber(params, "max", s.max);
+        analytics->flurryLogEvent(kv.first, std::move(params));
+
+        analytics->gaLogTiming("metrics", (int)s.p50, kv.first, "p50");
+        analytics->gaLogTiming("metrics", (int)s.p90, kv.first, "p90");
+        analytics->gaLogTiming("metrics", (int)s.p99, kv.first, "p99");
+        analytics->gaLogTiming("metrics", (int)s.max, kv.first, "max");
+    }
+
+    EventParams params;
+    auto send = [&]() {
+        if (!params.empty())
+        {
+            analytics->flurryLogEvent("metrics", std::move(params));
+            params = EventParams();
+        }
+    };
+    for (auto& kv : _counters)
+    {
+        int64_t delta = kv.second->_value.exchange(0, std::memory_order_relaxed);
+        if (delta != 0)
+        {
+            setNumber(params, kv.first.c_str(), delta);
+            if (params.size() == kMaxFlurryParams)
+            {
+                send();
+            }
+        }
+    }
+    for (auto& kv : _gauges)
+    {
+        if (!kv.second->_dirty.exchange(false, std::memory_order_acquire))
+        {
+            continue;
+        }
+        setNumber(params, kv.first.c_str(), kv.second->get());
+        if (params.size() == kMaxFlurryParams)
+        {
+            send();
+        }
+    }
+    send();
+}
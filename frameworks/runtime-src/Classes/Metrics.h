@@ -0,0 +1,153 @@
+//
+//  Metrics.h
+//  template
+//
+//
+//
+
+#ifndef __template__Metrics__
+#define __template__Metrics__
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Monotonic count, reported as the increase since the previous flush.
+ */
+class MetricCounter
+{
+public:
+    MetricCounter() : _value(0) {}
+
+    void add(int64_t delta = 1) { _value.fetch_add(delta, std::memory_order_relaxed); }
+
+private:
+    friend class Metrics;
+    std::atomic<int64_t> _value;
+};
+
+/**
+ * Last value wins, reported on the next flush after it is set; a gauge
+ * nobody set since the previous flush is not sent again.
+ */
+class MetricGauge
+{
+public:
+    MetricGauge() : _value(0), _dirty(false) {}
+
+    void set(int64_t value)
+    {
+        _value.store(value, std::memory_order_relaxed);
+        _dirty.store(true, std::memory_order_release);
+    }
+    int64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    friend class Metrics;
+    std::atomic<int64_t> _value;
+    std::atomic<bool> _dirty;
+};
+
+/**
+ * Distribution of non-negative integer samples (ms, us, bytes...).
+ *
+ * Buckets are log-linear like an HDR histogram: values below 16 get a bucket
+ * each, above that every power of two is split into 16 buckets, so a
+ * percentile is off by at most 1/32 of its value. Values are clamped to
+ * 2^40. record() is three relaxed atomic adds and a max update, and never
+ * allocates.
+ */
+class MetricHistogram
+{
+public:
+    static const int kSubBucketBits = 4;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kMaxValueBits = 40;
+    static const int kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+    struct Summary
+    {
+        uint64_t count;
+        int64_t sum;
+        int64_t p50;
+        int64_t p90;
+        int64_t p95;
+        int64_t p99;
+        int64_t max;
+    };
+
+    MetricHistogram();
+
+    void record(int64_t value);
+
+    // the midpoint of the bucket a value falls in
+    static int bucketFor(uint64_t value);
+    static uint64_t bucketValue(int bucket);
+
+    // resets what it reads; a sample recorded meanwhile lands in this
+    // summary or the next one, never in neither
+    Summary takeSummary();
+
+private:
+
+    std::atomic<uint32_t> _buckets[kBucketCount];
+    std::atomic<uint64_t> _count;
+    std::atomic<int64_t> _sum;
+    std::atomic<int64_t> _max;
+};
+
+/**
+ * Registry of named counters, gauges and histograms, flushed periodically
+ * into a handful of analytics events through AnalyticsPipeline:
+ *
+ *   Flurry   one event per histogram, named after it, with count, p50,
+ *            p90, p99 and max params; counters and gauges go out together
+ *            as "metrics" events, at most 10 params each
+ *   GA       logTiming("metrics", value, <histogram>, "p50"/"p90"/"p99"/"max")
+ *
+ * Look a metric up once and keep the pointer, it stays valid for the life
+ * of the process:
+ *
+ *   static MetricHistogram* loadTime = Metrics::getInstance()->histogram("scene_load_ms");
+ *   loadTime->record(ms);
+ *
+ * The by-name calls are for the script bindings and take a lock.
+ */
+class Metrics
+{
+public:
+    static const int kDefaultFlushIntervalSec = 60;
+
+    static Metrics* getInstance();
+
+    // GL thread, schedules the periodic flush; started at launch for every
+    // starter kit type, the script bindings use it too
+    void start(float intervalSec = kDefaultFlushIntervalSec);
+
+    // any thread; the same name always returns the same object
+    MetricCounter* counter(const std::string& name);
+    MetricGauge* gauge(const std::string& name);
+    MetricHistogram* histogram(const std::string& name);
+
+    void increment(const std::string& name, int64_t delta = 1) { counter(name)->add(delta); }
+    void setGauge(const std::string& name, int64_t value) { gauge(name)->set(value); }
+    void record(const std::string& name, int64_t value) { histogram(name)->record(value); }
+
+    // any thread, also called by the periodic flush
+    void flush();
+
+private:
+    Metrics();
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::unique_ptr<MetricCounter>> _counters;
+    std::unordered_map<std::string, std::unique_ptr<MetricGauge>> _gauges;
+    std::unordered_map<std::string, std::unique_ptr<MetricHistogram>> _histograms;
+    bool _started;
+};
+
+#endif /* defined(__template__Metrics__) */
@@ -0,0 +1,128 @@
+//
+//  MpscRing.h
+//  template
+//
+//
+//
+
+#ifndef __template__MpscRing__
+#define __template__MpscRing__
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <utility>
+
+/**
+ * Bounded lock-free queue, any number of producers and a single consumer.
+ *
+ * Every cell carries a sequence number telling producers and the consumer
+ * whose turn it is, so a push is one CAS on the tail plus a store into the
+ * cell, and a pop never contends with producers at all. Cells are
+ * preallocated; push() returns false instead of blocking when the ring is
+ * full.
+ *
+ * Capacity must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class MpscRing
+{
+public:
+    MpscRing()
+    : _tail(0)
+    , _head(0)
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // any thread
+    bool push(T&& value)
+    {
+        size_t pos = _tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &_cells[pos & (Capacity - 1)];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the consumer has not released this cell yet
+                return false;
+            }
+            else
+            {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& value)
+    {
+        T copy(value);
+        return push(std::move(copy));
+    }
+
+    // consumer thread only
+    bool pop(T& out)
+    {
+        size_t pos = _head.load(std::memory_order_relaxed);
+        Cell* cell = &_cells[pos & (Capacity - 1)];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+        {
+            return false;
+        }
+
+        out = std::move(cell->value);
+        cell->value = T();
+        cell->seq.store(pos + Capacity, std::memory_order_release);
+        _head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // approximate when producers are running
+    size_t size() const
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    static size_t capacity() { return Capacity; }
+
+private:
+    static const size_t kCacheLine = 64;
+
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    Cell _cells[Capacity];
+
+    // producers and the consumer write different lines
+    char _pad0[kCacheLine];
+    std::atomic<size_t> _tail;
+    char _pad1[kCacheLine - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> _head;
+    char _pad2[kCacheLine - sizeof(std::atomic<size_t>)];
+};
+
+#endif /* defined(__template__MpscRing__) */
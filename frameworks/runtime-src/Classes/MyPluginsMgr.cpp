@@ -6,6 +6,21 @@
 //
 
 #include "MyPluginsMgr.h"
+#include "PluginEventBus.h"
+#include "MainThreadQueue.h"
+#include "AnalyticsCatalog.h"
+#include "AnalyticsPipeline.h"
+#include "AnalyticsRouter.h"
+#include "AnalyticsSampler.h"
+#include "AttributionCache.h"
+#include "DeviceIdentifiers.h"
+#include "LocationSink.h"
+#include "Metrics.h"
+#include "ScopedAnalyticsTimer.h"
+#include "SceneLoadTracker.h"
+#include "SessionManager.h"
+#include "SpatialAggregator.h"
+#include "UserProfile.h"
 #include "cocos2d.h"
 
 #include "PluginAdColony/PluginAdColony.h"
@@ -36,6 +51,10 @@ public:
         if(success)
         {
             CCLOG("AdColony reward zone: %s, reward: %d %s ", info.zoneID.c_str(), amount, currencyName.c_str());
+            std::string zoneID = info.zoneID;
+            MainThreadQueue::getInstance()->post([=]() {
+                PluginEventBus::getInstance()->rewardGranted.emit(SdkPlugin::AdColony, zoneID, currencyName, amount);
+            });
         }
         else
         {
@@ -51,6 +70,10 @@ public:
         if (info.shown)
         {
             CCLOG("AdColony Ad shown");
+            std::string zoneID = info.zoneID;
+            MainThreadQueue::getInstance()->post([=]() {
+                PluginEventBus::getInstance()->adShown.emit(SdkPlugin::AdColony, zoneID);
+            });
         }
         else
         {
@@ -64,11 +87,8 @@ void MyPluginsMgr::initAdColony()
     PluginAdColony::init();
     PluginAdColony::setListener(new ADListener);
     PluginAdColony::getStatus("video");
-    PluginAdColony::setCustomID("test");
-
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventAdColony1, [](EventCustom *) { PluginAdColony::show("video"); });
-    eventDispatcher->addCustomEventListener(kMenuEventAdColony2, [](EventCustom *) { PluginAdColony::show("v4vc"); });
+    UserProfile::getInstance()->setProviderReady(SdkPlugin::AdColony);
+    DeviceIdentifiers::getInstance()->setProviderReady(SdkPlugin::AdColony);
 }
 
 
@@ -93,6 +113,9 @@ public:
     void onChartboostDisplay(const std::string& name)
     {
         CCLOG("Chartboost ad: %s display", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            PluginEventBus::getInstance()->adShown.emit(SdkPlugin::Chartboost, name);
+        });
     }
     void onChartboostDismiss(const std::string& name)
     {
@@ -109,6 +132,9 @@ public:
     void onChartboostReward(const std::string& name, int reward)
     {
         CCLOG("Chartboost ad: %s reward: %d", name.c_str(), reward);
+        MainThreadQueue::getInstance()->post([=]() {
+            PluginEventBus::getInstance()->rewardGranted.emit(SdkPlugin::Chartboost, name, std::string(), reward);
+        });
     }
     void onChartboostFailedToLoad(const std::string& name, sdkbox::CB_LoadError e)
     {
@@ -134,14 +160,7 @@ void MyPluginsMgr::initCharBoost()
 {
     sdkbox::PluginChartboost::init();
     sdkbox::PluginChartboost::setListener(new CBListener);
-
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventChartboost1, [](EventCustom *) {
-        sdkbox::PluginChartboost::show(sdkbox::CB_Location_Default);
-    });
-    eventDispatcher->addCustomEventListener(kMenuEventChartboost2, [](EventCustom *) {
-        sdkbox::PluginChartboost::show("Level Complete");
-    });
+    UserProfile::getInstance()->setProviderReady(SdkPlugin::Chartboost);
 }
 
 
@@ -174,25 +193,21 @@ static bool flurryAnalyticsSendData() {
     params.insert(std::make_pair("key2", "value2"));
     sdkbox::PluginFlurryAnalytics::addOrigin(origin, originVersion, params);
 
+    auto analytics = AnalyticsPipeline::getInstance();
+
     ret = "test event1";
-    sdkbox::PluginFlurryAnalytics::logEvent(ret);
+    analytics->flurryLogEvent(ret);
 
-    ret = "test event2";
-    params.clear();
-    params.insert(std::make_pair("eKey1", "eVal1"));
-    params.insert(std::make_pair("eKey2", "eVal2"));
-    sdkbox::PluginFlurryAnalytics::logEvent(ret, params);
+    AnalyticsCatalog::emit(AnalyticsCatalog::FlurryTest{ "eVal1", "eVal2" });
 
     ret = "test event3";
-    sdkbox::PluginFlurryAnalytics::logEvent(ret, true);
-    sdkbox::PluginFlurryAnalytics::endTimedEvent(ret);
+    analytics->flurryLogEvent(ret, true);
+    analytics->flurryEndTimedEvent(ret);
 
     ret = "test event4";
-    params.clear();
-    params.insert(std::make_pair("eKey3", "eVal3"));
-    params.insert(std::make_pair("eKey4", "eVal4"));
-    sdkbox::PluginFlurryAnalytics::logEvent(ret, params, true);
-    sdkbox::PluginFlurryAnalytics::endTimedEvent(ret, params);
+    EventParams eventParams{{"eKey3", "eVal3"}, {"eKey4", "eVal4"}};
+    analytics->flurryLogEvent(ret, eventParams, true);
+    analytics->flurryEndTimedEvent(ret, std::move(eventParams));
 
     ret = "error test";
     std::string msg = "log errror msg";
@@ -201,19 +216,13 @@ static bool flurryAnalyticsSendData() {
 
     sdkbox::PluginFlurryAnalytics::logPageView();
 
-    ret = "this is user id";
-    sdkbox::PluginFlurryAnalytics::setUserID(ret);
-    sdkbox::PluginFlurryAnalytics::setAge(11);
-    ret = "m"; // m:male  f:female  u:unkonw
-    sdkbox::PluginFlurryAnalytics::setGender(ret);
-
     sdkbox::PluginFlurryAnalytics::pauseBackgroundSession();
 
     sdkbox::PluginFlurryAnalytics::setReportLocation(true);
 
-    sdkbox::PluginFlurryAnalytics::clearLocation();
-    //chendu, sichuan, china
-    sdkbox::PluginFlurryAnalytics::setLatitude(104.06, 30.67, 0, 0);
+    //chendu, sichuan, china; replaces the fix from the profile, for Tune as well
+    LocationSink::getInstance()->clear();
+    LocationSink::getInstance()->update(30.67, 104.06);
 
     sdkbox::PluginFlurryAnalytics::setSessionReportsOnCloseEnabled(true);
     sdkbox::PluginFlurryAnalytics::setSessionReportsOnPauseEnabled(true);
@@ -222,7 +231,8 @@ static bool flurryAnalyticsSendData() {
     sdkbox::PluginFlurryAnalytics::setEventLoggingEnabled(true);
     sdkbox::PluginFlurryAnalytics::setPulseEnabled(true);
 
-    sdkbox::PluginFlurryAnalytics::endSession();
+    // queued behind the events above so none of them is cut off
+    analytics->flurryEndSession();
 
     CCLOG("Flurry analytics send data finish");
 
@@ -239,6 +249,10 @@ public:
             CCLOG("Item %s : %s", item.first.c_str(), item.second.c_str());
         }
         CCLOG("MAP INFO END");
+
+        MainThreadQueue::getInstance()->post([]() {
+            PluginEventBus::getInstance()->sessionStarted.emit(SdkPlugin::FlurryAnalytics);
+        });
     }
 };
 
@@ -262,12 +276,9 @@ void MyPluginsMgr::initFlurry()
     //start session
     sdkbox::PluginFlurryAnalytics::startSession();
 
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventFA1, [](EventCustom *) {
-        CCLOG("[Flurry Analytics] sending data");
-
-        flurryAnalyticsSendData();
-    });
+    AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
+    SessionManager::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
+    UserProfile::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
 }
 
 /**
@@ -278,21 +289,32 @@ void MyPluginsMgr::initGoogleAnalytics()
 {
     PluginGoogleAnalytics::init();
 
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventGA1, [](EventCustom *) {
-        CCLOG("[GoogleAnalytics] sending data");
-
-        PluginGoogleAnalytics::logTiming("Startup", 0, "timing name", "timing label");
-        PluginGoogleAnalytics::logEvent("EventCategory 1", "EventAction 1", "EventLabel 1", 10);
-        PluginGoogleAnalytics::logScreen("Screen1");
-        PluginGoogleAnalytics::logEvent("Read", "Press", "Button1", 10);
-        PluginGoogleAnalytics::logEvent("Read", "Press", "Button2", 20);
-        PluginGoogleAnalytics::logEvent("Dispose", "Release", "Button22", 20);
-        PluginGoogleAnalytics::logScreen("Screen2");
-        PluginGoogleAnalytics::logSocial("twitter", "retweet", "retweet esto fu.");
-        PluginGoogleAnalytics::logException("Algo se ha roto", false);
-        PluginGoogleAnalytics::dispatchPeriodically(60);
-    });
+    AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::GoogleAnalytics);
+    SessionManager::getInstance()->setProviderReady(SdkPlugin::GoogleAnalytics);
+}
+
+static void googleAnalyticsSendData()
+{
+    auto analytics = AnalyticsPipeline::getInstance();
+    analytics->gaLogEvent("EventCategory 1", "EventAction 1", "EventLabel 1", 10);
+    analytics->gaLogScreen("Screen1");
+
+    // strings sent on every button press are interned once and passed as handles
+    auto strings = StringInterner::getInstance();
+    static const InternedString read = strings->intern("Read");
+    static const InternedString press = strings->intern("Press");
+    static const InternedString dispose = strings->intern("Dispose");
+    static const InternedString release = strings->intern("Release");
+    static const InternedString button1 = strings->intern("Button1");
+    static const InternedString button2 = strings->intern("Button2");
+    static const InternedString button22 = strings->intern("Button22");
+    analytics->gaLogEvent(read, press, button1, 10);
+    analytics->gaLogEvent(read, press, button2, 20);
+    analytics->gaLogEvent(dispose, release, button22, 20);
+    analytics->gaLogScreen("Screen2");
+    PluginGoogleAnalytics::logSocial("twitter", "retweet", "retweet esto fu.");
+    PluginGoogleAnalytics::logException("Algo se ha roto", false);
+    PluginGoogleAnalytics::dispatchPeriodically(60);
 }
 
 /**
@@ -342,6 +364,9 @@ private:
 
     virtual void onSuccess(sdkbox::Product const& p) override
     {
+        MainThreadQueue::getInstance()->post([=]() {
+            PluginEventBus::getInstance()->purchaseSucceeded.emit(p);
+        });
     }
 
     virtual void onFailure(sdkbox::Product const& p, const std::string &msg) override
@@ -377,13 +402,6 @@ void MyPluginsMgr::initIAP()
     IAP::init();
     IAP::setDebug(true);
     IAP::setListener(new IAPListenerDemo);
-
-    //
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventIAP1, [](EventCustom *) {
-        CCLOG("Making purchase");
-        IAP::purchase("remove_ads");
-    });
 }
 
 
@@ -394,32 +412,26 @@ void MyPluginsMgr::initIAP()
 void MyPluginsMgr::initKochava()
 {
     sdkbox::PluginKochava::init();
+    AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::Kochava);
 
-    sdkbox::PluginKochava::trackEvent("KochavaCustomEvent", "HelloWorld");
+    AnalyticsPipeline::getInstance()->kochavaTrackEvent("KochavaCustomEvent", "HelloWorld");
+
+    // what the last launch got, until the SDK says otherwise
+    if (const AttributionSnapshot* attribution = AttributionCache::getInstance()->get())
+    {
+        CCLOG("Kochava attribution: %u values%s", (unsigned)attribution->values.size(),
+              attribution->restored ? ", cached" : "");
+    }
 
     auto callback = [](const std::map<std::string, std::string>* attribution)
     {
         if (attribution)
         {
-            typedef std::map<std::string, std::string> map_type;
-            const map_type& m = *attribution;
-
-            for (map_type::const_iterator it = m.begin(); it != m.end(); ++it)
-            {
-                const map_type::value_type& kv = *it;
-                printf("%s -> %s", kv.first.c_str(), kv.second.c_str());
-            }
+            AttributionCache::getInstance()->publish(*attribution);
         }
     };
 
     sdkbox::PluginKochava::setAttributionCallback(callback);
-
-    //
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventKochava1, [](EventCustom *) {
-        sdkbox::PluginKochava::trackEvent("KochavaCustomEvent", "HelloWorld");
-        sdkbox::PluginKochava::spatialEvent("test", 100, 101, 102);
-    });
 }
 
 /**
@@ -450,10 +462,13 @@ public:
 // https://developers.mobileapptracking.com/category/mobile-sdks/mobile-sdks-events/
 static void testTuneMeasureEvent()
 {
+    // every call goes through the pipeline so they reach Tune in this order
+    auto analytics = AnalyticsPipeline::getInstance();
+
     // https://developers.mobileapptracking.com/event-function-templates/
     {
-        PluginTune::measureEventName("purchase");
-        PluginTune::measureEventId(1122334455);
+        analytics->tuneMeasureEventName("purchase");
+        analytics->tuneMeasureEventId(1122334455);
 
         TuneEvent event;
         event.eventName = "purchase2";
@@ -462,7 +477,7 @@ static void testTuneMeasureEvent()
         event.attribute1 = "srisp";
         event.attribute2 = "red";
         event.quantity = 3;
-        PluginTune::measureEvent(event);
+        analytics->tuneMeasureEvent(event);
     }
 
     {
@@ -480,12 +495,6 @@ static void testTuneMeasureEvent()
         item2.attribute2 = "inflatable";
 
 
-        PluginTune::setUserId("US13579");
-        PluginTune::setFacebookUserId("321321321321");
-        PluginTune::setGoogleUserId("11223344556677");
-        PluginTune::setTwitterUserId("1357924680");
-        PluginTune::setLatitude(9.142276, -79.724052, 15);
-
         TuneEvent event;
         event.eventName = "purchase";
         event.eventItems.push_back(item1);
@@ -494,7 +503,7 @@ static void testTuneMeasureEvent()
         event.revenue = 13.97;
         event.currencyCode = "USD";
 
-        PluginTune::measureEvent(event);
+        analytics->tuneMeasureEvent(event);
 
     }
 
@@ -523,8 +532,7 @@ static void testTuneMeasureEvent()
         pd.advertiserSubPublisher = "ad_sub_publisher";
         pd.advertiserSubSite = "ad_sub_site";
 
-        PluginTune::setPreloadData(pd);
-        PluginTune::measureSession();
+        analytics->tuneMeasureSession(pd);
     }
 }
 
@@ -533,30 +541,36 @@ void MyPluginsMgr::initTune()
     PluginTune::init();
 //    PluginTune::setPackageName("your.package.name");
     PluginTune::setListener(new TuneListenerDemo);
+    // the session is measured with the user it belongs to
+    UserProfile::getInstance()->pushNow(SdkPlugin::Tune);
     PluginTune::measureSession();
 
 //    PluginTune::setAllowDuplicateRequests(true);
     PluginTune::checkForDeferredDeeplinkWithTimeout(60);
     PluginTune::automateIapEventMeasurement(true);
     PluginTune::setCurrencyCode("RMB");
-    PluginTune::setUserEmail("natalie@somedomain.com");
-    PluginTune::setUserName("natalie123");
-    PluginTune::setAge(43);
-    PluginTune::setGender(PluginTune::GenderFemale);
-    PluginTune::setUserId("US13579");
-    PluginTune::setFacebookUserId("321321321321");
-    PluginTune::setGoogleUserId("11223344556677");
-    PluginTune::setTwitterUserId("1357924680");
-    PluginTune::setLatitude(9.142276, -79.724052, 15);
     PluginTune::setAppAdTracking(true);
-    PluginTune::measureEventName("login");
+    AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::Tune);
+    SessionManager::getInstance()->setProviderReady(SdkPlugin::Tune);
+    DeviceIdentifiers::getInstance()->setProviderReady(SdkPlugin::Tune);
 
+    AnalyticsCatalog::emit(AnalyticsCatalog::Login{});
+}
 
-    //
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventTune1, [](EventCustom *) {
-        testTuneMeasureEvent();
-    });
+// one profile for all the SDKs; each gets the fields it takes once it is up,
+// and only those it does not have yet
+static void setUserProfile()
+{
+    auto profile = UserProfile::getInstance();
+    profile->setEmail("natalie@somedomain.com");
+    profile->setName("natalie123");
+    profile->setAge(43);
+    profile->setGender(UserProfile::kGenderFemale);
+    profile->setUserId("US13579");
+    profile->setFacebookUserId("321321321321");
+    profile->setGoogleUserId("11223344556677");
+    profile->setTwitterUserId("1357924680");
+    LocationSink::getInstance()->update(9.142276, -79.724052, 15);
 }
 
 
@@ -574,6 +588,9 @@ public:
     void onVungleStarted()
     {
         CCLOG("Start Displaying ad, disable game/music here");
+        MainThreadQueue::getInstance()->post([]() {
+            PluginEventBus::getInstance()->adShown.emit(SdkPlugin::Vungle, std::string());
+        });
     }
     void onVungleFinished()
     {
@@ -595,16 +612,6 @@ void MyPluginsMgr::initVungle()
     sdkbox::PluginVungle::init();
     sdkbox::PluginVungle::setDebug(true);
     sdkbox::PluginVungle::setListener(new VungleListenerDemo);
-
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventVungle1, [](EventCustom *) {
-        CCLOG("show video");
-        sdkbox::PluginVungle::show("video");
-    });
-    eventDispatcher->addCustomEventListener(kMenuEventVungle2, [](EventCustom *) {
-        CCLOG("show reward");
-        sdkbox::PluginVungle::show("reward");
-    });
 }
 
 #if 0
@@ -690,12 +697,12 @@ void MyPluginsMgr::initAgeCheq()
     sdkbox::PluginAgeCheq::init();
     sdkbox::PluginAgeCheq::setListener(new ACListener());
     
-    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-    eventDispatcher->addCustomEventListener(kMenuEventAgeCheg1, [](EventCustom *) {
+    auto router = MenuEventRouter::getInstance();
+    router->addListener(kMenuEventAgeCheg1, []() {
         CCLOG("check 1426");
         sdkbox::PluginAgeCheq::check("1426");
     });
-    eventDispatcher->addCustomEventListener(kMenuEventAgeCheg2, [](EventCustom *) {
+    router->addListener(kMenuEventAgeCheg2, []() {
         CCLOG("associateData 1426, ikfill");
         sdkbox::PluginAgeCheq::associateData("1426", "ikfill");
     });
@@ -705,6 +712,10 @@ void MyPluginsMgr::initAgeCheq()
 
 ///////////////////////////////////
 MyPluginsMgr::MyPluginsMgr()
+// ad networks create their views during init, keep them on the GL thread
+: _adColony("adcolony", [this]() { initAdColony(); }, true)
+, _chartboost("chartboost", [this]() { initCharBoost(); }, true)
+, _vungle("vungle", [this]() { initVungle(); }, true)
 {
 }
 
@@ -718,24 +729,156 @@ MyPluginsMgr *MyPluginsMgr::getInstance()
     return instance;
 }
 
+void MyPluginsMgr::startAnalytics()
+{
+    // events logged before a provider is up are held until it is
+    AnalyticsSampler::getInstance()->loadConfig();
+    AnalyticsPipeline::getInstance()->loadConfig();
+    SceneLoadTracker::getInstance()->loadConfig();
+    SpatialAggregator::getInstance()->loadConfig();
+    AnalyticsRouter::getInstance()->loadConfig();
+    SessionManager::getInstance()->loadConfig();
+    AnalyticsPipeline::getInstance()->start();
+    Metrics::getInstance()->start();
+    SpatialAggregator::getInstance()->start();
+    SessionManager::getInstance()->start();
+    DeviceIdentifiers::getInstance()->start();
+}
+
 bool MyPluginsMgr::init()
 {
-    initAdColony();
-    initCharBoost();
-    initFlurry();
-    initGoogleAnalytics();
-
-    initIAP();
-
-    initKochava();
-    initTune();
-    initVungle();
-//    initFacebook();
-//    initAgeCheq();
+    // name, dependencies, needed before the first frame, init, GL thread only
+    // Flurry and Tune set listeners and start their sessions during init,
+    // which their SDKs expect on the GL thread; with IAP that makes the part
+    // before the first frame serial, only GA and Kochava are taken off it
+    _initGraph.add("flurry",     {},       true,  [this]() { initFlurry(); }, true);
+    _initGraph.add("tune",       {},       true,  [this]() { initTune(); }, true);
+    // the listener has to be set before the first frame, the store delivers
+    // pending and restored transactions right at launch
+    _initGraph.add("iap",        {"tune"}, true,  [this]() { initIAP(); }, true);
+    _initGraph.add("ga",         {},       false, [this]() { initGoogleAnalytics(); });
+    _initGraph.add("kochava",    {},       false, [this]() { initKochava(); });
+//    _initGraph.add("facebook", {}, false, [this]() { initFacebook(); }, true);
+//    _initGraph.add("agecheq",  {}, false, [this]() { initAgeCheq(); }, true);
+
+    // AdColony, Chartboost and Vungle initialize through their proxies, on
+    // the GL thread; started after the first frame so their ads have cached
+    // by the first tap, which would otherwise find nothing to show
+    _initGraph.add("ads",        {},       false, [this]() {
+        _adColony.prepare();
+        _chartboost.prepare();
+        _vungle.prepare();
+    });
+
+    // the router is not thread safe, listeners are added here on the GL
+    // thread rather than from the init nodes
+    bindMenuEvents();
+
+    LocationSink::getInstance()->loadConfig();
+    AttributionCache::getInstance()->load();
+    bindAnalyticsEvents();
+    setUserProfile();
+
+    {
+        // the part of startup that blocks the first frame. GA only: Flurry
+        // is initialised inside this scope, so its timed event would start
+        // before the session and report nothing useful
+        ScopedAnalyticsTimer timer("Startup", "plugin init", ScopedAnalyticsTimer::kGoogleAnalytics);
+        _initGraph.run();
+    }
     return true;
 }
 
+void MyPluginsMgr::bindMenuEvents()
+{
+    auto router = MenuEventRouter::getInstance();
+
+    router->addListener(kMenuEventAdColony1, [this]() {
+        _adColony.call([]() { PluginAdColony::show("video"); });
+    });
+    router->addListener(kMenuEventAdColony2, [this]() {
+        _adColony.call([]() { PluginAdColony::show("v4vc"); });
+    });
+
+    router->addListener(kMenuEventChartboost1, [this]() {
+        _chartboost.call([]() { sdkbox::PluginChartboost::show(sdkbox::CB_Location_Default); });
+    });
+    router->addListener(kMenuEventChartboost2, [this]() {
+        _chartboost.call([]() { sdkbox::PluginChartboost::show("Level Complete"); });
+    });
+
+    // the graph plugins may still be initializing, a tap waits for its node
+    router->addListener(kMenuEventFA1, [this]() {
+        _initGraph.whenDone("flurry", []() {
+            CCLOG("[Flurry Analytics] sending data");
+
+            flurryAnalyticsSendData();
+        });
+    });
+
+    router->addListener(kMenuEventGA1, [this]() {
+        _initGraph.whenDone("ga", []() {
+            CCLOG("[GoogleAnalytics] sending data");
+
+            googleAnalyticsSendData();
+        });
+    });
+
+    router->addListener(kMenuEventIAP1, [this]() {
+        CCLOG("Making purchase");
+        _initGraph.whenDone("iap", []() { IAP::purchase("remove_ads"); });
+    });
+
+    router->addListener(kMenuEventKochava1, [this]() {
+        _initGraph.whenDone("kochava", []() {
+            AnalyticsPipeline::getInstance()->kochavaTrackEvent("KochavaCustomEvent", "HelloWorld");
+            SpatialAggregator::getInstance()->add("test", 100, 101, 102);
+        });
+    });
+
+    router->addListener(kMenuEventTune1, [this]() {
+        _initGraph.whenDone("tune", []() {
+            testTuneMeasureEvent();
+        });
+    });
+
+    router->addListener(kMenuEventVungle1, [this]() {
+        CCLOG("show video");
+        _vungle.call([]() { sdkbox::PluginVungle::show("video"); });
+    });
+    router->addListener(kMenuEventVungle2, [this]() {
+        CCLOG("show reward");
+        _vungle.call([]() { sdkbox::PluginVungle::show("reward"); });
+    });
+}
+
+// SDK events every analytics provider should see, one track() each
+void MyPluginsMgr::bindAnalyticsEvents()
+{
+    auto bus = PluginEventBus::getInstance();
+
+    bus->adShown.connect([](const SdkPlugin& plugin, const std::string& placement) {
+        AnalyticsCatalog::emit(AnalyticsCatalog::AdShown{ sdkPluginName(plugin), placement });
+    });
+
+    bus->rewardGranted.connect([](const SdkPlugin& plugin, const std::string& placement, const std::string& currency, const int& amount) {
+        AnalyticsCatalog::emit(AnalyticsCatalog::RewardGranted{ sdkPluginName(plugin), placement, currency, amount });
+    });
+
+    bus->purchaseSucceeded.connect([](const sdkbox::Product& product) {
+        AnalyticsCatalog::emit(AnalyticsCatalog::Purchase{
+            product.name, product.price, (int)(product.priceValue * 100), product.priceValue });
+    });
+}
+
+void MyPluginsMgr::applicationDidEnterBackground()
+{
+    SpatialAggregator::getInstance()->flush();
+    AnalyticsPipeline::getInstance()->flush();
+    SessionManager::getInstance()->onBackground();
+}
+
 void MyPluginsMgr::applicationWillEnterForeground()
 {
-    PluginTune::measureSession();
+    SessionManager::getInstance()->onForeground();
 }
@@ -10,45 +10,29 @@
 
 #include <string>
 #include "SdkboxStarterKit.h"
-
-static const std::string kMenuEvent1 = "b1";
-static const std::string kMenuEvent2 = "b2";
-
-static const std::string kMenuEventAdColony1 = "adcolony1";
-static const std::string kMenuEventAdColony2 = "adcolony2";
-
-static const std::string kMenuEventChartboost1 = "chartboost1";
-static const std::string kMenuEventChartboost2 = "chartboost2";
-
-static const std::string kMenuEventFA1 = "fa1";
-
-static const std::string kMenuEventGA1 = "ga1";
-
-static const std::string kMenuEventIAP1 = "iap1";
-
-static const std::string kMenuEventKochava1 = "kochava1";
-
-static const std::string kMenuEventTune1 = "tune1";
-
-static const std::string kMenuEventVungle1 = "vungle1";
-static const std::string kMenuEventVungle2 = "vungle2";
-
-static const std::string kMenuEventAgeCheg1 = "agecheg1";
-static const std::string kMenuEventAgeCheg2 = "agecheg2";
-
+#include "MenuEvent.h"
+#include "PluginInitGraph.h"
+#include "PluginProxy.h"
 
 class MyPluginsMgr
 {
 public:
     static MyPluginsMgr *getInstance();
 
+    // the analytics services the script bindings use as well, started for
+    // every starter kit type before the plugins are initialized
+    void startAnalytics();
     bool init();
     
+    void applicationDidEnterBackground();
     void applicationWillEnterForeground();
 
 private:
     MyPluginsMgr();
 
+    void bindMenuEvents();
+    void bindAnalyticsEvents();
+
     void initAdColony();
     void initCharBoost();
     void initFlurry();
@@ -59,6 +43,12 @@ private:
     void initVungle();
 //    void initFacebook();
 //    void initAgeCheq();
+
+    PluginInitGraph _initGraph;
+
+    PluginProxy _adColony;
+    PluginProxy _chartboost;
+    PluginProxy _vungle;
 };
 
 #endif /* defined(__template__MyPluginsMgr__) */
@@ -0,0 +1,34 @@
+//
+//  PluginEventBus.cpp
+//  template
+//
+//
+//
+
+#include "PluginEventBus.h"
+
+const char* sdkPluginName(SdkPlugin plugin)
+{
+    switch (plugin)
+    {
+        case SdkPlugin::AdColony:        return "AdColony";
+        case SdkPlugin::Chartboost:      return "Chartboost";
+        case SdkPlugin::FlurryAnalytics: return "FlurryAnalytics";
+        case SdkPlugin::GoogleAnalytics: return "GoogleAnalytics";
+        case SdkPlugin::IAP:             return "IAP";
+        case SdkPlugin::Kochava:         return "Kochava";
+        case SdkPlugin::Tune:            return "Tune";
+        case SdkPlugin::Vungle:          return "Vungle";
+    }
+    return "";
+}
+
+PluginEventBus *PluginEventBus::getInstance()
+{
+    static PluginEventBus *instance = 0;
+    if (!instance)
+    {
+        instance = new PluginEventBus();
+    }
+    return instance;
+}
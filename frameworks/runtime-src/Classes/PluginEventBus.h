@@ -0,0 +1,239 @@
+//
+//  PluginEventBus.h
+//  template
+//
+//
+//
+
+#ifndef __template__PluginEventBus__
+#define __template__PluginEventBus__
+
+#include <stdint.h>
+#include <string>
+#include "SmallFunction.h"
+
+#include "PluginIAP/PluginIAP.h"
+
+/**
+ * Typed signal with a fixed, flat slot array.
+ *
+ * connect() and disconnect() are O(1) through a free list; a connection is
+ * an index plus a generation so a stale handle can never disconnect the
+ * slot that reused its index. emit() walks the array in place and does not
+ * allocate. Slots may disconnect themselves (or others) from inside emit(),
+ * and slots connected from inside emit() first fire on the next one.
+ *
+ * Signals are not thread safe, connect and emit on the GL thread.
+ */
+template <size_t MaxSlots, typename... Args>
+class PluginSignal
+{
+public:
+    typedef SmallFunction<void(const Args&...)> Slot;
+
+    struct Connection
+    {
+        uint16_t index;
+        uint16_t generation;
+
+        Connection() : index(0xffff), generation(0) {}
+        Connection(uint16_t i, uint16_t g) : index(i), generation(g) {}
+
+        bool isValid() const { return index != 0xffff; }
+    };
+
+    PluginSignal()
+    : _freeHead(0)
+    , _end(0)
+    , _emitDepth(0)
+    , _deferredHead(kNone)
+    , _hasUnarmed(false)
+    {
+        static_assert(MaxSlots < 0xffff, "too many slots");
+        for (size_t i = 0; i < MaxSlots; i++)
+        {
+            _entries[i].generation = 0;
+            _entries[i].active = false;
+            _entries[i].armed = false;
+            _entries[i].nextFree = (uint16_t)(i + 1);
+        }
+    }
+
+    Connection connect(const Slot& slot)
+    {
+        if (_freeHead >= MaxSlots || !slot)
+        {
+            return Connection();
+        }
+
+        uint16_t index = _freeHead;
+        Entry& e = _entries[index];
+        _freeHead = e.nextFree;
+
+        e.slot = slot;
+        e.active = true;
+        // a slot connected from inside emit() may take a free index below
+        // the one running, so it sits out until the outermost emit() is over
+        e.armed = _emitDepth == 0;
+        _hasUnarmed = _hasUnarmed || !e.armed;
+        if (index >= _end)
+        {
+            _end = index + 1;
+        }
+        return Connection(index, e.generation);
+    }
+
+    void disconnect(Connection& c)
+    {
+        if (!c.isValid() || c.index >= MaxSlots)
+        {
+            return;
+        }
+
+        Entry& e = _entries[c.index];
+        if (!e.active || e.generation != c.generation)
+        {
+            c = Connection();
+            return;
+        }
+
+        // inside emit() the callable may be the one running, so the entry
+        // is only recycled once emit() has returned
+        e.active = false;
+        e.generation++;
+        if (_emitDepth > 0)
+        {
+            e.nextFree = _deferredHead;
+            _deferredHead = c.index;
+        }
+        else
+        {
+            e.slot = nullptr;
+            e.nextFree = _freeHead;
+            _freeHead = c.index;
+        }
+        c = Connection();
+    }
+
+    void emit(const Args&... args)
+    {
+        _emitDepth++;
+        // slots connected from inside a slot fire from the next emit() on
+        for (uint16_t i = 0, end = _end; i < end; i++)
+        {
+            const Entry& e = _entries[i];
+            if (e.active && e.armed)
+            {
+                e.slot(args...);
+            }
+        }
+        if (--_emitDepth == 0)
+        {
+            if (_deferredHead != kNone)
+            {
+                recycleDeferred();
+            }
+            if (_hasUnarmed)
+            {
+                armConnected();
+            }
+        }
+    }
+
+    bool empty() const
+    {
+        for (uint16_t i = 0; i < _end; i++)
+        {
+            if (_entries[i].active)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static const uint16_t kNone = 0xffff;
+
+    void recycleDeferred()
+    {
+        while (_deferredHead != kNone)
+        {
+            uint16_t index = _deferredHead;
+            _deferredHead = _entries[index].nextFree;
+            _entries[index].slot = nullptr;
+            _entries[index].nextFree = _freeHead;
+            _freeHead = index;
+        }
+    }
+
+    void armConnected()
+    {
+        for (uint16_t i = 0; i < _end; i++)
+        {
+            _entries[i].armed = _entries[i].active;
+        }
+        _hasUnarmed = false;
+    }
+
+    struct Entry
+    {
+        Slot slot;
+        uint16_t generation;
+        uint16_t nextFree;
+        bool active;
+        // false while connected during an emit() that has not returned
+        bool armed;
+    };
+
+    Entry _entries[MaxSlots];
+    uint16_t _freeHead;
+    uint16_t _end;
+    uint16_t _emitDepth;
+    uint16_t _deferredHead;
+    bool _hasUnarmed;
+};
+
+enum class SdkPlugin
+{
+    AdColony,
+    Chartboost,
+    FlurryAnalytics,
+    GoogleAnalytics,
+    IAP,
+    Kochava,
+    Tune,
+    Vungle
+};
+
+const char* sdkPluginName(SdkPlugin plugin);
+
+/**
+ * SDK events published by the native plugin listeners. Listeners hand the
+ * emit over to MainThreadQueue, so slots always run on the GL thread.
+ *
+ *   PluginEventBus::getInstance()->rewardGranted.connect(
+ *       [](const SdkPlugin& p, const std::string& placement, const std::string& currency, const int& amount) {
+ *           ...
+ *       });
+ */
+class PluginEventBus
+{
+public:
+    static PluginEventBus *getInstance();
+
+    // plugin, placement / zone
+    PluginSignal<8, SdkPlugin, std::string> adShown;
+
+    // plugin, placement / zone, currency name (may be empty), amount
+    PluginSignal<8, SdkPlugin, std::string, std::string, int> rewardGranted;
+
+    PluginSignal<8, sdkbox::Product> purchaseSucceeded;
+
+    PluginSignal<8, SdkPlugin> sessionStarted;
+
+private:
+    PluginEventBus() {}
+};
+
+#endif /* defined(__template__PluginEventBus__) */
@@ -0,0 +1,457 @@
+//
+//  PluginInitGraph.cpp
+//  template
+//
+//
+//
+
+#include "PluginInitGraph.h"
+#include "cocos2d.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+USING_NS_CC;
+
+static const unsigned int kMaxInitWorkers = 4;
+
+struct PluginInitGraph::Node
+{
+    std::string name;
+    std::vector<std::string> deps;
+    bool critical;
+    bool mainThread;
+    InitFunc func;
+
+    std::vector<Node*> depNodes;
+    std::vector<Node*> dependents;
+    int pending;
+    bool inPhase;
+    bool done;
+    bool skipped;
+    // as seen by whenDone(), GL thread only
+    bool finished;
+    std::vector<InitFunc> waiting;
+
+    double startMs;
+    double endMs;
+    size_t threadId;
+};
+
+PluginInitGraph::PluginInitGraph()
+: _origin(0)
+, _started(false)
+{
+}
+
+PluginInitGraph::~PluginInitGraph()
+{
+    for (auto node : _nodes)
+    {
+        delete node;
+    }
+}
+
+double PluginInitGraph::now() const
+{
+    using namespace std::chrono;
+    return duration_cast<duration<double, std::milli>>(steady_clock::now().time_since_epoch()).count();
+}
+
+void PluginInitGraph::add(const std::string& name,
+                          const std::vector<std::string>& deps,
+                          bool critical,
+                          const InitFunc& func,
+                          bool mainThread)
+{
+    if (_started)
+    {
+        CCLOG("[InitGraph] %s added after run(), ignored", name.c_str());
+        return;
+    }
+
+    Node* node = new Node();
+    node->name = name;
+    node->deps = deps;
+    node->critical = critical;
+    node->mainThread = mainThread;
+    node->func = func;
+    node->pending = 0;
+    node->inPhase = false;
+    node->done = false;
+    node->skipped = false;
+    node->finished = false;
+    node->startMs = 0;
+    node->endMs = 0;
+    node->threadId = 0;
+    _nodes.push_back(node);
+}
+
+// link dependencies by name, pull the dependencies of critical nodes into
+// the critical set and drop nodes that are part of a cycle
+bool PluginInitGraph::resolve()
+{
+    for (auto node : _nodes)
+    {
+        for (auto& depName : node->deps)
+        {
+            auto it = std::find_if(_nodes.begin(), _nodes.end(), [&depName](Node* n) { return n->name == depName; });
+            if (it == _nodes.end())
+            {
+                CCLOG("[InitGraph] %s depends on unknown node %s, ignored", node->name.c_str(), depName.c_str());
+                continue;
+            }
+            node->depNodes.push_back(*it);
+            (*it)->dependents.push_back(node);
+        }
+    }
+
+    std::vector<Node*> stack;
+    for (auto node : _nodes)
+    {
+        if (node->critical)
+        {
+            stack.push_back(node);
+        }
+    }
+    while (!stack.empty())
+    {
+        Node* node = stack.back();
+        stack.pop_back();
+        for (auto dep : node->depNodes)
+        {
+            if (!dep->critical)
+            {
+                dep->critical = true;
+                stack.push_back(dep);
+            }
+        }
+    }
+
+    // Kahn's algorithm, whatever is left over sits on a cycle
+    std::deque<Node*> ready;
+    for (auto node : _nodes)
+    {
+        node->pending = (int)node->depNodes.size();
+        if (node->pending == 0)
+        {
+            ready.push_back(node);
+        }
+    }
+    size_t sorted = 0;
+    while (!ready.empty())
+    {
+        Node* node = ready.front();
+        ready.pop_front();
+        sorted++;
+        for (auto dependent : node->dependents)
+        {
+            if (--dependent->pending == 0)
+            {
+                ready.push_back(dependent);
+            }
+        }
+    }
+    if (sorted == _nodes.size())
+    {
+        return true;
+    }
+
+    for (auto node : _nodes)
+    {
+        if (node->pending > 0)
+        {
+            CCLOG("[InitGraph] %s is part of a dependency cycle, skipped", node->name.c_str());
+            node->skipped = true;
+            node->done = true;
+            finish(node);
+        }
+    }
+    return false;
+}
+
+void PluginInitGraph::runPhase(const std::vector<Node*>& phase, bool onGLThread)
+{
+    if (phase.empty())
+    {
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Node*> ready;
+    std::deque<Node*> readyMain;
+    size_t remaining = phase.size();
+    size_t workerJobs = 0;
+
+    for (auto node : phase)
+    {
+        node->inPhase = true;
+        node->pending = 0;
+        for (auto dep : node->depNodes)
+        {
+            if (!dep->done)
+            {
+                node->pending++;
+            }
+        }
+        if (!node->mainThread)
+        {
+            workerJobs++;
+        }
+        if (node->pending == 0)
+        {
+            (node->mainThread ? readyMain : ready).push_back(node);
+        }
+    }
+
+    auto execute = [this](Node* node) {
+        node->threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+        node->startMs = now() - _origin;
+        node->func();
+        node->endMs = now() - _origin;
+    };
+
+    auto complete = [&](Node* node) {
+        finish(node);
+        std::lock_guard<std::mutex> lock(mutex);
+        node->done = true;
+        node->inPhase = false;
+        for (auto dependent : node->dependents)
+        {
+            if (dependent->inPhase && --dependent->pending == 0)
+            {
+                (dependent->mainThread ? readyMain : ready).push_back(dependent);
+            }
+        }
+        remaining--;
+        cond.notify_all();
+    };
+
+    unsigned int workerCount = std::max(1u, std::min(kMaxInitWorkers, std::thread::hardware_concurrency()));
+    workerCount = std::min(workerCount, (unsigned int)workerJobs);
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers.push_back(std::thread([&]() {
+            while (true)
+            {
+                Node* node = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() { return remaining == 0 || !ready.empty(); });
+                    if (ready.empty())
+                    {
+                        return;
+                    }
+                    node = ready.front();
+                    ready.pop_front();
+                }
+                execute(node);
+                complete(node);
+            }
+        }));
+    }
+
+    // the calling thread runs the GL thread nodes itself, or hands them to
+    // the cocos thread when the phase runs in the background
+    while (true)
+    {
+        Node* node = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return remaining == 0 || !readyMain.empty() || (onGLThread && !ready.empty()); });
+            if (!readyMain.empty())
+            {
+                node = readyMain.front();
+                readyMain.pop_front();
+            }
+            else if (onGLThread && !ready.empty())
+            {
+                node = ready.front();
+                ready.pop_front();
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (onGLThread)
+        {
+            execute(node);
+            complete(node);
+        }
+        else
+        {
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([=, &execute, &complete]() {
+                execute(node);
+                complete(node);
+            });
+        }
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void PluginInitGraph::run()
+{
+    if (_started)
+    {
+        return;
+    }
+    _started = true;
+    _origin = now();
+
+    resolve();
+
+    std::vector<Node*> critical;
+    for (auto node : _nodes)
+    {
+        if (node->critical && !node->done)
+        {
+            critical.push_back(node);
+        }
+    }
+    runPhase(critical, true);
+    CCLOG("[InitGraph] critical plugins ready after %.2f ms", now() - _origin);
+
+    bool hasDeferred = std::any_of(_nodes.begin(), _nodes.end(), [](Node* n) { return !n->done; });
+    if (!hasDeferred)
+    {
+        printReport();
+        return;
+    }
+
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    auto listener = std::make_shared<EventListenerCustom*>(nullptr);
+    *listener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this, listener](EventCustom*) {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(*listener);
+        std::thread(&PluginInitGraph::runDeferred, this).detach();
+    });
+}
+
+void PluginInitGraph::runDeferred()
+{
+    std::vector<Node*> deferred;
+    for (auto node : _nodes)
+    {
+        if (!node->done)
+        {
+            deferred.push_back(node);
+        }
+    }
+    runPhase(deferred, false);
+    CCLOG("[InitGraph] deferred plugins ready after %.2f ms", now() - _origin);
+    printReport();
+}
+
+void PluginInitGraph::whenDone(const std::string& name, const InitFunc& func)
+{
+    auto it = std::find_if(_nodes.begin(), _nodes.end(), [&name](Node* n) { return n->name == name; });
+    if (it == _nodes.end())
+    {
+        CCLOG("[InitGraph] no node %s, running the call right away", name.c_str());
+        func();
+        return;
+    }
+
+    Node* node = *it;
+    if (!node->finished)
+    {
+        node->waiting.push_back(func);
+        return;
+    }
+    if (node->skipped)
+    {
+        CCLOG("[InitGraph] %s was never initialized, call dropped", name.c_str());
+        return;
+    }
+    func();
+}
+
+// any thread; the node counts as finished for whenDone() only once the
+// GL thread gets here, so calls made in the meantime queue behind the
+// ones already waiting
+void PluginInitGraph::finish(Node* node)
+{
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([node]() {
+        std::vector<InitFunc> waiting;
+        node->finished = true;
+        waiting.swap(node->waiting);
+        if (node->skipped)
+        {
+            if (!waiting.empty())
+            {
+                CCLOG("[InitGraph] %s was never initialized, %d calls dropped", node->name.c_str(), (int)waiting.size());
+            }
+            return;
+        }
+        for (auto& func : waiting)
+        {
+            func();
+        }
+    });
+}
+
+void PluginInitGraph::printReport() const
+{
+    std::vector<Node*> ran;
+    for (auto node : _nodes)
+    {
+        if (node->done && !node->skipped)
+        {
+            ran.push_back(node);
+        }
+    }
+    std::sort(ran.begin(), ran.end(), [](Node* a, Node* b) { return a->startMs < b->startMs; });
+
+    CCLOG("[InitGraph] %-12s %-9s %10s %10s %18s", "node", "phase", "start ms", "took ms", "thread");
+    for (auto node : ran)
+    {
+        CCLOG("[InitGraph] %-12s %-9s %10.2f %10.2f %18zx",
+              node->name.c_str(),
+              node->critical ? "critical" : "deferred",
+              node->startMs,
+              node->endMs - node->startMs,
+              node->threadId);
+    }
+
+    // walk back from the node that finished last through the dependency
+    // that finished last, that chain is what bounds the init time
+    Node* tail = nullptr;
+    for (auto node : ran)
+    {
+        if (!tail || node->endMs > tail->endMs)
+        {
+            tail = node;
+        }
+    }
+    std::string path;
+    while (tail)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), " %.2f ms", tail->endMs - tail->startMs);
+        path = tail->name + buf + (path.empty() ? "" : " -> ") + path;
+
+        Node* slowest = nullptr;
+        for (auto dep : tail->depNodes)
+        {
+            if (!dep->skipped && (!slowest || dep->endMs > slowest->endMs))
+            {
+                slowest = dep;
+            }
+        }
+        tail = slowest;
+    }
+    CCLOG("[InitGraph] critical path: %s", path.c_str());
+}
@@ -0,0 +1,73 @@
+//
+//  PluginInitGraph.h
+//  template
+//
+//
+//
+
+#ifndef __template__PluginInitGraph__
+#define __template__PluginInitGraph__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Declarative plugin init graph.
+ *
+ * Every plugin registers one node with the names of the nodes it depends on
+ * and whether it is needed before the first frame. run() executes the
+ * critical nodes (and everything they depend on) and only returns once
+ * they are done; the remaining nodes are run in the background after the
+ * first frame has been drawn.
+ *
+ * Nodes not flagged mainThread run concurrently on worker threads. Nodes
+ * flagged mainThread are always executed on the GL thread, one after the
+ * other, for SDKs that touch UI objects or expect their listeners to be set
+ * there. In this app every critical node is mainThread, so the critical
+ * phase is serial and the time gained before the first frame comes from
+ * deferring the other nodes, Google Analytics and Kochava.
+ *
+ * whenDone() holds a call back until a node has finished, so code that
+ * uses a deferred plugin does not reach it before its init did.
+ */
+class PluginInitGraph
+{
+public:
+    typedef std::function<void()> InitFunc;
+
+    PluginInitGraph();
+    ~PluginInitGraph();
+
+    void add(const std::string& name,
+             const std::vector<std::string>& deps,
+             bool critical,
+             const InitFunc& func,
+             bool mainThread = false);
+
+    // must be called on the GL thread, before Director::runWithScene
+    void run();
+
+    // GL thread: runs func now if the node has finished, otherwise on the
+    // GL thread once it has, in the order the calls were made
+    void whenDone(const std::string& name, const InitFunc& func);
+
+    // dumps start offset, duration and thread of every node that ran,
+    // followed by the longest dependency chain
+    void printReport() const;
+
+private:
+    struct Node;
+
+    bool resolve();
+    void runPhase(const std::vector<Node*>& phase, bool onGLThread);
+    void runDeferred();
+    void finish(Node* node);
+    double now() const;
+
+    std::vector<Node*> _nodes;
+    double _origin;
+    bool _started;
+};
+
+#endif /* defined(__template__PluginInitGraph__) */
@@ -0,0 +1,118 @@
+//
+//  PluginProxy.cpp
+//  template
+//
+//
+//
+
+#include "PluginProxy.h"
+#include "cocos2d.h"
+
+#include <chrono>
+#include <thread>
+
+USING_NS_CC;
+
+PluginProxy::PluginProxy(const std::string& name, const Call& init, bool mainThread)
+: _name(name)
+, _init(init)
+, _mainThread(mainThread)
+, _state(kStateIdle)
+{
+}
+
+bool PluginProxy::isReady() const
+{
+    return _state.load(std::memory_order_acquire) == kStateReady;
+}
+
+void PluginProxy::call(const Call& fn)
+{
+    if (isReady())
+    {
+        fn();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // init may have completed while we were waiting for the lock
+        if (_state.load(std::memory_order_relaxed) != kStateReady)
+        {
+            _pending.push_back(fn);
+            if (_state.load(std::memory_order_relaxed) == kStateIdle)
+            {
+                _state.store(kStateInitializing, std::memory_order_relaxed);
+                startInit();
+            }
+            return;
+        }
+    }
+    fn();
+}
+
+void PluginProxy::prepare()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_state.load(std::memory_order_relaxed) == kStateIdle)
+    {
+        _state.store(kStateInitializing, std::memory_order_relaxed);
+        startInit();
+    }
+}
+
+// called with _mutex held
+void PluginProxy::startInit()
+{
+    CCLOG("[PluginProxy] %s first use, initializing", _name.c_str());
+
+    if (_mainThread)
+    {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]() {
+            finishInit();
+        });
+    }
+    else
+    {
+        std::thread([this]() {
+            finishInit();
+        }).detach();
+    }
+}
+
+void PluginProxy::finishInit()
+{
+    auto start = std::chrono::steady_clock::now();
+    _init();
+    auto took = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::steady_clock::now() - start);
+    CCLOG("[PluginProxy] %s initialized in %.2f ms", _name.c_str(), took.count());
+
+    if (_mainThread)
+    {
+        markReady();
+    }
+    else
+    {
+        // flip to ready on the GL thread so calls made in the meantime keep
+        // queueing behind the ones already pending
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this]() {
+            markReady();
+        });
+    }
+}
+
+// GL thread
+void PluginProxy::markReady()
+{
+    std::vector<Call> pending;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _state.store(kStateReady, std::memory_order_release);
+        pending.swap(_pending);
+    }
+
+    for (auto& fn : pending)
+    {
+        fn();
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  PluginProxy.h
+//  template
+//
+//
+//
+
+#ifndef __template__PluginProxy__
+#define __template__PluginProxy__
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * First-use wrapper around a plugin's init().
+ *
+ * Nothing is initialized until the first call() (or prepare()). Calls made
+ * while the plugin is still initializing are queued and replayed on the GL
+ * thread, in order, as soon as init has returned. Once the plugin is ready
+ * call() runs the function directly.
+ */
+class PluginProxy
+{
+public:
+    typedef std::function<void()> Call;
+
+    // mainThread: run init on the GL thread instead of a worker thread
+    PluginProxy(const std::string& name, const Call& init, bool mainThread);
+
+    void call(const Call& fn);
+
+    // start init ahead of the first call, e.g. to let ads cache
+    void prepare();
+
+    bool isReady() const;
+
+    const std::string& getName() const { return _name; }
+
+private:
+    enum State
+    {
+        kStateIdle,
+        kStateInitializing,
+        kStateReady
+    };
+
+    void startInit();
+    void finishInit();
+    void markReady();
+
+    std::string _name;
+    Call _init;
+    bool _mainThread;
+
+    std::atomic<int> _state;
+    std::mutex _mutex;
+    std::vector<Call> _pending;
+};
+
+#endif /* defined(__template__PluginProxy__) */
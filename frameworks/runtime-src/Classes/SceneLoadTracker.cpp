@@ -0,0 +1,251 @@
+//
+//  SceneLoadTracker.cpp
+//  template
+//
+//
+//
+
+#include "SceneLoadTracker.h"
+#include "AnalyticsPipeline.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+#include <stdio.h>
+
+USING_NS_CC;
+
+static int64_t toUs(SceneLoadTracker::Clock::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+static int toMs(int64_t us)
+{
+    return (int)((us + 500) / 1000);
+}
+
+static void setMs(EventParams& params, const char* key, int64_t us)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%.1f", us / 1000.0);
+    params.set(key, buf);
+}
+
+EventParams SceneLoadTracker::Beacon::toParams() const
+{
+    EventParams params;
+    params.set("scene", scene);
+    params.set("from", from);
+    if (buildUs >= 0)
+    {
+        setMs(params, "build_ms", buildUs);
+    }
+    setMs(params, "present_ms", presentUs);
+    setMs(params, "total_ms", totalUs);
+    return params;
+}
+
+SceneLoadTracker::SceneLoadTracker()
+: _listener(nullptr)
+, _report(false)
+, _built(nullptr)
+, _presenting(false)
+, _target(nullptr)
+, _next(0)
+, _count(0)
+{
+}
+
+SceneLoadTracker* SceneLoadTracker::getInstance()
+{
+    static SceneLoadTracker *instance = 0;
+    if (!instance)
+    {
+        instance = new SceneLoadTracker();
+    }
+    return instance;
+}
+
+void SceneLoadTracker::start()
+{
+    if (_listener)
+    {
+        return;
+    }
+
+    _listener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        onAfterDraw();
+    });
+}
+
+void SceneLoadTracker::loadConfig(const std::string& file)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[SceneLoadTracker] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& analytics = doc["analytics"];
+    if (!analytics.HasMember("sceneLoad") || !analytics["sceneLoad"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& sceneLoad = analytics["sceneLoad"];
+    if (sceneLoad.HasMember("report") && sceneLoad["report"].IsBool())
+    {
+        _report = sceneLoad["report"].GetBool();
+    }
+}
+
+void SceneLoadTracker::built(const std::string& name, Scene* scene, Clock::time_point begin)
+{
+    _buildEnd = Clock::now();
+    _buildBegin = begin;
+    _built = scene;
+    _builtName = name;
+    if (scene && scene->getName().empty())
+    {
+        scene->setName(name);
+    }
+    _builtSceneName = scene ? scene->getName() : std::string();
+}
+
+void SceneLoadTracker::runWithScene(Scene* scene)
+{
+    presenting(scene);
+    Director::getInstance()->runWithScene(scene);
+}
+
+void SceneLoadTracker::replaceScene(Scene* scene)
+{
+    presenting(scene);
+    Director::getInstance()->replaceScene(scene);
+}
+
+void SceneLoadTracker::presenting(Scene* scene)
+{
+    if (!scene)
+    {
+        return;
+    }
+
+    _presentBegin = Clock::now();
+    _target = scene;
+    _presenting = true;
+
+    Scene* running = Director::getInstance()->getRunningScene();
+    _pending.from = running ? running->getName() : std::string();
+    _pending.buildUs = -1;
+
+    // a transition wraps the scene that was built
+    Scene* presented = scene;
+    if (TransitionScene* transition = dynamic_cast<TransitionScene*>(scene))
+    {
+        presented = transition->getInScene();
+    }
+
+    // a build that is not this scene's was never presented and is dropped;
+    // the name guards against a new scene at a released one's address
+    if (_built && presented == _built && presented->getName() == _builtSceneName)
+    {
+        _pending.scene = _builtName;
+        _pending.buildUs = toUs(_buildEnd - _buildBegin);
+    }
+    else
+    {
+        _pending.scene = scene->getName();
+        _buildBegin = _presentBegin;
+    }
+    _built = nullptr;
+    if (_pending.scene.empty())
+    {
+        _pending.scene = "Scene";
+    }
+}
+
+// GL thread, once per frame
+void SceneLoadTracker::onAfterDraw()
+{
+    if (!_presenting)
+    {
+        return;
+    }
+    // replaceScene() takes effect at the start of the next frame
+    if (Director::getInstance()->getRunningScene() == _target)
+    {
+        finish();
+    }
+}
+
+void SceneLoadTracker::finish()
+{
+    Clock::time_point now = Clock::now();
+    _presenting = false;
+    _target = nullptr;
+
+    _pending.presentUs = toUs(now - _presentBegin);
+    _pending.totalUs = toUs(now - _buildBegin);
+    _pending.frame = Director::getInstance()->getTotalFrames();
+
+    Beacon& beacon = _ring[_next];
+    beacon = _pending;
+    _next = (_next + 1) % kCapacity;
+    if (_count < kCapacity)
+    {
+        _count++;
+    }
+
+    CCLOG("[SceneLoadTracker] %s: build %.1fms, present %.1fms, total %.1fms",
+          beacon.scene.c_str(), beacon.buildUs / 1000.0, beacon.presentUs / 1000.0, beacon.totalUs / 1000.0);
+
+    if (_report)
+    {
+        report(beacon);
+    }
+}
+
+void SceneLoadTracker::report(const Beacon& beacon)
+{
+    static InternedString category = StringInterner::getInstance()->intern("scene_load");
+    static InternedString build = StringInterner::getInstance()->intern("build");
+    static InternedString present = StringInterner::getInstance()->intern("present");
+    static InternedString total = StringInterner::getInstance()->intern("total");
+
+    auto analytics = AnalyticsPipeline::getInstance();
+    InternedString scene = StringInterner::getInstance()->intern(beacon.scene);
+    if (scene)
+    {
+        if (beacon.buildUs >= 0)
+        {
+            analytics->gaLogTiming(category, toMs(beacon.buildUs), scene, build);
+        }
+        analytics->gaLogTiming(category, toMs(beacon.presentUs), scene, present);
+        analytics->gaLogTiming(category, toMs(beacon.totalUs), scene, total);
+    }
+    analytics->flurryLogEvent("scene_load", beacon.toParams());
+}
+
+std::vector<SceneLoadTracker::Beacon> SceneLoadTracker::getBeacons() const
+{
+    std::vector<Beacon> beacons;
+    beacons.reserve(_count);
+    size_t first = (_next + kCapacity - _count) % kCapacity;
+    for (size_t i = 0; i < _count; i++)
+    {
+        beacons.push_back(_ring[(first + i) % kCapacity]);
+    }
+    return beacons;
+}
@@ -0,0 +1,128 @@
+//
+//  SceneLoadTracker.h
+//  template
+//
+//
+//
+
+#ifndef __template__SceneLoadTracker__
+#define __template__SceneLoadTracker__
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "EventParams.h"
+
+namespace cocos2d
+{
+    class EventListenerCustom;
+    class Scene;
+}
+
+/**
+ * Timing beacons for scene transitions.
+ *
+ * Build the scene and present it through the tracker instead of calling
+ * the Director directly:
+ *
+ *   auto tracker = SceneLoadTracker::getInstance();
+ *   tracker->replaceScene(TransitionFade::create(0.5f, tracker->build("Game", &Game::createScene)));
+ *
+ * Each transition yields one Beacon once the new scene has been drawn for
+ * the first time (inside its transition, if it has one):
+ *
+ *   build     the create function, init() of every node included
+ *   present   runWithScene()/replaceScene() to the end of the first frame
+ *   total     start of build to the end of the first frame
+ *
+ * A build is only credited to the scene it built, or to a transition into
+ * it. Any other scene has a build time of -1, and presenting it drops the
+ * build. The last kCapacity beacons are kept in memory, see getBeacons();
+ * with "report" set in the "sceneLoad" block of the "analytics" section of
+ * sdkbox_config.json they also go out through AnalyticsPipeline:
+ *
+ *   GA       logTiming("scene_load", ms, <scene>, "build"/"present"/"total")
+ *   Flurry   "scene_load" with the fields of Beacon::toParams()
+ *
+ * GL thread only.
+ */
+class SceneLoadTracker
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const size_t kCapacity = 32;
+
+    struct Beacon
+    {
+        std::string scene;
+        // running when the transition started, empty for the first scene
+        std::string from;
+        int64_t buildUs;
+        int64_t presentUs;
+        int64_t totalUs;
+        // Director::getTotalFrames() at the first frame
+        unsigned int frame;
+
+        EventParams toParams() const;
+    };
+
+    static SceneLoadTracker* getInstance();
+
+    // once the Director exists
+    void start();
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+
+    void setReportToAnalytics(bool report) { _report = report; }
+
+    // names the scene as well, unless create() already did
+    template <typename Create>
+    cocos2d::Scene* build(const std::string& name, Create create)
+    {
+        Clock::time_point begin = Clock::now();
+        cocos2d::Scene* scene = create();
+        built(name, scene, begin);
+        return scene;
+    }
+
+    void runWithScene(cocos2d::Scene* scene);
+    // scene may be a TransitionScene wrapping the one that was built
+    void replaceScene(cocos2d::Scene* scene);
+
+    // oldest first
+    std::vector<Beacon> getBeacons() const;
+
+private:
+    SceneLoadTracker();
+
+    void built(const std::string& name, cocos2d::Scene* scene, Clock::time_point begin);
+    void presenting(cocos2d::Scene* scene);
+    void onAfterDraw();
+    void finish();
+    void report(const Beacon& beacon);
+
+    cocos2d::EventListenerCustom* _listener;
+    bool _report;
+
+    // the last scene built, until the next presentation; compared by
+    // address and name only, as it may have been released without ever
+    // being presented
+    cocos2d::Scene* _built;
+    std::string _builtName;
+    std::string _builtSceneName;
+    Clock::time_point _buildBegin;
+    Clock::time_point _buildEnd;
+
+    // set from runWithScene()/replaceScene() to the first frame
+    bool _presenting;
+    cocos2d::Scene* _target;
+    Beacon _pending;
+    Clock::time_point _presentBegin;
+
+    Beacon _ring[kCapacity];
+    size_t _next;
+    size_t _count;
+};
+
+#endif /* defined(__template__SceneLoadTracker__) */
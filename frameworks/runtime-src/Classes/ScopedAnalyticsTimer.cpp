@@ -0,0 +1,147 @@
+//
+//  ScopedAnalyticsTimer.cpp
+//  template
+//
+//
+//
+
+#include "ScopedAnalyticsTimer.h"
+#include "AnalyticsPipeline.h"
+
+#include <pthread.h>
+
+// innermost running timer per thread; a pthread key rather than
+// thread_local, which older NDK toolchains do not support
+static pthread_key_t s_currentKey;
+static pthread_once_t s_currentOnce = PTHREAD_ONCE_INIT;
+
+static void createCurrentKey()
+{
+    pthread_key_create(&s_currentKey, nullptr);
+}
+
+static ScopedAnalyticsTimer* getCurrent()
+{
+    pthread_once(&s_currentOnce, createCurrentKey);
+    return static_cast<ScopedAnalyticsTimer*>(pthread_getspecific(s_currentKey));
+}
+
+static void setCurrent(ScopedAnalyticsTimer* timer)
+{
+    pthread_setspecific(s_currentKey, timer);
+}
+
+ScopedAnalyticsTimer::ScopedAnalyticsTimer(InternedString category, InternedString name,
+                                           InternedString label, int sinks)
+: _category(category)
+, _name(name)
+, _label(label)
+, _sinks(sinks)
+, _running(false)
+, _parent(nullptr)
+{
+    start();
+}
+
+ScopedAnalyticsTimer::ScopedAnalyticsTimer(StringRef category, StringRef name, int sinks)
+: _category(StringInterner::getInstance()->intern(category))
+, _name(StringInterner::getInstance()->intern(name))
+, _sinks(sinks)
+, _running(false)
+, _parent(nullptr)
+{
+    start();
+}
+
+ScopedAnalyticsTimer::~ScopedAnalyticsTimer()
+{
+    stop();
+}
+
+ScopedAnalyticsTimer* ScopedAnalyticsTimer::current()
+{
+    return getCurrent();
+}
+
+void ScopedAnalyticsTimer::start()
+{
+    if (!_name)
+    {
+        // the intern table is full, nothing to report under
+        return;
+    }
+
+    _parent = getCurrent();
+    setCurrent(this);
+    _running = true;
+
+    if (_sinks & kFlurry)
+    {
+        AnalyticsPipeline::getInstance()->flurryLogEvent(_name.str(), true);
+    }
+    // last, so queueing the Flurry event is not part of the measurement
+    _start = std::chrono::steady_clock::now();
+}
+
+void ScopedAnalyticsTimer::stop()
+{
+    finish(false);
+}
+
+void ScopedAnalyticsTimer::cancel()
+{
+    finish(true);
+}
+
+int64_t ScopedAnalyticsTimer::elapsedMs() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count();
+}
+
+void ScopedAnalyticsTimer::finish(bool cancelled)
+{
+    if (!_running)
+    {
+        return;
+    }
+    int64_t ms = elapsedMs();
+    _running = false;
+
+    // usually the top of the stack; a timer stopped early by hand can be
+    // below children that are still running
+    ScopedAnalyticsTimer* top = getCurrent();
+    if (top == this)
+    {
+        setCurrent(_parent);
+    }
+    else
+    {
+        for (ScopedAnalyticsTimer* t = top; t; t = t->_parent)
+        {
+            if (t->_parent == this)
+            {
+                t->_parent = _parent;
+                break;
+            }
+        }
+    }
+
+    auto analytics = AnalyticsPipeline::getInstance();
+    if ((_sinks & kGoogleAnalytics) && !cancelled)
+    {
+        // a null handle is sent as an empty string
+        InternedString label = _label ? _label : (_parent ? _parent->_name : InternedString());
+        analytics->gaLogTiming(_category, (int)ms, _name, label);
+    }
+    if (_sinks & kFlurry)
+    {
+        if (cancelled)
+        {
+            analytics->flurryEndTimedEvent(_name.str(), EventParams{{"cancelled", "true"}});
+        }
+        else
+        {
+            analytics->flurryEndTimedEvent(_name.str());
+        }
+    }
+}
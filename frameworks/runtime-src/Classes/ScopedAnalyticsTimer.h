@@ -0,0 +1,78 @@
+//
+//  ScopedAnalyticsTimer.h
+//  template
+//
+//
+//
+
+#ifndef __template__ScopedAnalyticsTimer__
+#define __template__ScopedAnalyticsTimer__
+
+#include <stdint.h>
+#include <chrono>
+#include "StringInterner.h"
+
+/**
+ * Times a scope on the monotonic clock and reports it through
+ * AnalyticsPipeline when the scope ends:
+ *
+ *   {
+ *       ScopedAnalyticsTimer timer("Loading", "level 3");
+ *       ...
+ *   }   // GA logTiming("Loading", ms, "level 3", label) + Flurry endTimedEvent("level 3")
+ *
+ * The Flurry timed event is started by the constructor, so Flurry measures
+ * the same span. Names are interned handles and the timer lives on the
+ * stack; starting and stopping one allocates nothing itself.
+ *
+ * Timers started on one thread form a stack: current() is the innermost
+ * running one, and a timer without a label reports its parent's name as
+ * the GA label, so nested load phases group under the phase they ran in.
+ * A timer must be stopped on the thread that started it.
+ */
+class ScopedAnalyticsTimer
+{
+public:
+    enum Sink
+    {
+        kGoogleAnalytics = 1 << 0,
+        kFlurry = 1 << 1,
+        kAllSinks = kGoogleAnalytics | kFlurry
+    };
+
+    ScopedAnalyticsTimer(InternedString category, InternedString name,
+                         InternedString label = InternedString(), int sinks = kAllSinks);
+    ScopedAnalyticsTimer(StringRef category, StringRef name, int sinks = kAllSinks);
+    ~ScopedAnalyticsTimer();
+
+    // reports now instead of at the end of the scope; later calls do nothing
+    void stop();
+    // ends the Flurry timed event flagged "cancelled" and skips the GA
+    // timing, so aborted work does not skew the distribution
+    void cancel();
+
+    bool isRunning() const { return _running; }
+    int64_t elapsedMs() const;
+    ScopedAnalyticsTimer* parent() const { return _parent; }
+    InternedString name() const { return _name; }
+
+    // innermost running timer on the calling thread, or nullptr
+    static ScopedAnalyticsTimer* current();
+
+private:
+    ScopedAnalyticsTimer(const ScopedAnalyticsTimer&);
+    ScopedAnalyticsTimer& operator=(const ScopedAnalyticsTimer&);
+
+    void start();
+    void finish(bool cancelled);
+
+    InternedString _category;
+    InternedString _name;
+    InternedString _label;
+    int _sinks;
+    bool _running;
+    std::chrono::steady_clock::time_point _start;
+    ScopedAnalyticsTimer* _parent;
+};
+
+#endif /* defined(__template__ScopedAnalyticsTimer__) */
@@ -0,0 +1,267 @@
+//
+//  SessionManager.cpp
+//  template
+//
+//
+//
+
+#include "SessionManager.h"
+#include "AnalyticsPipeline.h"
+#include "DeviceIdentifiers.h"
+#include "Metrics.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "PluginFlurryAnalytics/PluginFlurryAnalytics.h"
+#include "PluginGoogleAnalytics/PluginGoogleAnalytics.h"
+#include "PluginTune/PluginTune.h"
+
+USING_NS_CC;
+
+static bool isReady(uint32_t ready, SdkPlugin provider)
+{
+    return (ready & (1u << (int)provider)) != 0;
+}
+
+SessionManager::SessionManager()
+: _debounceMs(kDefaultDebounceMs)
+, _flushBudgetMs(kDefaultFlushBudgetMs)
+, _started(false)
+, _readyMask(0)
+, _background(false)
+, _appliedBackground(false)
+, _transitions(0)
+, _listener(nullptr)
+, _resuming(false)
+{
+    _stats.backgrounds = 0;
+    _stats.foregrounds = 0;
+    _stats.debounced = 0;
+    _stats.flushTimeouts = 0;
+    _stats.lastFlushMs = 0;
+}
+
+SessionManager* SessionManager::getInstance()
+{
+    static SessionManager *instance = 0;
+    if (!instance)
+    {
+        instance = new SessionManager();
+    }
+    return instance;
+}
+
+void SessionManager::loadConfig(const std::string& file)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[SessionManager] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& analytics = doc["analytics"];
+    if (!analytics.HasMember("session") || !analytics["session"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& session = analytics["session"];
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (session.HasMember("debounceMs") && session["debounceMs"].IsInt())
+    {
+        _debounceMs = std::max(0, session["debounceMs"].GetInt());
+    }
+    if (session.HasMember("flushBudgetMs") && session["flushBudgetMs"].IsInt())
+    {
+        _flushBudgetMs = std::max(0, session["flushBudgetMs"].GetInt());
+    }
+}
+
+void SessionManager::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_started)
+        {
+            return;
+        }
+        _started = true;
+    }
+
+    _listener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        onAfterDraw();
+    });
+
+    std::thread([this]() {
+        workerLoop();
+    }).detach();
+}
+
+void SessionManager::setProviderReady(SdkPlugin provider)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _readyMask |= 1u << (int)provider;
+}
+
+void SessionManager::onBackground()
+{
+    _resuming = false;
+    transition(true);
+}
+
+void SessionManager::onForeground()
+{
+    _resuming = true;
+    _resumedAt = Clock::now();
+    transition(false);
+}
+
+void SessionManager::transition(bool background)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_background == background)
+    {
+        return;
+    }
+    _background = background;
+    _transitions++;
+    _cond.notify_one();
+}
+
+void SessionManager::onAfterDraw()
+{
+    if (!_resuming)
+    {
+        return;
+    }
+    _resuming = false;
+
+    static MetricHistogram* resumeFirstFrame = Metrics::getInstance()->histogram("resume_first_frame_us");
+    resumeFirstFrame->record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _resumedAt).count());
+}
+
+SessionManager::Stats SessionManager::getStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void SessionManager::workerLoop()
+{
+    static MetricCounter* debounced = Metrics::getInstance()->counter("session_debounced");
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    uint64_t applied = 0;
+    for (;;)
+    {
+        _cond.wait(lock, [this, &applied]() {
+            return _transitions != applied;
+        });
+
+        // settle: act only once no transition has come in for debounceMs
+        for (;;)
+        {
+            uint64_t seen = _transitions;
+            if (!_cond.wait_for(lock, std::chrono::milliseconds(_debounceMs), [this, seen]() {
+                return _transitions != seen;
+            }))
+            {
+                break;
+            }
+        }
+
+        bool background = _background;
+        bool changed = background != _appliedBackground;
+        uint64_t undone = _transitions - applied - (changed ? 1 : 0);
+        applied = _transitions;
+        _stats.debounced += undone;
+        debounced->add(undone);
+        if (!changed)
+        {
+            continue;
+        }
+
+        uint32_t ready = _readyMask;
+        lock.unlock();
+        if (background)
+        {
+            enterBackground(ready);
+        }
+        else
+        {
+            enterForeground(ready);
+        }
+        lock.lock();
+
+        _appliedBackground = background;
+    }
+}
+
+// worker thread
+void SessionManager::enterBackground(uint32_t ready)
+{
+    int budgetMs;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        budgetMs = _flushBudgetMs;
+    }
+
+    // events ahead of the session end, as far as the budget allows
+    Clock::time_point begin = Clock::now();
+    bool flushed = AnalyticsPipeline::getInstance()->flushAndWait(budgetMs);
+    double flushMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    if (isReady(ready, SdkPlugin::GoogleAnalytics))
+    {
+        sdkbox::PluginGoogleAnalytics::dispatchHits();
+    }
+    if (isReady(ready, SdkPlugin::FlurryAnalytics))
+    {
+        sdkbox::PluginFlurryAnalytics::pauseBackgroundSession();
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+        sdkbox::PluginFlurryAnalytics::endSession();
+#endif
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.backgrounds++;
+    _stats.lastFlushMs = flushMs;
+    if (!flushed)
+    {
+        _stats.flushTimeouts++;
+        CCLOG("[SessionManager] analytics flush did not finish in %d ms", budgetMs);
+    }
+}
+
+// worker thread
+void SessionManager::enterForeground(uint32_t ready)
+{
+    if (isReady(ready, SdkPlugin::Tune))
+    {
+        sdkbox::PluginTune::measureSession();
+    }
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    if (isReady(ready, SdkPlugin::FlurryAnalytics))
+    {
+        sdkbox::PluginFlurryAnalytics::startSession();
+    }
+#endif
+    DeviceIdentifiers::getInstance()->refreshIfTrackingChanged();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.foregrounds++;
+}
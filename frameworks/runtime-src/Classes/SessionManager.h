@@ -0,0 +1,108 @@
+//
+//  SessionManager.h
+//  template
+//
+//
+//
+
+#ifndef __template__SessionManager__
+#define __template__SessionManager__
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include "PluginEventBus.h"
+
+namespace cocos2d
+{
+    class EventListenerCustom;
+}
+
+/**
+ * Starts and stops the analytics SDK sessions as the app goes to the
+ * background and comes back, off the GL thread.
+ *
+ * onBackground() and onForeground() only note the new state; a worker
+ * thread acts on it once it has held for debounceMs, so a quick
+ * background/foreground flip makes no SDK calls at all. Then:
+ *
+ *   background   AnalyticsPipeline::flushAndWait(flushBudgetMs), then
+ *                GA dispatchHits(), Flurry pauseBackgroundSession() and,
+ *                on Android, Flurry endSession()
+ *   foreground   Tune measureSession() and, on Android, Flurry
+ *                startSession(); DeviceIdentifiers fetches again if the
+ *                ad tracking setting changed meanwhile
+ *
+ * Only providers passed to setProviderReady() are called. The Google
+ * Analytics session is left running, as its docs advise.
+ *
+ * Settings are the "session" block of the "analytics" section of
+ * sdkbox_config.json. Undone transitions are counted in getStats() and in
+ * the session_debounced counter, and the time from onForeground() to the
+ * end of the next frame goes to the resume_first_frame_us histogram.
+ */
+class SessionManager
+{
+public:
+    static const int kDefaultDebounceMs = 500;
+    static const int kDefaultFlushBudgetMs = 2000;
+
+    struct Stats
+    {
+        uint64_t backgrounds;
+        uint64_t foregrounds;
+        // transitions undone before they were acted on
+        uint64_t debounced;
+        // background flushes that ran out of budget
+        uint64_t flushTimeouts;
+        double lastFlushMs;
+    };
+
+    static SessionManager* getInstance();
+
+    // GL thread, before start()
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+    // GL thread, spawns the worker
+    void start();
+
+    // any thread
+    void setProviderReady(SdkPlugin provider);
+
+    // GL thread, from the AppDelegate callbacks; never block
+    void onBackground();
+    void onForeground();
+
+    Stats getStats();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    SessionManager();
+
+    void workerLoop();
+    void enterBackground(uint32_t ready);
+    void enterForeground(uint32_t ready);
+    void transition(bool background);
+    void onAfterDraw();
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    int _debounceMs;
+    int _flushBudgetMs;
+    bool _started;
+    uint32_t _readyMask;
+    // what the app is in, and what the SDKs were last told
+    bool _background;
+    bool _appliedBackground;
+    uint64_t _transitions;
+    Stats _stats;
+
+    // GL thread
+    cocos2d::EventListenerCustom* _listener;
+    bool _resuming;
+    Clock::time_point _resumedAt;
+};
+
+#endif /* defined(__template__SessionManager__) */
@@ -0,0 +1,177 @@
+//
+//  SmallFunction.h
+//  template
+//
+//
+//
+
+#ifndef __template__SmallFunction__
+#define __template__SmallFunction__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 32>
+class SmallFunction;
+
+/**
+ * std::function replacement that stores the callable inline.
+ *
+ * The callable must fit in Capacity bytes, which is checked at compile
+ * time, so constructing, copying and calling a SmallFunction never touches
+ * the heap.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class SmallFunction<R(Args...), Capacity>
+{
+public:
+    SmallFunction()
+    : _invoke(nullptr)
+    , _manage(nullptr)
+    {
+    }
+
+    SmallFunction(std::nullptr_t)
+    : _invoke(nullptr)
+    , _manage(nullptr)
+    {
+    }
+
+    template <typename F,
+              typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, SmallFunction>::value>::type>
+    SmallFunction(F&& f)
+    {
+        typedef typename std::decay<F>::type Functor;
+        static_assert(sizeof(Functor) <= Capacity, "callable too large for SmallFunction, raise Capacity");
+        static_assert(std::alignment_of<Functor>::value <= std::alignment_of<Storage>::value, "callable over-aligned for SmallFunction");
+
+        new (&_storage) Functor(std::forward<F>(f));
+        _invoke = &invokeImpl<Functor>;
+        _manage = &manageImpl<Functor>;
+    }
+
+    SmallFunction(const SmallFunction& other)
+    : _invoke(other._invoke)
+    , _manage(other._manage)
+    {
+        if (_manage)
+        {
+            _manage(kCopy, &_storage, const_cast<Storage*>(&other._storage));
+        }
+    }
+
+    SmallFunction(SmallFunction&& other)
+    : _invoke(other._invoke)
+    , _manage(other._manage)
+    {
+        if (_manage)
+        {
+            _manage(kMove, &_storage, &other._storage);
+        }
+        other._invoke = nullptr;
+        other._manage = nullptr;
+    }
+
+    ~SmallFunction()
+    {
+        reset();
+    }
+
+    SmallFunction& operator=(const SmallFunction& other)
+    {
+        if (this != &other)
+        {
+            SmallFunction tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SmallFunction& operator=(SmallFunction&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            _invoke = other._invoke;
+            _manage = other._manage;
+            if (_manage)
+            {
+                _manage(kMove, &_storage, &other._storage);
+            }
+            other._invoke = nullptr;
+            other._manage = nullptr;
+        }
+        return *this;
+    }
+
+    SmallFunction& operator=(std::nullptr_t)
+    {
+        reset();
+        return *this;
+    }
+
+    R operator()(Args... args) const
+    {
+        return _invoke(const_cast<Storage*>(&_storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return _invoke != nullptr;
+    }
+
+    void reset()
+    {
+        if (_manage)
+        {
+            _manage(kDestroy, &_storage, nullptr);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+
+private:
+    typedef typename std::aligned_storage<Capacity>::type Storage;
+
+    enum Op
+    {
+        kCopy,
+        kMove,
+        kDestroy
+    };
+
+    typedef R (*Invoke)(void*, Args&&...);
+    typedef void (*Manage)(Op, void*, void*);
+
+    template <typename Functor>
+    static R invokeImpl(void* storage, Args&&... args)
+    {
+        return (*static_cast<Functor*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename Functor>
+    static void manageImpl(Op op, void* dst, void* src)
+    {
+        switch (op)
+        {
+            case kCopy:
+                new (dst) Functor(*static_cast<const Functor*>(src));
+                break;
+            case kMove:
+                new (dst) Functor(std::move(*static_cast<Functor*>(src)));
+                static_cast<Functor*>(src)->~Functor();
+                break;
+            case kDestroy:
+                static_cast<Functor*>(dst)->~Functor();
+                break;
+        }
+    }
+
+    Storage _storage;
+    Invoke _invoke;
+    Manage _manage;
+};
+
+#endif /* defined(__template__SmallFunction__) */
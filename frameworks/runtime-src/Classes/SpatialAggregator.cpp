@@ -0,0 +1,450 @@
+//
+//  SpatialAggregator.cpp
+//  template
+//
+//
+//
+
+#include "SpatialAggregator.h"
+#include "AnalyticsPipeline.h"
+#include "cocos2d.h"
+#include "json/document.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPATIAL_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPATIAL_SSE2 1
+#endif
+
+USING_NS_CC;
+
+// positions binned per pass, on the stack
+static const size_t kBlock = 256;
+
+static void appendFloats(std::string& out, const float v[3])
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%g,%g,%g", v[0], v[1], v[2]);
+    out += buf;
+}
+
+// -1 outside [0, cells); NaN compares false and lands there too
+static inline int32_t cellOf(float v, float min, float scale, int cells)
+{
+    float t = (v - min) * scale;
+    if (!(t >= 0.0f && t < (float)cells))
+    {
+        return -1;
+    }
+    return (int32_t)t;
+}
+
+// the SIMD paths work out the index in floats, exact below 2^24 cells, and
+// agree with this one lane for lane
+static void binBlock(const float min[3], const float scale[3], const int cells[3],
+                     const float* xs, const float* ys, const float* zs, size_t n, int32_t* out)
+{
+    size_t i = 0;
+
+#if SPATIAL_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 minX = _mm_set1_ps(min[0]), minY = _mm_set1_ps(min[1]), minZ = _mm_set1_ps(min[2]);
+    const __m128 scaleX = _mm_set1_ps(scale[0]), scaleY = _mm_set1_ps(scale[1]), scaleZ = _mm_set1_ps(scale[2]);
+    const __m128 cellsX = _mm_set1_ps((float)cells[0]), cellsY = _mm_set1_ps((float)cells[1]), cellsZ = _mm_set1_ps((float)cells[2]);
+    const __m128i none = _mm_set1_epi32(-1);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 tx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(xs + i), minX), scaleX);
+        __m128 ty = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(ys + i), minY), scaleY);
+        __m128 tz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(zs + i), minZ), scaleZ);
+
+        __m128 inside = _mm_and_ps(_mm_cmpge_ps(tx, zero), _mm_cmplt_ps(tx, cellsX));
+        inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(ty, zero), _mm_cmplt_ps(ty, cellsY)));
+        inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(tz, zero), _mm_cmplt_ps(tz, cellsZ)));
+
+        // truncation is floor for the lanes that are inside
+        __m128 fx = _mm_cvtepi32_ps(_mm_cvttps_epi32(tx));
+        __m128 fy = _mm_cvtepi32_ps(_mm_cvttps_epi32(ty));
+        __m128 fz = _mm_cvtepi32_ps(_mm_cvttps_epi32(tz));
+        __m128 index = _mm_add_ps(fx, _mm_mul_ps(cellsX, _mm_add_ps(fy, _mm_mul_ps(cellsY, fz))));
+
+        __m128i mask = _mm_castps_si128(inside);
+        __m128i result = _mm_or_si128(_mm_and_si128(mask, _mm_cvttps_epi32(index)), _mm_andnot_si128(mask, none));
+        _mm_storeu_si128((__m128i*)(out + i), result);
+    }
+#elif SPATIAL_NEON
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t minX = vdupq_n_f32(min[0]), minY = vdupq_n_f32(min[1]), minZ = vdupq_n_f32(min[2]);
+    const float32x4_t scaleX = vdupq_n_f32(scale[0]), scaleY = vdupq_n_f32(scale[1]), scaleZ = vdupq_n_f32(scale[2]);
+    const float32x4_t cellsX = vdupq_n_f32((float)cells[0]), cellsY = vdupq_n_f32((float)cells[1]), cellsZ = vdupq_n_f32((float)cells[2]);
+    const int32x4_t none = vdupq_n_s32(-1);
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t tx = vmulq_f32(vsubq_f32(vld1q_f32(xs + i), minX), scaleX);
+        float32x4_t ty = vmulq_f32(vsubq_f32(vld1q_f32(ys + i), minY), scaleY);
+        float32x4_t tz = vmulq_f32(vsubq_f32(vld1q_f32(zs + i), minZ), scaleZ);
+
+        uint32x4_t inside = vandq_u32(vcgeq_f32(tx, zero), vcltq_f32(tx, cellsX));
+        inside = vandq_u32(inside, vandq_u32(vcgeq_f32(ty, zero), vcltq_f32(ty, cellsY)));
+        inside = vandq_u32(inside, vandq_u32(vcgeq_f32(tz, zero), vcltq_f32(tz, cellsZ)));
+
+        float32x4_t fx = vcvtq_f32_s32(vcvtq_s32_f32(tx));
+        float32x4_t fy = vcvtq_f32_s32(vcvtq_s32_f32(ty));
+        float32x4_t fz = vcvtq_f32_s32(vcvtq_s32_f32(tz));
+        float32x4_t index = vaddq_f32(fx, vmulq_f32(cellsX, vaddq_f32(fy, vmulq_f32(cellsY, fz))));
+
+        vst1q_s32(out + i, vbslq_s32(inside, vcvtq_s32_f32(index), none));
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        int32_t x = cellOf(xs[i], min[0], scale[0], cells[0]);
+        int32_t y = cellOf(ys[i], min[1], scale[1], cells[1]);
+        int32_t z = cellOf(zs[i], min[2], scale[2], cells[2]);
+        out[i] = (x < 0 || y < 0 || z < 0) ? -1 : x + cells[0] * (y + cells[1] * z);
+    }
+}
+
+SpatialAggregator::SpatialAggregator()
+: _started(false)
+, _intervalSec(60.0f)
+{
+    _stats.samples = 0;
+    _stats.outside = 0;
+    _stats.unbinned = 0;
+    _stats.events = 0;
+}
+
+SpatialAggregator* SpatialAggregator::getInstance()
+{
+    static SpatialAggregator *instance = 0;
+    if (!instance)
+    {
+        instance = new SpatialAggregator();
+    }
+    return instance;
+}
+
+void SpatialAggregator::start()
+{
+    if (_started)
+    {
+        return;
+    }
+    _started = true;
+
+    Director::getInstance()->getScheduler()->schedule([this](float) {
+        flush();
+    }, this, _intervalSec, false, "SpatialAggregator");
+}
+
+static bool readVector(const rapidjson::Value& grid, const char* key, double v[3])
+{
+    if (!grid.HasMember(key) || !grid[key].IsArray() || grid[key].Size() != 3)
+    {
+        return false;
+    }
+    const rapidjson::Value& array = grid[key];
+    for (rapidjson::SizeType i = 0; i < 3; i++)
+    {
+        if (!array[i].IsNumber())
+        {
+            return false;
+        }
+        v[i] = array[i].GetDouble();
+    }
+    return true;
+}
+
+void SpatialAggregator::loadConfig(const std::string& file)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string content = fileUtils->getStringFromFile(fileUtils->fullPathForFilename(file));
+    if (content.empty())
+    {
+        return;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse<0>(content.c_str()).HasParseError())
+    {
+        CCLOG("[SpatialAggregator] cannot parse %s: %s", file.c_str(), doc.GetParseError());
+        return;
+    }
+    if (!doc.IsObject() || !doc.HasMember("analytics") || !doc["analytics"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& analytics = doc["analytics"];
+    if (!analytics.HasMember("spatial") || !analytics["spatial"].IsObject())
+    {
+        return;
+    }
+
+    const rapidjson::Value& spatial = analytics["spatial"];
+    if (spatial.HasMember("flushIntervalSec") && spatial["flushIntervalSec"].IsNumber()
+        && spatial["flushIntervalSec"].GetDouble() > 0)
+    {
+        _intervalSec = (float)spatial["flushIntervalSec"].GetDouble();
+    }
+
+    if (!spatial.HasMember("grids") || !spatial["grids"].IsObject())
+    {
+        return;
+    }
+    const rapidjson::Value& grids = spatial["grids"];
+    for (auto it = grids.MemberonBegin(); it != grids.MemberonEnd(); ++it)
+    {
+        const char* title = it->name.GetString();
+        double min[3], max[3], cells[3];
+        if (!it->value.IsObject() || !readVector(it->value, "min", min) || !readVector(it->value, "max", max)
+            || !readVector(it->value, "cells", cells))
+        {
+            CCLOG("[SpatialAggregator] grid %s needs min, max and cells, each [x, y, z]", title);
+            continue;
+        }
+
+        float fmin[3], fmax[3];
+        int icells[3];
+        for (int i = 0; i < 3; i++)
+        {
+            fmin[i] = (float)min[i];
+            fmax[i] = (float)max[i];
+            icells[i] = (cells[i] >= 1 && cells[i] <= kMaxCells) ? (int)cells[i] : 0;
+        }
+        setGrid(title, fmin, fmax, icells);
+    }
+}
+
+bool SpatialAggregator::setGrid(const std::string& title, const float min[3], const float max[3], const int cells[3])
+{
+    int64_t total = 1;
+    for (int i = 0; i < 3; i++)
+    {
+        if (cells[i] < 1 || !(max[i] > min[i]) || !std::isfinite(min[i]) || !std::isfinite(max[i]))
+        {
+            CCLOG("[SpatialAggregator] invalid grid for %s", title.c_str());
+            return false;
+        }
+        total *= cells[i];
+        if (total > kMaxCells)
+        {
+            CCLOG("[SpatialAggregator] grid for %s is over %d cells", title.c_str(), kMaxCells);
+            return false;
+        }
+    }
+
+    auto it = _maps.find(title);
+    if (it == _maps.end() && _maps.size() >= kMaxTitles)
+    {
+        CCLOG("[SpatialAggregator] no room for a grid for %s", title.c_str());
+        return false;
+    }
+
+    Heatmap& map = _maps[title];
+    for (int i = 0; i < 3; i++)
+    {
+        map.min[i] = min[i];
+        map.cellSize[i] = (max[i] - min[i]) / cells[i];
+        map.scale[i] = cells[i] / (max[i] - min[i]);
+        map.cells[i] = cells[i];
+    }
+    map.counts.assign((size_t)total, 0);
+    map.hit.clear();
+    map.outside = 0;
+    return true;
+}
+
+SpatialAggregator::Heatmap* SpatialAggregator::find(const std::string& title)
+{
+    auto it = _maps.find(title);
+    if (it != _maps.end())
+    {
+        return &it->second;
+    }
+
+    auto fallback = _maps.find("*");
+    if (fallback == _maps.end() || _maps.size() >= kMaxTitles)
+    {
+        if (_warned.size() < kMaxTitles && _warned.insert(title).second)
+        {
+            CCLOG("[SpatialAggregator] no grid for %s, its positions are dropped", title.c_str());
+        }
+        return nullptr;
+    }
+
+    // rehashing invalidates iterators but not references
+    const Heatmap& grid = fallback->second;
+    Heatmap& map = _maps[title];
+    std::copy(grid.min, grid.min + 3, map.min);
+    std::copy(grid.cellSize, grid.cellSize + 3, map.cellSize);
+    std::copy(grid.scale, grid.scale + 3, map.scale);
+    std::copy(grid.cells, grid.cells + 3, map.cells);
+    map.counts.assign(grid.counts.size(), 0);
+    map.outside = 0;
+    return &map;
+}
+
+void SpatialAggregator::add(const std::string& title, float x, float y, float z)
+{
+    const float xyz[3] = { x, y, z };
+    add(title, xyz, 1);
+}
+
+void SpatialAggregator::add(const std::string& title, const float* xyz, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    _stats.samples += count;
+
+    Heatmap* map = find(title);
+    if (!map)
+    {
+        _stats.unbinned += count;
+        return;
+    }
+    bin(*map, xyz, count);
+}
+
+void SpatialAggregator::bin(Heatmap& map, const float* xyz, size_t count)
+{
+    float xs[kBlock], ys[kBlock], zs[kBlock];
+    int32_t indices[kBlock];
+
+    uint64_t outside = 0;
+    for (size_t done = 0; done < count; done += kBlock)
+    {
+        size_t n = std::min(kBlock, count - done);
+        const float* p = xyz + done * 3;
+        for (size_t i = 0; i < n; i++)
+        {
+            xs[i] = p[i * 3];
+            ys[i] = p[i * 3 + 1];
+            zs[i] = p[i * 3 + 2];
+        }
+
+        binBlock(map.min, map.scale, map.cells, xs, ys, zs, n, indices);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            int32_t index = indices[i];
+            if (index < 0)
+            {
+                outside++;
+                continue;
+            }
+            uint32_t& cell = map.counts[index];
+            if (cell == 0)
+            {
+                map.hit.push_back(index);
+            }
+            if (cell != UINT32_MAX)
+            {
+                cell++;
+            }
+        }
+    }
+    map.outside += outside;
+    _stats.outside += outside;
+}
+
+void SpatialAggregator::flush()
+{
+    for (auto it = _maps.begin(); it != _maps.end(); ++it)
+    {
+        if (it->first != "*")
+        {
+            flush(it->first, it->second);
+        }
+    }
+}
+
+void SpatialAggregator::flush(const std::string& title, Heatmap& map)
+{
+    if (map.hit.empty() && map.outside == 0)
+    {
+        return;
+    }
+
+    auto analytics = AnalyticsPipeline::getInstance();
+    const std::vector<uint32_t>& counts = map.counts;
+    std::vector<int32_t>& hit = map.hit;
+
+    // the fullest cells first, for the hotspots, then in index order
+    size_t hotspots = hit.size() < kHotspots ? hit.size() : kHotspots;
+    std::partial_sort(hit.begin(), hit.begin() + hotspots, hit.end(), [&counts](int32_t a, int32_t b) {
+        return counts[a] > counts[b] || (counts[a] == counts[b] && a < b);
+    });
+    for (size_t i = 0; i < hotspots; i++)
+    {
+        int32_t index = hit[i];
+        int x = index % map.cells[0];
+        int y = (index / map.cells[0]) % map.cells[1];
+        int z = index / (map.cells[0] * map.cells[1]);
+        analytics->kochavaSpatialEvent(title,
+                                       map.min[0] + (x + 0.5f) * map.cellSize[0],
+                                       map.min[1] + (y + 0.5f) * map.cellSize[1],
+                                       map.min[2] + (z + 0.5f) * map.cellSize[2]);
+        _stats.events++;
+    }
+    std::sort(hit.begin(), hit.end());
+
+    std::string min, cellSize;
+    appendFloats(min, map.min);
+    appendFloats(cellSize, map.cellSize);
+    char cells[48];
+    snprintf(cells, sizeof(cells), "%d,%d,%d", map.cells[0], map.cells[1], map.cells[2]);
+
+    size_t parts = std::max<size_t>(1, (hit.size() + kCellsPerEvent - 1) / kCellsPerEvent);
+    for (size_t part = 0; part < parts; part++)
+    {
+        EventParams params;
+        params.set("title", title.c_str());
+        params.set("min", min.c_str());
+        params.set("cell", cellSize.c_str());
+        params.set("cells", cells);
+
+        std::string list;
+        size_t end = std::min(hit.size(), (part + 1) * kCellsPerEvent);
+        for (size_t i = part * kCellsPerEvent; i < end; i++)
+        {
+            char buf[24];
+            snprintf(buf, sizeof(buf), "%s%d:%u", list.empty() ? "" : ",", hit[i], counts[hit[i]]);
+            list += buf;
+        }
+        params.set("counts", list.c_str());
+
+        char buf[24];
+        if (parts > 1)
+        {
+            snprintf(buf, sizeof(buf), "%u/%u", (unsigned)(part + 1), (unsigned)parts);
+            params.set("part", buf);
+        }
+        if (part == 0 && map.outside > 0)
+        {
+            snprintf(buf, sizeof(buf), "%llu", (unsigned long long)map.outside);
+            params.set("outside", buf);
+        }
+        analytics->kochavaTrackEvent("spatial_heatmap", params.toJson());
+        _stats.events++;
+    }
+
+    CCLOG("[SpatialAggregator] %s: %u cells, %llu outside, %u events",
+          title.c_str(), (unsigned)hit.size(), (unsigned long long)map.outside, (unsigned)(hotspots + parts));
+
+    for (size_t i = 0; i < hit.size(); i++)
+    {
+        map.counts[hit[i]] = 0;
+    }
+    hit.clear();
+    map.outside = 0;
+}
@@ -0,0 +1,103 @@
+//
+//  SpatialAggregator.h
+//  template
+//
+//
+//
+
+#ifndef __template__SpatialAggregator__
+#define __template__SpatialAggregator__
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Heat maps in place of one PluginKochava::spatialEvent() per position.
+ *
+ * Positions are binned into a 3D grid per title and only the cells that
+ * were hit go out, on every flush:
+ *
+ *   Kochava  trackEvent("spatial_heatmap", {"title", "min", "cell",
+ *            "cells": "nx,ny,nz", "counts": "<index>:<count>,..."}), in
+ *            chunks of kCellsPerEvent cells; index = x + nx * (y + ny * z)
+ *   Kochava  spatialEvent(<title>, centre) for the kHotspots fullest cells,
+ *            spatialEvent() having no count of its own
+ *
+ * Grids come from the "spatial" block of the "analytics" section of
+ * sdkbox_config.json, or from setGrid(). The grid named "*" is copied for
+ * titles without one of their own. Positions for a title with no grid at
+ * all, or past kMaxTitles titles, are dropped and counted in
+ * Stats::unbinned. Positions outside the grid, NaN included, are counted
+ * per title and sent as "outside".
+ *
+ * add() takes positions as x, y, z triples. Batches are binned four at a
+ * time with SSE2 or NEON where the target has it.
+ *
+ * GL thread only.
+ */
+class SpatialAggregator
+{
+public:
+    static const int kMaxCells = 1 << 18;
+    static const size_t kMaxTitles = 32;
+    static const size_t kCellsPerEvent = 256;
+    static const size_t kHotspots = 4;
+
+    struct Stats
+    {
+        uint64_t samples;
+        uint64_t outside;
+        uint64_t unbinned;
+        uint64_t events;
+    };
+
+    static SpatialAggregator* getInstance();
+
+    // once the Director exists, flushes every "flushIntervalSec" of the
+    // config, 60 by default
+    void start();
+    void loadConfig(const std::string& file = "sdkbox_config.json");
+
+    // min and max are the corners of the grid, cells its size in cells on
+    // each axis; replaces the grid of the title and drops what it held
+    bool setGrid(const std::string& title, const float min[3], const float max[3], const int cells[3]);
+
+    // xyz holds count positions
+    void add(const std::string& title, const float* xyz, size_t count);
+    void add(const std::string& title, float x, float y, float z);
+
+    void flush();
+
+    Stats getStats() const { return _stats; }
+
+private:
+    struct Heatmap
+    {
+        float min[3];
+        float cellSize[3];
+        // 1 / cellSize, the binning multiplies
+        float scale[3];
+        int cells[3];
+        std::vector<uint32_t> counts;
+        // indices of the non-zero counts, in the order they were first hit
+        std::vector<int32_t> hit;
+        uint64_t outside;
+    };
+
+    SpatialAggregator();
+
+    Heatmap* find(const std::string& title);
+    void bin(Heatmap& map, const float* xyz, size_t count);
+    void flush(const std::string& title, Heatmap& map);
+
+    bool _started;
+    float _intervalSec;
+    std::unordered_map<std::string, Heatmap> _maps;
+    std::unordered_set<std::string> _warned;
+    Stats _stats;
+};
+
+#endif /* defined(__template__SpatialAggregator__) */
@@ -0,0 +1,119 @@
+//
+//  StringInterner.cpp
+//  template
+//
+//
+//
+
+#include "StringInterner.h"
+#include "cocos2d.h"
+
+const size_t StringInterner::kSlots;
+const size_t StringInterner::kMaxStrings;
+
+StringInterner::StringInterner()
+: _slots(new std::atomic<Entry*>[kSlots])
+, _size(0)
+, _fullLogged(false)
+{
+    for (size_t i = 0; i < kSlots; i++)
+    {
+        _slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+StringInterner* StringInterner::getInstance()
+{
+    static StringInterner *instance = 0;
+    if (!instance)
+    {
+        instance = new StringInterner();
+    }
+    return instance;
+}
+
+// FNV-1a
+uint32_t StringInterner::hash(StringRef s)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < s.size; i++)
+    {
+        h ^= (unsigned char)s.data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool StringInterner::matches(const Entry* entry, uint32_t h, StringRef s)
+{
+    return entry->hash == h
+        && entry->str.size() == s.size
+        && memcmp(entry->str.data(), s.data, s.size) == 0;
+}
+
+InternedString StringInterner::find(StringRef s) const
+{
+    uint32_t h = hash(s);
+    for (size_t n = 0, i = h & (kSlots - 1); n < kSlots; n++, i = (i + 1) & (kSlots - 1))
+    {
+        const Entry* entry = _slots[i].load(std::memory_order_acquire);
+        if (!entry)
+        {
+            return InternedString();
+        }
+        if (matches(entry, h, s))
+        {
+            return InternedString(&entry->str);
+        }
+    }
+    return InternedString();
+}
+
+InternedString StringInterner::intern(StringRef s)
+{
+    uint32_t h = hash(s);
+    Entry* created = nullptr;
+    for (size_t n = 0, i = h & (kSlots - 1); n < kSlots; n++, i = (i + 1) & (kSlots - 1))
+    {
+        Entry* entry = _slots[i].load(std::memory_order_acquire);
+        if (!entry)
+        {
+            if (!created)
+            {
+                if (_size.fetch_add(1, std::memory_order_relaxed) >= kMaxStrings)
+                {
+                    _size.fetch_sub(1, std::memory_order_relaxed);
+                    if (!_fullLogged.exchange(true))
+                    {
+                        CCLOG("[StringInterner] table full at %d strings, no longer interning", (int)kMaxStrings);
+                    }
+                    return InternedString();
+                }
+                created = new Entry(h, s.data, s.size);
+            }
+            if (_slots[i].compare_exchange_strong(entry, created, std::memory_order_acq_rel))
+            {
+                return InternedString(&created->str);
+            }
+            // another thread took the slot first, entry is now what it stored
+        }
+        if (matches(entry, h, s))
+        {
+            if (created)
+            {
+                // lost the race for the same string
+                delete created;
+                _size.fetch_sub(1, std::memory_order_relaxed);
+            }
+            return InternedString(&entry->str);
+        }
+    }
+
+    // unreachable while kMaxStrings < kSlots
+    if (created)
+    {
+        delete created;
+        _size.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return InternedString();
+}
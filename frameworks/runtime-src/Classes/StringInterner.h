@@ -0,0 +1,105 @@
+//
+//  StringInterner.h
+//  template
+//
+//
+//
+
+#ifndef __template__StringInterner__
+#define __template__StringInterner__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+/**
+ * Non-owning view of a string, for call sites that only look a string up.
+ * Converts implicitly from literals and std::string so it can stand in for
+ * `const std::string&` without building a temporary.
+ */
+struct StringRef
+{
+    StringRef() : data(""), size(0) {}
+    StringRef(const char* s) : data(s), size(strlen(s)) {}
+    StringRef(const char* s, size_t length) : data(s), size(length) {}
+    StringRef(const std::string& s) : data(s.data()), size(s.size()) {}
+
+    const char* data;
+    size_t size;
+};
+
+/**
+ * Handle to a string owned by StringInterner. Two handles are equal when
+ * they name the same string, and str() stays valid for the life of the
+ * process, so a handle can be kept in a static and passed around freely.
+ *
+ * A default-constructed handle is null; intern() also returns null once the
+ * table is full, and callers fall back to passing the string itself.
+ */
+class InternedString
+{
+public:
+    InternedString() : _str(nullptr) {}
+
+    explicit operator bool() const { return _str != nullptr; }
+    const std::string& str() const { return *_str; }
+
+    bool operator==(const InternedString& other) const { return _str == other._str; }
+    bool operator!=(const InternedString& other) const { return _str != other._str; }
+
+private:
+    friend class StringInterner;
+    explicit InternedString(const std::string* str) : _str(str) {}
+
+    const std::string* _str;
+};
+
+/**
+ * Process-wide, append-only table of the strings analytics calls repeat:
+ * Google Analytics categories, actions, labels and screen names.
+ *
+ * Each distinct string is copied once and never freed. Lookups are
+ * lock-free and insertions use a CAS on the slot, so intern() can be
+ * called from any thread. The table has a fixed number of slots; past
+ * kMaxStrings it stops growing rather than let a high-cardinality label
+ * (a user id, a timestamp) eat memory for the rest of the session.
+ */
+class StringInterner
+{
+public:
+    static const size_t kSlots = 4096;
+    static const size_t kMaxStrings = kSlots * 3 / 4;
+
+    static StringInterner* getInstance();
+
+    InternedString intern(StringRef s);
+    // null when the string was never interned, never inserts
+    InternedString find(StringRef s) const;
+
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+    // FNV-1a, the same hash the table uses
+    static uint32_t hash(StringRef s);
+
+private:
+    StringInterner();
+
+    struct Entry
+    {
+        Entry(uint32_t h, const char* data, size_t length) : hash(h), str(data, length) {}
+
+        uint32_t hash;
+        std::string str;
+    };
+
+    static bool matches(const Entry* entry, uint32_t h, StringRef s);
+
+    std::unique_ptr<std::atomic<Entry*>[]> _slots;
+    std::atomic<size_t> _size;
+    std::atomic<bool> _fullLogged;
+};
+
+#endif /* defined(__template__StringInterner__) */
@@ -0,0 +1,313 @@
+//
+//  UserProfile.cpp
+//  template
+//
+//
+//
+
+#include "UserProfile.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+#include "PluginAdColony/PluginAdColony.h"
+#include "PluginChartboost/PluginChartboost.h"
+#include "PluginFlurryAnalytics/PluginFlurryAnalytics.h"
+#include "PluginTune/PluginTune.h"
+
+USING_NS_CC;
+
+static uint32_t bit(UserProfile::Field field)
+{
+    return 1u << field;
+}
+
+UserProfile::UserProfile()
+: _pushing(false)
+, _pushCount(0)
+{
+    const SdkPlugin plugins[kProviderCount] = {
+        SdkPlugin::Tune, SdkPlugin::FlurryAnalytics, SdkPlugin::AdColony, SdkPlugin::Chartboost
+    };
+    const uint32_t fields[kProviderCount] = {
+        (1u << kFieldCount) - 1,
+        bit(kUserId) | bit(kAge) | bit(kGender) | bit(kLocation),
+        bit(kUserId),
+        bit(kUserId)
+    };
+    for (int i = 0; i < kProviderCount; i++)
+    {
+        _providers[i].plugin = plugins[i];
+        _providers[i].fields = fields[i];
+        _providers[i].ready = false;
+    }
+}
+
+UserProfile* UserProfile::getInstance()
+{
+    static UserProfile *instance = 0;
+    if (!instance)
+    {
+        instance = new UserProfile();
+    }
+    return instance;
+}
+
+void UserProfile::setAge(int age)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", age);
+    set(kAge, buf);
+}
+
+void UserProfile::setGender(Gender gender)
+{
+    set(kGender, gender == kGenderMale ? "m" : (gender == kGenderFemale ? "f" : ""));
+}
+
+void UserProfile::setLocation(double latitude, double longitude, double altitude,
+                              float horizontalAccuracy, float verticalAccuracy)
+{
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%.6f,%.6f,%.2f,%.1f,%.1f", latitude, longitude, altitude,
+             horizontalAccuracy, verticalAccuracy);
+    set(kLocation, buf);
+}
+
+void UserProfile::clearLocation()
+{
+    std::lock_guard<std::mutex> applying(_applyMutex);
+    bool flurryReady;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _values[kLocation].clear();
+        for (int i = 0; i < kProviderCount; i++)
+        {
+            _providers[i].pushed[kLocation].clear();
+        }
+        flurryReady = find(SdkPlugin::FlurryAnalytics)->ready;
+    }
+    if (flurryReady)
+    {
+        sdkbox::PluginFlurryAnalytics::clearLocation();
+    }
+}
+
+void UserProfile::set(Field field, const std::string& value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_values[field] == value)
+    {
+        return;
+    }
+    _values[field] = value;
+    schedule();
+}
+
+std::string UserProfile::get(Field field)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _values[field];
+}
+
+UserProfile::Provider* UserProfile::find(SdkPlugin plugin)
+{
+    for (int i = 0; i < kProviderCount; i++)
+    {
+        if (_providers[i].plugin == plugin)
+        {
+            return &_providers[i];
+        }
+    }
+    return nullptr;
+}
+
+void UserProfile::setProviderReady(SdkPlugin plugin)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Provider* provider = find(plugin);
+    if (provider && !provider->ready)
+    {
+        provider->ready = true;
+        schedule();
+    }
+}
+
+void UserProfile::resend(SdkPlugin plugin)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Provider* provider = find(plugin);
+    if (provider)
+    {
+        for (int f = 0; f < kFieldCount; f++)
+        {
+            provider->pushed[f].clear();
+        }
+        schedule();
+    }
+}
+
+void UserProfile::pushNow(SdkPlugin plugin)
+{
+    std::lock_guard<std::mutex> applying(_applyMutex);
+    std::vector<Push> pushes;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Provider* provider = find(plugin);
+        if (!provider)
+        {
+            return;
+        }
+        provider->ready = true;
+        collect(provider, pushes);
+    }
+    apply(pushes);
+}
+
+unsigned UserProfile::getPushCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pushCount;
+}
+
+// with _mutex held; the thread picks up whatever changes until it finds
+// nothing left to push
+void UserProfile::schedule()
+{
+    if (_pushing)
+    {
+        return;
+    }
+    _pushing = true;
+    std::thread([this]() {
+        pushPending();
+    }).detach();
+}
+
+void UserProfile::collect(const Provider* only, std::vector<Push>& pushes)
+{
+    for (int i = 0; i < kProviderCount; i++)
+    {
+        const Provider& provider = _providers[i];
+        if (!provider.ready || (only && only != &provider))
+        {
+            continue;
+        }
+        for (int f = 0; f < kFieldCount; f++)
+        {
+            if ((provider.fields & bit((Field)f)) && !_values[f].empty() && _values[f] != provider.pushed[f])
+            {
+                Push push = { i, (Field)f, _values[f] };
+                pushes.push_back(push);
+            }
+        }
+    }
+}
+
+void UserProfile::pushPending()
+{
+    std::vector<Push> pushes;
+    for (;;)
+    {
+        std::lock_guard<std::mutex> applying(_applyMutex);
+        pushes.clear();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            collect(nullptr, pushes);
+            if (pushes.empty())
+            {
+                _pushing = false;
+                return;
+            }
+        }
+        apply(pushes);
+    }
+}
+
+// with _applyMutex held
+void UserProfile::apply(const std::vector<Push>& pushes)
+{
+    if (pushes.empty())
+    {
+        return;
+    }
+    for (auto& push : pushes)
+    {
+        apply(_providers[push.provider].plugin, push.field, push.value);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto& push : pushes)
+        {
+            _providers[push.provider].pushed[push.field] = push.value;
+        }
+        _pushCount += (unsigned)pushes.size();
+    }
+    CCLOG("[UserProfile] pushed %u fields", (unsigned)pushes.size());
+}
+
+// background thread, or the pushNow() caller's
+void UserProfile::apply(SdkPlugin plugin, Field field, const std::string& value)
+{
+    switch (plugin)
+    {
+        case SdkPlugin::Tune:
+            switch (field)
+            {
+                case kEmail:          sdkbox::PluginTune::setUserEmail(value); break;
+                case kName:           sdkbox::PluginTune::setUserName(value); break;
+                case kAge:            sdkbox::PluginTune::setAge(atoi(value.c_str())); break;
+                case kGender:
+                    sdkbox::PluginTune::setGender(value == "m" ? sdkbox::PluginTune::GenderMale : sdkbox::PluginTune::GenderFemale);
+                    break;
+                case kUserId:         sdkbox::PluginTune::setUserId(value); break;
+                case kFacebookUserId: sdkbox::PluginTune::setFacebookUserId(value); break;
+                case kGoogleUserId:   sdkbox::PluginTune::setGoogleUserId(value); break;
+                case kTwitterUserId:  sdkbox::PluginTune::setTwitterUserId(value); break;
+                case kLocation:
+                {
+                    double latitude = 0, longitude = 0, altitude = 0;
+                    if (sscanf(value.c_str(), "%lf,%lf,%lf", &latitude, &longitude, &altitude) >= 3)
+                    {
+                        sdkbox::PluginTune::setLatitude(latitude, longitude, altitude);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        case SdkPlugin::FlurryAnalytics:
+            switch (field)
+            {
+                case kUserId:  sdkbox::PluginFlurryAnalytics::setUserID(value); break;
+                case kAge:     sdkbox::PluginFlurryAnalytics::setAge(atoi(value.c_str())); break;
+                case kGender:  sdkbox::PluginFlurryAnalytics::setGender(value); break;
+                case kLocation:
+                {
+                    double latitude = 0, longitude = 0, altitude = 0;
+                    float horizontal = 0, vertical = 0;
+                    if (sscanf(value.c_str(), "%lf,%lf,%lf,%f,%f", &latitude, &longitude, &altitude, &horizontal, &vertical) == 5)
+                    {
+                        sdkbox::PluginFlurryAnalytics::setLatitude(latitude, longitude, horizontal, vertical);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        case SdkPlugin::AdColony:
+            sdkbox::PluginAdColony::setCustomID(value);
+            break;
+        case SdkPlugin::Chartboost:
+            sdkbox::PluginChartboost::setCustomID(value);
+            break;
+        default:
+            break;
+    }
+}
+
@@ -0,0 +1,135 @@
+//
+//  UserProfile.h
+//  template
+//
+//
+//
+
+#ifndef __template__UserProfile__
+#define __template__UserProfile__
+
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "PluginEventBus.h"
+
+/**
+ * The user attributes the SDKs are told about, set once here instead of
+ * through each plugin's own setters.
+ *
+ *   Tune        every field
+ *   Flurry      user ID, age, gender, location
+ *   AdColony    user ID, as setCustomID()
+ *   Chartboost  user ID, as setCustomID()
+ *
+ * For each provider the store remembers what it pushed since launch, so a
+ * field goes out only when it differs from what that provider was last
+ * told. The SDKs do not keep these values between launches, so every
+ * launch sends them once. Pushes start once setProviderReady() has been
+ * called for the provider and run on a background thread; setters return
+ * immediately. pushNow() sends on the calling thread instead, for an SDK
+ * that has to have the profile before its next call. A field set back to
+ * empty is not pushed, the SDKs have no way to clear one; the location is
+ * the exception, see clearLocation().
+ *
+ * Live location fixes should go through LocationSink, which throttles them
+ * before they reach setLocation().
+ *
+ * An SDK that has lost its values (reinstalled, user logged out) can be
+ * sent everything again with resend().
+ *
+ * Any thread.
+ */
+class UserProfile
+{
+public:
+    enum Field
+    {
+        kEmail,
+        kName,
+        kAge,
+        kGender,
+        kUserId,
+        kFacebookUserId,
+        kGoogleUserId,
+        kTwitterUserId,
+        kLocation,
+        kFieldCount
+    };
+
+    enum Gender
+    {
+        kGenderUnknown,
+        kGenderMale,
+        kGenderFemale
+    };
+
+    static UserProfile* getInstance();
+
+    void setEmail(const std::string& email) { set(kEmail, email); }
+    void setName(const std::string& name) { set(kName, name); }
+    void setAge(int age);
+    void setGender(Gender gender);
+    void setUserId(const std::string& userId) { set(kUserId, userId); }
+    void setFacebookUserId(const std::string& userId) { set(kFacebookUserId, userId); }
+    void setGoogleUserId(const std::string& userId) { set(kGoogleUserId, userId); }
+    void setTwitterUserId(const std::string& userId) { set(kTwitterUserId, userId); }
+    void setLocation(double latitude, double longitude, double altitude,
+                     float horizontalAccuracy = 0, float verticalAccuracy = 0);
+    // Flurry is told to forget it too, Tune has no way to
+    void clearLocation();
+
+    std::string get(Field field);
+
+    void setProviderReady(SdkPlugin provider);
+    // setProviderReady(), with what the provider has not been told yet sent
+    // before it returns
+    void pushNow(SdkPlugin provider);
+    void resend(SdkPlugin provider);
+
+    // setter calls made on the SDKs since launch
+    unsigned getPushCount();
+
+private:
+    static const int kProviderCount = 4;
+
+    struct Provider
+    {
+        SdkPlugin plugin;
+        // bit per Field
+        uint32_t fields;
+        bool ready;
+        std::string pushed[kFieldCount];
+    };
+
+    struct Push
+    {
+        int provider;
+        Field field;
+        std::string value;
+    };
+
+    UserProfile();
+
+    void set(Field field, const std::string& value);
+    Provider* find(SdkPlugin plugin);
+    // with _mutex held
+    void schedule();
+    // with _mutex held; the ready providers, or only the one given
+    void collect(const Provider* only, std::vector<Push>& pushes);
+    void pushPending();
+    void apply(const std::vector<Push>& pushes);
+    static void apply(SdkPlugin plugin, Field field, const std::string& value);
+
+    // held from collecting a batch to recording it, so two batches never
+    // reach an SDK out of order
+    std::mutex _applyMutex;
+    std::mutex _mutex;
+    std::string _values[kFieldCount];
+    Provider _providers[kProviderCount];
+    bool _pushing;
+    unsigned _pushCount;
+};
+
+#endif /* defined(__template__UserProfile__) */
@@ -41,6 +41,7 @@
 
 // google analytics
 #include "jsbindings/PluginGoogleAnalyticsJS.hpp"
+#include "jsbindings/PluginGoogleAnalyticsJSHelper.h"
 
 // iap
 #include "jsbindings/PluginIAPJS.hpp"
@@ -48,6 +49,7 @@
 
 // kochava
 #include "jsbindings/PluginKochavaJS.hpp"
+#include "jsbindings/PluginKochavaJSHelper.h"
 
 // tune
 #include "jsbindings/PluginTuneJS.hpp"
@@ -57,6 +59,15 @@
 #include "jsbindings/PluginVungleJS.hpp"
 #include "jsbindings/PluginVungleJSHelper.h"
 
+// metrics
+#include "jsbindings/MetricsJSHelper.h"
+
+// spatial heat maps
+#include "jsbindings/SpatialAggregatorJSHelper.h"
+
+// analytics event catalog
+#include "jsbindings/AnalyticsCatalogJSHelper.h"
+
 //// facebook
 //#include "jsbindings/PluginFacebookJS.hpp"
 //#include "jsbindings/PluginFacebookJSHelper.h"
@@ -126,6 +137,7 @@ int js_module_register()
 
     // google analytics
     sc->addRegisterCallback(register_all_PluginGoogleAnalyticsJS);
+    sc->addRegisterCallback(register_PluginGoogleAnalyticsJs_helper);
 
     // iap
     sc->addRegisterCallback(register_all_PluginIAPJS);
@@ -133,6 +145,7 @@ int js_module_register()
 
     // kochava
     sc->addRegisterCallback(register_all_PluginKochavaJS);
+    sc->addRegisterCallback(register_PluginKochavaJs_helper);
 
     // tune
     sc->addRegisterCallback(register_all_PluginTuneJS);
@@ -142,6 +155,15 @@ int js_module_register()
     sc->addRegisterCallback(register_all_PluginVungleJS);
     sc->addRegisterCallback(register_PluginVungleJs_helper);
 
+    // metrics
+    sc->addRegisterCallback(register_all_MetricsJS_helper);
+
+    // spatial heat maps
+    sc->addRegisterCallback(register_all_SpatialAggregatorJS_helper);
+
+    // analytics event catalog
+    sc->addRegisterCallback(register_all_AnalyticsCatalogJS_helper);
+
 //    // facebook
 //    sc->addRegisterCallback(register_all_PluginFacebookJS);
 //    sc->addRegisterCallback(register_PluginFacebookJs_helper);
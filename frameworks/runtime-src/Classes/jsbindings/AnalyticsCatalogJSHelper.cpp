@@ -0,0 +1,74 @@
+#include "AnalyticsCatalogJSHelper.h"
+#include "cocos2d_specifics.hpp"
+#include "AnalyticsCatalog.h"
+
+// sdkbox.AnalyticsCatalog.<Id>(params...), one function per catalog event,
+// params in the order of the catalog; returns the number of providers the
+// event was queued for
+static bool js_AnalyticsCatalogJS_emitEvent(JSContext *cx, uint32_t argc, jsval *vp, AnalyticsCatalog::EventId id)
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    const CatalogEventSpec& spec = AnalyticsCatalog::getSpec(id);
+    bool ok = true;
+    if (argc == spec.paramCount) {
+        CatalogValue values[AnalyticsCatalog::kMaxParams];
+        std::string strings[AnalyticsCatalog::kMaxParams];
+        for (uint32_t i = 0; i < argc && ok; i++) {
+            double d = 0;
+            switch (spec.params[i].type) {
+                case CatalogType::Int:
+                    ok &= sdkbox::js_to_number(cx, args.get(i), &d);
+                    values[i] = CatalogValue((int)d);
+                    break;
+                case CatalogType::Double:
+                    ok &= sdkbox::js_to_number(cx, args.get(i), &d);
+                    values[i] = CatalogValue(d);
+                    break;
+                case CatalogType::Bool:
+                    values[i] = CatalogValue((bool)JS::ToBoolean(args.get(i)));
+                    break;
+                case CatalogType::String:
+                    ok &= jsval_to_std_string(cx, args.get(i), &strings[i]);
+                    values[i] = CatalogValue(StringRef(strings[i]));
+                    break;
+            }
+        }
+        JSB_PRECONDITION2(ok, cx, false, "js_AnalyticsCatalogJS_emit : Error processing arguments");
+        int ret = AnalyticsCatalog::emit(id, values, argc);
+        args.rval().set(INT_TO_JSVAL(ret));
+        return true;
+    }
+    JS_ReportError(cx, "js_AnalyticsCatalogJS_emit : %s takes %u arguments", spec.id, spec.paramCount);
+    return false;
+}
+
+template <int Id>
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_AnalyticsCatalogJS_emit(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_AnalyticsCatalogJS_emit(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    return js_AnalyticsCatalogJS_emitEvent(cx, argc, vp, (AnalyticsCatalog::EventId)Id);
+}
+
+#define SDKBOX_CATALOG_JS_FUNCTION(id, name, category, providers, params) \
+    JS_DefineFunction(cx, pluginObj, #id, js_AnalyticsCatalogJS_emit<AnalyticsCatalog::k##id>, \
+                      AnalyticsCatalog::getSpec(AnalyticsCatalog::k##id).paramCount, JSPROP_READONLY | JSPROP_PERMANENT);
+
+#if MOZJS_MAJOR_VERSION >= 31
+void register_all_AnalyticsCatalogJS_helper(JSContext* cx, JS::HandleObject global) {
+    JS::RootedObject pluginObj(cx);
+    sdkbox::getJsObjOrCreat(cx, global, "sdkbox.AnalyticsCatalog", &pluginObj);
+
+    SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_JS_FUNCTION, SDKBOX_CATALOG_NO_PARAM)
+}
+#else
+void register_all_AnalyticsCatalogJS_helper(JSContext* cx, JSObject* global) {
+    jsval pluginVal;
+    JSObject* pluginObj;
+    pluginVal = sdkbox::getJsObjOrCreat(cx, global, "sdkbox.AnalyticsCatalog", &pluginObj);
+
+    SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_JS_FUNCTION, SDKBOX_CATALOG_NO_PARAM)
+}
+#endif
@@ -0,0 +1,10 @@
+#ifndef __ANALYTICS_CATALOG_JS_HELPER_H__
+#define __ANALYTICS_CATALOG_JS_HELPER_H__
+
+#include "jsapi.h"
+#include "jsfriendapi.h"
+#include "SDKBoxJSHelper.h"
+
+void register_all_AnalyticsCatalogJS_helper(JSContext* cx, one_JSObject global);
+
+#endif /* defined(__ANALYTICS_CATALOG_JS_HELPER_H__) */
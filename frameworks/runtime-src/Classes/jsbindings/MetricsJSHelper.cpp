@@ -0,0 +1,114 @@
+#include "MetricsJSHelper.h"
+#include "cocos2d_specifics.hpp"
+#include "Metrics.h"
+
+// sdkbox.Metrics.increment(name[, delta])
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_MetricsJS_increment(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_MetricsJS_increment(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 1 || argc == 2) {
+        std::string arg0;
+        long long arg1 = 1;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        if (argc == 2) {
+            ok &= jsval_to_long_long(cx, args.get(1), &arg1);
+        }
+        JSB_PRECONDITION2(ok, cx, false, "js_MetricsJS_increment : Error processing arguments");
+        Metrics::getInstance()->increment(arg0, arg1);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_MetricsJS_increment : wrong number of arguments");
+    return false;
+}
+
+// sdkbox.Metrics.setGauge(name, value)
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_MetricsJS_setGauge(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_MetricsJS_setGauge(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        long long arg1;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_long_long(cx, args.get(1), &arg1);
+        JSB_PRECONDITION2(ok, cx, false, "js_MetricsJS_setGauge : Error processing arguments");
+        Metrics::getInstance()->setGauge(arg0, arg1);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_MetricsJS_setGauge : wrong number of arguments");
+    return false;
+}
+
+// sdkbox.Metrics.record(name, value), adds a sample to a histogram
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_MetricsJS_record(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_MetricsJS_record(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        long long arg1;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_long_long(cx, args.get(1), &arg1);
+        JSB_PRECONDITION2(ok, cx, false, "js_MetricsJS_record : Error processing arguments");
+        Metrics::getInstance()->record(arg0, arg1);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_MetricsJS_record : wrong number of arguments");
+    return false;
+}
+
+// sdkbox.Metrics.flush()
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_MetricsJS_flush(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_MetricsJS_flush(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        Metrics::getInstance()->flush();
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_MetricsJS_flush : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+void register_all_MetricsJS_helper(JSContext* cx, JS::HandleObject global) {
+    JS::RootedObject pluginObj(cx);
+    sdkbox::getJsObjOrCreat(cx, global, "sdkbox.Metrics", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "increment", js_MetricsJS_increment, 2, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "setGauge", js_MetricsJS_setGauge, 2, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "record", js_MetricsJS_record, 2, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "flush", js_MetricsJS_flush, 0, JSPROP_READONLY | JSPROP_PERMANENT);
+}
+#else
+void register_all_MetricsJS_helper(JSContext* cx, JSObject* global) {
+    jsval pluginVal;
+    JSObject* pluginObj;
+    pluginVal = sdkbox::getJsObjOrCreat(cx, global, "sdkbox.Metrics", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "increment", js_MetricsJS_increment, 2, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "setGauge", js_MetricsJS_setGauge, 2, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "record", js_MetricsJS_record, 2, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "flush", js_MetricsJS_flush, 0, JSPROP_READONLY | JSPROP_PERMANENT);
+}
+#endif
@@ -0,0 +1,10 @@
+#ifndef __METRICS_JS_HELPER_H__
+#define __METRICS_JS_HELPER_H__
+
+#include "jsapi.h"
+#include "jsfriendapi.h"
+#include "SDKBoxJSHelper.h"
+
+void register_all_MetricsJS_helper(JSContext* cx, one_JSObject global);
+
+#endif /* defined(__METRICS_JS_HELPER_H__) */
@@ -1,6 +1,8 @@
 #include "PluginAdColonyJSHelper.hpp"
 #include "cocos2d_specifics.hpp"
 #include "PluginAdColony/PluginAdColony.h"
+#include "DeviceIdentifiers.h"
+#include "MainThreadQueue.h"
 #include "SDKBoxJSHelper.h"
 
 extern JSObject* jsb_sdkbox_PluginAdColony_prototype;
@@ -103,176 +105,184 @@ public:
     
     void onAdColonyChange(const sdkbox::AdColonyAdInfo& info, bool available)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onAdColonyChange";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onAdColonyChange";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[2];
+            jsval dataVal[2];
+
+            jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+            dataVal[1] = BOOLEAN_TO_JSVAL(available);
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
-        
-        dataVal[0] = value;
-        dataVal[1] = BOOLEAN_TO_JSVAL(available);
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onAdColonyReward(const sdkbox::AdColonyAdInfo& info, const std::string& currencyName, int amount, bool success)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onAdColonyReward";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onAdColonyReward";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[4];
-        jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
-        dataVal[0] = value;
-        dataVal[1] = std_string_to_jsval(cx, currencyName);
-        dataVal[2] = INT_TO_JSVAL(amount);
-        dataVal[3] = BOOLEAN_TO_JSVAL(success);
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
+            jsval dataVal[4];
+            jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
+            dataVal[0] = value;
+            dataVal[1] = std_string_to_jsval(cx, currencyName);
+            dataVal[2] = INT_TO_JSVAL(amount);
+            dataVal[3] = BOOLEAN_TO_JSVAL(success);
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
+
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onAdColonyStarted(const sdkbox::AdColonyAdInfo& info)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onAdColonyStarted";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onAdColonyStarted";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
+            jsval dataVal[1];
+
+            jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
-        
-        dataVal[0] = value;
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onAdColonyFinished(const sdkbox::AdColonyAdInfo& info)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onAdColonyFinished";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onAdColonyFinished";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
+            jsval dataVal[1];
+
+            jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        jsval value = OBJECT_TO_JSVAL(adinfo_to_obj(s_cx, info));
-        
-        dataVal[0] = value;
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
 };
@@ -308,12 +318,87 @@ JSBool js_PluginAdColonyJS_PluginAdColony_setListener(JSContext *cx, uint32_t ar
 }
 
 
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_PluginAdColonyJS_PluginAdColony_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_PluginAdColonyJS_PluginAdColony_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        sdkbox::PluginAdColony::init();
+        DeviceIdentifiers::getInstance()->setProviderReady(SdkPlugin::AdColony);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginAdColonyJS_PluginAdColony_init : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_PluginAdColonyJS_PluginAdColony_getVendorIdentifier_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_PluginAdColonyJS_PluginAdColony_getVendorIdentifier_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        std::string ret = DeviceIdentifiers::getInstance()->vendorId();
+        jsval jsret = JSVAL_NULL;
+        jsret = std_string_to_jsval(cx, ret);
+        args.rval().set(jsret);
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginAdColonyJS_PluginAdColony_getVendorIdentifier : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_PluginAdColonyJS_PluginAdColony_getUniqueDeviceID_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_PluginAdColonyJS_PluginAdColony_getUniqueDeviceID_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        std::string ret = DeviceIdentifiers::getInstance()->adColonyDeviceId();
+        jsval jsret = JSVAL_NULL;
+        jsret = std_string_to_jsval(cx, ret);
+        args.rval().set(jsret);
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginAdColonyJS_PluginAdColony_getUniqueDeviceID : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_PluginAdColonyJS_PluginAdColony_getAdvertisingIdentifier_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_PluginAdColonyJS_PluginAdColony_getAdvertisingIdentifier_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        std::string ret = DeviceIdentifiers::getInstance()->adColonyAdvertisingId();
+        jsval jsret = JSVAL_NULL;
+        jsret = std_string_to_jsval(cx, ret);
+        args.rval().set(jsret);
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginAdColonyJS_PluginAdColony_getAdvertisingIdentifier : wrong number of arguments");
+    return false;
+}
+
 #if MOZJS_MAJOR_VERSION >= 31
 void register_all_PluginAdColonyJS_helper(JSContext* cx, JS::HandleObject global) {
     JS::RootedObject pluginObj(cx);
     sdkbox::getJsObjOrCreat(cx, global, "sdkbox.PluginAdColony", &pluginObj);
     
     JS_DefineFunction(cx, pluginObj, "setListener", js_PluginAdColonyJS_PluginAdColony_setListener, 1, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginAdColonyJS_PluginAdColony_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "getVendorIdentifier", js_PluginAdColonyJS_PluginAdColony_getVendorIdentifier_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "getUniqueDeviceID", js_PluginAdColonyJS_PluginAdColony_getUniqueDeviceID_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "getAdvertisingIdentifier", js_PluginAdColonyJS_PluginAdColony_getAdvertisingIdentifier_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
 }
 #else
 void register_all_PluginAdColonyJS_helper(JSContext* cx, JSObject* global) {
@@ -322,5 +407,9 @@ void register_all_PluginAdColonyJS_helper(JSContext* cx, JSObject* global) {
     pluginVal = sdkbox::getJsObjOrCreat(cx, global, "sdkbox.PluginAdColony", &pluginObj);
     
     JS_DefineFunction(cx, pluginObj, "setListener", js_PluginAdColonyJS_PluginAdColony_setListener, 1, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginAdColonyJS_PluginAdColony_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "getVendorIdentifier", js_PluginAdColonyJS_PluginAdColony_getVendorIdentifier_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "getUniqueDeviceID", js_PluginAdColonyJS_PluginAdColony_getUniqueDeviceID_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "getAdvertisingIdentifier", js_PluginAdColonyJS_PluginAdColony_getAdvertisingIdentifier_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
 }
 #endif
@@ -2,6 +2,7 @@
 #include "PluginChartboostJsHelper.h"
 #include "cocos2d_specifics.hpp"
 #include "PluginChartboost/PluginChartboost.h"
+#include "MainThreadQueue.h"
 #include "SDKBoxJSHelper.h"
 
 static JSContext* s_cx = nullptr;
@@ -21,40 +22,62 @@ public:
     
     //Ad callbacks
     void onChartboostCached(const std::string& name) {
-        invokeDelegate("onChartboostCached", name.c_str(), 0, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostCached", name.c_str(), 0, 1);
+        });
     }
     bool onChartboostShouldDisplay(const std::string& name) {
-        invokeDelegate("onChartboostShouldDisplay", name.c_str(), 0, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostShouldDisplay", name.c_str(), 0, 1);
+        });
         return true;
     }
     void onChartboostDisplay(const std::string& name) {
-        invokeDelegate("onChartboostDisplay", name.c_str(), 0, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostDisplay", name.c_str(), 0, 1);
+        });
     }
     void onChartboostDismiss(const std::string& name) {
-        invokeDelegate("onChartboostDismiss", name.c_str(), 0, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostDismiss", name.c_str(), 0, 1);
+        });
     }
     void onChartboostClose(const std::string& name) {
-        invokeDelegate("onChartboostClose", name.c_str(), 0, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostClose", name.c_str(), 0, 1);
+        });
     }
     void onChartboostClick(const std::string& name) {
-        invokeDelegate("onChartboostClick", name.c_str(), 0, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostClick", name.c_str(), 0, 1);
+        });
     }
     void onChartboostReward(const std::string& name, int reward) {
-        invokeDelegate("onChartboostReward", name.c_str(), reward, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostReward", name.c_str(), reward, 2);
+        });
     }
     void onChartboostFailedToLoad(const std::string& name, sdkbox::CB_LoadError e) {
-        invokeDelegate("onChartboostFailedToLoad", name.c_str(), e, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostFailedToLoad", name.c_str(), e, 2);
+        });
     }
     void onChartboostFailToRecordClick(const std::string& name, sdkbox::CB_ClickError e) {
-        invokeDelegate("onChartboostFailToRecordClick", name.c_str(), e, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostFailToRecordClick", name.c_str(), e, 2);
+        });
     }
     
     //Miscellaneous callbacks
     void onChartboostConfirmation() {
-        invokeDelegate("onChartboostConfirmation", nullptr, 0, 0);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostConfirmation", nullptr, 0, 0);
+        });
     }
     void onChartboostCompleteStore() {
-        invokeDelegate("onChartboostCompleteStore", nullptr, 0, 0);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onChartboostCompleteStore", nullptr, 0, 0);
+        });
     }
     
 private:
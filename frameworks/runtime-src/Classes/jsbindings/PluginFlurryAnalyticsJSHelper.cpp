@@ -1,6 +1,9 @@
 
 #include "PluginFlurryAnalyticsJSHelper.h"
 #include "PluginFlurryAnalytics/PluginFlurryAnalytics.h"
+#include "AnalyticsPipeline.h"
+#include "SessionManager.h"
+#include "MainThreadQueue.h"
 #include <sstream>
 #include "js_manual_conversions.h"
 #include "ScriptingCore.h"
@@ -25,44 +28,46 @@ public:
     }
 
     void flurrySessionDidCreateWithInfo(std::map<std::string, std::string>& info) {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "flurrySessionDidCreateWithInfo";
+        std::string jsonStr = map2JsonString(info);
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "flurrySessionDidCreateWithInfo";
+
+            JS::RootedObject obj(cx, mJsHandler);
+            JSAutoCompartment ac(cx, obj);
 
-        JS::RootedObject obj(cx, mJsHandler);
-        JSAutoCompartment ac(cx, obj);
-        
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        std::string jsonStr = map2JsonString(info);
 
-        jsval dataVal[1];
-        dataVal[0] = std_string_to_jsval(cx, jsonStr);
+            jsval dataVal[1];
+            dataVal[0] = std_string_to_jsval(cx, jsonStr);
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
 
 private:
@@ -168,10 +173,42 @@ JSBool js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_logEvent(JSContext *cx,
                 jsret = int32_to_jsval(cx, ret);
                 args.rval().set(jsret);
                 return true;
+            } else if (args.get(1).isObject()) {
+                std::string arg0;
+                ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+                if (!ok) { ok = true; break; }
+                EventParams arg1;
+                ok &= sdkbox::jsval_to_event_params(cx, args.get(1), &arg1);
+                if (!ok) { ok = true; break; }
+                std::map<std::string, std::string> params = arg1.toMap();
+                int ret = sdkbox::PluginFlurryAnalytics::logEvent(arg0, params);
+                jsval jsret = JSVAL_NULL;
+                jsret = int32_to_jsval(cx, ret);
+                args.rval().set(jsret);
+                return true;
             }
         }
     } while (0);
     
+    do {
+        if (argc == 3 && args.get(1).isObject()) {
+            std::string arg0;
+            ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+            if (!ok) { ok = true; break; }
+            EventParams arg1;
+            ok &= sdkbox::jsval_to_event_params(cx, args.get(1), &arg1);
+            if (!ok) { ok = true; break; }
+            bool arg2;
+            arg2 = JS::ToBoolean(args.get(2));
+            std::map<std::string, std::string> params = arg1.toMap();
+            int ret = sdkbox::PluginFlurryAnalytics::logEvent(arg0, params, arg2);
+            jsval jsret = JSVAL_NULL;
+            jsret = int32_to_jsval(cx, ret);
+            args.rval().set(jsret);
+            return true;
+        }
+    } while (0);
+
     do {
         if (argc == 3) {
             std::string arg0;
@@ -254,6 +291,20 @@ JSBool js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_endTimedEvent(JSContext
         }
     } while (0);
     
+    do {
+        if (argc == 2 && args.get(1).isObject()) {
+            std::string arg0;
+            ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+            if (!ok) { ok = true; break; }
+            EventParams arg1;
+            ok &= sdkbox::jsval_to_event_params(cx, args.get(1), &arg1);
+            if (!ok) { ok = true; break; }
+            std::map<std::string, std::string> params = arg1.toMap();
+            sdkbox::PluginFlurryAnalytics::endTimedEvent(arg0, params);
+            return true;
+        }
+    } while (0);
+
     do {
         if (argc == 2) {
             std::string arg0;
@@ -270,6 +321,24 @@ JSBool js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_endTimedEvent(JSContext
     return false;
 }
 
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_startSession_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_startSession_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        sdkbox::PluginFlurryAnalytics::startSession();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
+        SessionManager::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_startSession : wrong number of arguments");
+    return false;
+}
+
 #if MOZJS_MAJOR_VERSION >= 31
 void register_PluginFlurryAnalyticsJs_helper(JSContext* cx, JS::HandleObject global) {
     JS::RootedObject pluginObj(cx);
@@ -279,6 +348,7 @@ void register_PluginFlurryAnalyticsJs_helper(JSContext* cx, JS::HandleObject glo
     JS_DefineFunction(cx, pluginObj, "logEvent", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_logEvent, 1, JSPROP_READONLY | JSPROP_PERMANENT);
     JS_DefineFunction(cx, pluginObj, "addOrigin", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_addOrigin, 1, JSPROP_READONLY | JSPROP_PERMANENT);
     JS_DefineFunction(cx, pluginObj, "endTimedEvent", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_endTimedEvent, 1, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "startSession", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_startSession_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
 }
 #else
 void register_PluginFlurryAnalyticsJs_helper(JSContext* cx, JSObject* global) {
@@ -290,6 +360,7 @@ void register_PluginFlurryAnalyticsJs_helper(JSContext* cx, JSObject* global) {
     JS_DefineFunction(cx, pluginObj, "logEvent", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_logEvent, 1, JSPROP_READONLY | JSPROP_PERMANENT);
     JS_DefineFunction(cx, pluginObj, "addOrigin", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_addOrigin, 1, JSPROP_READONLY | JSPROP_PERMANENT);
     JS_DefineFunction(cx, pluginObj, "endTimedEvent", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_endTimedEvent, 1, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "startSession", js_PluginFlurryAnalyticsJS_PluginFlurryAnalytics_startSession_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
 }
 #endif
 
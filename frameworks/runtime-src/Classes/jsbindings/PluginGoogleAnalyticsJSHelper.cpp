@@ -0,0 +1,121 @@
+
+#include "PluginGoogleAnalyticsJSHelper.h"
+#include "PluginGoogleAnalytics/PluginGoogleAnalytics.h"
+#include "AnalyticsPipeline.h"
+#include "SessionManager.h"
+#include "js_manual_conversions.h"
+#include "cocos2d_specifics.hpp"
+#include "SDKBoxJSHelper.h"
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        sdkbox::PluginGoogleAnalytics::init();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::GoogleAnalytics);
+        SessionManager::getInstance()->setProviderReady(SdkPlugin::GoogleAnalytics);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_init : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logTiming_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logTiming_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 4) {
+        std::string arg0;
+        int arg1;
+        std::string arg2;
+        std::string arg3;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_int32(cx, args.get(1), (int32_t *)&arg1);
+        ok &= jsval_to_std_string(cx, args.get(2), &arg2);
+        ok &= jsval_to_std_string(cx, args.get(3), &arg3);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logTiming : Error processing arguments");
+        AnalyticsPipeline::getInstance()->gaLogTiming(arg0, arg1, arg2, arg3);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logTiming : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logEvent_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logEvent_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 4) {
+        std::string arg0;
+        std::string arg1;
+        std::string arg2;
+        int arg3;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_std_string(cx, args.get(1), &arg1);
+        ok &= jsval_to_std_string(cx, args.get(2), &arg2);
+        ok &= jsval_to_int32(cx, args.get(3), (int32_t *)&arg3);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logEvent : Error processing arguments");
+        AnalyticsPipeline::getInstance()->gaLogEvent(arg0, arg1, arg2, arg3);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logEvent : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logScreen_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logScreen_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logScreen : Error processing arguments");
+        AnalyticsPipeline::getInstance()->gaLogScreen(arg0);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logScreen : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+void register_PluginGoogleAnalyticsJs_helper(JSContext* cx, JS::HandleObject global) {
+    JS::RootedObject pluginObj(cx);
+    sdkbox::getJsObjOrCreat(cx, global, "sdkbox.PluginGoogleAnalytics", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "logTiming", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logTiming_helper, 4, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "logEvent", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logEvent_helper, 4, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "logScreen", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logScreen_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+}
+#else
+void register_PluginGoogleAnalyticsJs_helper(JSContext* cx, JSObject* global) {
+    jsval pluginVal;
+    JSObject* pluginObj;
+    pluginVal = sdkbox::getJsObjOrCreat(cx, global, "sdkbox.PluginGoogleAnalytics", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "logTiming", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logTiming_helper, 4, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "logEvent", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logEvent_helper, 4, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "logScreen", js_PluginGoogleAnalyticsJS_PluginGoogleAnalytics_logScreen_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+}
+#endif
@@ -1,6 +1,7 @@
 #include "PluginIAPJSHelper.hpp"
 #include "cocos2d_specifics.hpp"
 #include "PluginIAP/PluginIAP.h"
+#include "MainThreadQueue.h"
 
 extern JSObject* jsb_sdkbox_PluginAdColony_prototype;
 
@@ -101,255 +102,267 @@ public:
     
     void onSuccess(const sdkbox::Product& info)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onSuccess";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onSuccess";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
-        
-        jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+            jsval dataVal[1];
+
+            jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        dataVal[0] = value;
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onFailure(const sdkbox::Product& info, const std::string& msg)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onFailure";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onFailure";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[2];
-        jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+            jsval dataVal[2];
+            jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+            dataVal[1] = std_string_to_jsval(cx, msg);
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        dataVal[0] = value;
-        dataVal[1] = std_string_to_jsval(cx, msg);
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onCanceled(const sdkbox::Product& info)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onCanceled";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onCanceled";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
-        jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+            jsval dataVal[1];
+            jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        dataVal[0] = value;
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onRestored(const sdkbox::Product& info)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onRestored";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onRestored";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
-        jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+            jsval dataVal[1];
+            jsval value = OBJECT_TO_JSVAL(product_to_obj(s_cx, info));
+
+            dataVal[0] = value;
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        dataVal[0] = value;
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onProductRequestSuccess(const std::vector<sdkbox::Product>& products)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onProductRequestSuccess";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onProductRequestSuccess";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
-        jsval value = std_vector_product_to_jsval(s_cx, products);
+            jsval dataVal[1];
+            jsval value = std_vector_product_to_jsval(s_cx, products);
+
+            dataVal[0] = value;
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        dataVal[0] = value;
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
     
     void onProductRequestFailure(const std::string& msg)
     {
-        if (!s_cx)
-        {
-            return;
-        }
-        JSContext* cx = s_cx;
-        const char* func_name = "onProductRequestFailure";
-        
-        JS::RootedObject obj(cx, _JSDelegate);
-        JSAutoCompartment ac(cx, obj);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            if (!s_cx)
+            {
+                return;
+            }
+            JSContext* cx = s_cx;
+            const char* func_name = "onProductRequestFailure";
+
+            JS::RootedObject obj(cx, _JSDelegate);
+            JSAutoCompartment ac(cx, obj);
+
 #if MOZJS_MAJOR_VERSION >= 31
-        bool hasAction;
-        JS::RootedValue retval(cx);
-        JS::RootedValue func_handle(cx);
+            bool hasAction;
+            JS::RootedValue retval(cx);
+            JS::RootedValue func_handle(cx);
 #else
-        JSBool hasAction;
-        jsval retval;
-        jsval func_handle;
+            JSBool hasAction;
+            jsval retval;
+            jsval func_handle;
 #endif
-        jsval dataVal[1];
+            jsval dataVal[1];
+
+            dataVal[0] = std_string_to_jsval(cx, msg);
+
+            if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
+                if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
+                    return;
+                }
+                if(func_handle == JSVAL_VOID) {
+                    return;
+                }
 
-        dataVal[0] = std_string_to_jsval(cx, msg);
-        
-        if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
-            if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
-                return;
-            }
-            if(func_handle == JSVAL_VOID) {
-                return;
-            }
-            
 #if MOZJS_MAJOR_VERSION >= 31
-            JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
+                JS_CallFunctionName(cx, obj, func_name, JS::HandleValueArray::fromMarkedLocation(sizeof(dataVal)/sizeof(*dataVal), dataVal), &retval);
 #else
-            JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
+                JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
-        }
+            }
+        });
     }
 };
 
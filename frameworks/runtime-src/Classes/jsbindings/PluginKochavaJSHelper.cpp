@@ -0,0 +1,93 @@
+
+#include "PluginKochavaJSHelper.h"
+#include "PluginKochava/PluginKochava.h"
+#include "AnalyticsPipeline.h"
+#include "js_manual_conversions.h"
+#include "cocos2d_specifics.hpp"
+#include "SDKBoxJSHelper.h"
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginKochavaJS_PluginKochava_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginKochavaJS_PluginKochava_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        sdkbox::PluginKochava::init();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::Kochava);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginKochavaJS_PluginKochava_init : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginKochavaJS_PluginKochava_trackEvent_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginKochavaJS_PluginKochava_trackEvent_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        std::string arg1;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_std_string(cx, args.get(1), &arg1);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginKochavaJS_PluginKochava_trackEvent : Error processing arguments");
+        AnalyticsPipeline::getInstance()->kochavaTrackEvent(arg0, arg1);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginKochavaJS_PluginKochava_trackEvent : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginKochavaJS_PluginKochava_spatialEvent_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginKochavaJS_PluginKochava_spatialEvent_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 4) {
+        std::string arg0;
+        double arg1;
+        double arg2;
+        double arg3;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= sdkbox::js_to_number(cx, args.get(1), &arg1);
+        ok &= sdkbox::js_to_number(cx, args.get(2), &arg2);
+        ok &= sdkbox::js_to_number(cx, args.get(3), &arg3);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginKochavaJS_PluginKochava_spatialEvent : Error processing arguments");
+        AnalyticsPipeline::getInstance()->kochavaSpatialEvent(arg0, arg1, arg2, arg3);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginKochavaJS_PluginKochava_spatialEvent : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+void register_PluginKochavaJs_helper(JSContext* cx, JS::HandleObject global) {
+    JS::RootedObject pluginObj(cx);
+    sdkbox::getJsObjOrCreat(cx, global, "sdkbox.PluginKochava", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginKochavaJS_PluginKochava_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "trackEvent", js_PluginKochavaJS_PluginKochava_trackEvent_helper, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "spatialEvent", js_PluginKochavaJS_PluginKochava_spatialEvent_helper, 4, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+}
+#else
+void register_PluginKochavaJs_helper(JSContext* cx, JSObject* global) {
+    jsval pluginVal;
+    JSObject* pluginObj;
+    pluginVal = sdkbox::getJsObjOrCreat(cx, global, "sdkbox.PluginKochava", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginKochavaJS_PluginKochava_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "trackEvent", js_PluginKochavaJS_PluginKochava_trackEvent_helper, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "spatialEvent", js_PluginKochavaJS_PluginKochava_spatialEvent_helper, 4, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+}
+#endif
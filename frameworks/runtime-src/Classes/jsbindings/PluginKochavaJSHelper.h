@@ -0,0 +1,15 @@
+
+#ifndef __PLUGIN_KOCHAVA_JS_Helper_H__
+#define __PLUGIN_KOCHAVA_JS_Helper_H__
+
+#include "jsapi.h"
+#include "jsfriendapi.h"
+
+#if MOZJS_MAJOR_VERSION >= 31
+void register_PluginKochavaJs_helper(JSContext* cx, JS::HandleObject global);
+#else
+void register_PluginKochavaJs_helper(JSContext* cx, JSObject* global);
+#endif
+
+#endif // __PLUGIN_KOCHAVA_JS_Helper_H__
+
@@ -2,6 +2,10 @@
 #include "PluginTuneJsHelper.h"
 #include "PluginTuneJS.hpp"
 #include "PluginTune/PluginTune.h"
+#include "AnalyticsPipeline.h"
+#include "DeviceIdentifiers.h"
+#include "SessionManager.h"
+#include "MainThreadQueue.h"
 #include <sstream>
 #include "js_manual_conversions.h"
 #include "cocos2d_specifics.hpp"
@@ -11,37 +15,53 @@ extern JSObject* jsb_sdkbox_PluginTune_prototype;
 
 static JSContext* s_cx = nullptr;
 
-USING_NS_CC;
-#if COCOS2D_VERSION < 0x00030000
-#else
-#define CCObject Ref
-#define CCDirector Director
-#define sharedDirector getInstance
-#endif
-
-class JsCallbackObj : public CCObject
-{
+class TuneListenerJs : public sdkbox::TuneListener {
 public:
-    static JsCallbackObj *create(const std::string &eventName, const std::string &eventData, JSObject *handler)
-    {
-        JsCallbackObj *obj = new JsCallbackObj(eventName, eventData, handler);
-        obj->autorelease();
-        return obj;
+    TuneListenerJs(): m_jsHandler(nullptr) {
+    }
+    ~TuneListenerJs() {
     }
 
-    void start()
+    void setHandler(JSObject* jsHandler) {
+        if (m_jsHandler == jsHandler) {
+            return;
+        }
+        m_jsHandler = jsHandler;
+    }
+
+    virtual void onMobileAppTrackerEnqueuedActionWithReferenceId(const std::string &referenceId)
     {
-        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(JsCallbackObj::callback), this, 0.1, false);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onEnqueuedAction", referenceId);
+        });
+    }
+    virtual void onMobileAppTrackerDidSucceedWithData(const std::string &data)
+    {
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onSucceed", data);
+        });
+    }
+    virtual void onMobileAppTrackerDidFailWithError(const std::string &errorString)
+    {
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onFailed", errorString);
+        });
+    }
+    virtual void onMobileAppTrackerDidReceiveDeeplink(const std::string &deeplink)
+    {
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeDelegate("onReceiveDeeplink", deeplink);
+        });
     }
 
-    void callback(float dt)
+private:
+    void invokeDelegate(const char* func_name, const std::string& eventData)
     {
         if (!s_cx)
         {
             return;
         }
         JSContext* cx = s_cx;
-        const char* func_name = _eventName.data();
 
         JS::RootedObject obj(cx, m_jsHandler);
         JSAutoCompartment ac(cx, obj);
@@ -57,7 +77,7 @@ public:
 #endif
 
         jsval dataVal[1];
-        dataVal[0] = c_string_to_jsval(cx, _eventData.c_str());
+        dataVal[0] = c_string_to_jsval(cx, eventData.c_str());
 
         if (JS_HasProperty(cx, obj, func_name, &hasAction) && hasAction) {
             if(!JS_GetProperty(cx, obj, func_name, &func_handle)) {
@@ -73,59 +93,9 @@ public:
             JS_CallFunctionName(cx, obj, func_name, sizeof(dataVal)/sizeof(*dataVal), dataVal, &retval);
 #endif
         }
-
-        CCDirector::sharedDirector()->getScheduler()->unscheduleAllForTarget(this);
-        release();
-    }
-
-private:
-    JsCallbackObj(const std::string &eventName, const std::string &eventData, JSObject *handler)
-    : _eventName(eventName)
-    , _eventData(eventData)
-    , m_jsHandler(handler)
-    {
-        retain();
     }
 
     JSObject* m_jsHandler;
-    std::string _eventName;
-    std::string _eventData;
-}; // JsCallbackObj
-
-
-class TuneListenerJs : public sdkbox::TuneListener {
-public:
-    TuneListenerJs(): m_jsHandler(nullptr) {
-    }
-    ~TuneListenerJs() {
-    }
-
-    void setHandler(JSObject* jsHandler) {
-        if (m_jsHandler == jsHandler) {
-            return;
-        }
-        m_jsHandler = jsHandler;
-    }
-
-    virtual void onMobileAppTrackerEnqueuedActionWithReferenceId(const std::string &referenceId)
-    {
-        JsCallbackObj::create("onEnqueuedAction", referenceId, m_jsHandler)->start();
-    }
-    virtual void onMobileAppTrackerDidSucceedWithData(const std::string &data)
-    {
-        JsCallbackObj::create("onSucceed", data, m_jsHandler)->start();
-    }
-    virtual void onMobileAppTrackerDidFailWithError(const std::string &errorString)
-    {
-        JsCallbackObj::create("onFailed", errorString, m_jsHandler)->start();
-    }
-    virtual void onMobileAppTrackerDidReceiveDeeplink(const std::string &deeplink)
-    {
-        JsCallbackObj::create("onReceiveDeeplink", deeplink, m_jsHandler)->start();
-    }
-
-private:
-    JSObject* m_jsHandler;
 }; // TuneListenerJs
 
 #if MOZJS_MAJOR_VERSION >= 31
@@ -199,6 +169,119 @@ JSBool js_PluginTuneJS_PluginTune_setLatitude(JSContext *cx, uint32_t argc, jsva
     return false;
 }
 
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginTuneJS_PluginTune_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginTuneJS_PluginTune_init_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        sdkbox::PluginTune::init();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::Tune);
+        SessionManager::getInstance()->setProviderReady(SdkPlugin::Tune);
+        DeviceIdentifiers::getInstance()->setProviderReady(SdkPlugin::Tune);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginTuneJS_PluginTune_init : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginTuneJS_PluginTune_measureEventForScript_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginTuneJS_PluginTune_measureEventForScript_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginTuneJS_PluginTune_measureEventForScript : Error processing arguments");
+        AnalyticsPipeline::getInstance()->tuneMeasureEventJson(arg0);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginTuneJS_PluginTune_measureEventForScript : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginTuneJS_PluginTune_measureEventName_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginTuneJS_PluginTune_measureEventName_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginTuneJS_PluginTune_measureEventName : Error processing arguments");
+        AnalyticsPipeline::getInstance()->tuneMeasureEventName(arg0);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginTuneJS_PluginTune_measureEventName : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginTuneJS_PluginTune_measureSession_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginTuneJS_PluginTune_measureSession_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        AnalyticsPipeline::getInstance()->tuneMeasureSession();
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginTuneJS_PluginTune_measureSession : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginTuneJS_PluginTune_measureEventId_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginTuneJS_PluginTune_measureEventId_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 1) {
+        int arg0;
+        ok &= jsval_to_int32(cx, args.get(0), (int32_t *)&arg0);
+        JSB_PRECONDITION2(ok, cx, false, "js_PluginTuneJS_PluginTune_measureEventId : Error processing arguments");
+        AnalyticsPipeline::getInstance()->tuneMeasureEventId(arg0);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginTuneJS_PluginTune_measureEventId : wrong number of arguments");
+    return false;
+}
+
+#if defined(MOZJS_MAJOR_VERSION)
+bool js_PluginTuneJS_PluginTune_matId_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#elif defined(JS_VERSION)
+JSBool js_PluginTuneJS_PluginTune_matId_helper(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        std::string ret = DeviceIdentifiers::getInstance()->matId();
+        jsval jsret = JSVAL_NULL;
+        jsret = std_string_to_jsval(cx, ret);
+        args.rval().set(jsret);
+        return true;
+    }
+    JS_ReportError(cx, "js_PluginTuneJS_PluginTune_matId : wrong number of arguments");
+    return false;
+}
+
 #if MOZJS_MAJOR_VERSION >= 31
 void register_PluginTuneJs_helper(JSContext* cx, JS::HandleObject global) {
     JS::RootedObject pluginObj(cx);
@@ -206,8 +289,14 @@ void register_PluginTuneJs_helper(JSContext* cx, JS::HandleObject global) {
 
     JS_DefineFunction(cx, pluginObj, "setListener", js_PluginTuneJS_PluginTune_setListener, 1, JSPROP_READONLY | JSPROP_PERMANENT);
     JS_DefineFunction(cx, pluginObj, "setLatitude", js_PluginTuneJS_PluginTune_setLatitude, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE);
-    JS_DefineFunction(cx, pluginObj, "measureEvent", js_PluginTuneJS_PluginTune_measureEventForScript, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEvent", js_PluginTuneJS_PluginTune_measureEventForScript_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEventForScript", js_PluginTuneJS_PluginTune_measureEventForScript_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
     JS_DefineFunction(cx, pluginObj, "setPreloadData", js_PluginTuneJS_PluginTune_setPreloadDataForScript, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginTuneJS_PluginTune_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEventName", js_PluginTuneJS_PluginTune_measureEventName_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureSession", js_PluginTuneJS_PluginTune_measureSession_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEventId", js_PluginTuneJS_PluginTune_measureEventId_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "matId", js_PluginTuneJS_PluginTune_matId_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
 }
 #else
 void register_PluginTuneJs_helper(JSContext* cx, JSObject* global) {
@@ -217,7 +306,13 @@ void register_PluginTuneJs_helper(JSContext* cx, JSObject* global) {
 
     JS_DefineFunction(cx, pluginObj, "setListener", js_PluginTuneJS_PluginTune_setListener, 1, JSPROP_READONLY | JSPROP_PERMANENT);
     JS_DefineFunction(cx, pluginObj, "setLatitude", js_PluginTuneJS_PluginTune_setLatitude, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE);
-    JS_DefineFunction(cx, pluginObj, "measureEvent", js_PluginTuneJS_PluginTune_measureEventForScript, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEvent", js_PluginTuneJS_PluginTune_measureEventForScript_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEventForScript", js_PluginTuneJS_PluginTune_measureEventForScript_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
     JS_DefineFunction(cx, pluginObj, "setPreloadData", js_PluginTuneJS_PluginTune_setPreloadDataForScript, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "init", js_PluginTuneJS_PluginTune_init_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEventName", js_PluginTuneJS_PluginTune_measureEventName_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureSession", js_PluginTuneJS_PluginTune_measureSession_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "measureEventId", js_PluginTuneJS_PluginTune_measureEventId_helper, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE);
+    JS_DefineFunction(cx, pluginObj, "matId", js_PluginTuneJS_PluginTune_matId_helper, 0, JSPROP_PERMANENT | JSPROP_ENUMERATE);
 }
 #endif
@@ -2,6 +2,7 @@
 #include "PluginVungleJsHelper.h"
 #include "cocos2d_specifics.hpp"
 #include "PluginVungle/PluginVungle.h"
+#include "MainThreadQueue.h"
 #include "SDKBoxJSHelper.h"
 
 
@@ -21,27 +22,35 @@ public:
     }
     
     void onVungleCacheAvailable() {
-        std::string name = "onVungleCacheAvailable";
-        invokeDelegate(name, 0);
+        MainThreadQueue::getInstance()->post([=]() {
+            std::string name = "onVungleCacheAvailable";
+            invokeDelegate(name, 0);
+        });
     }
 
     void onVungleStarted() {
-        std::string name = "onVungleStarted";
-        invokeDelegate(name, 0);
+        MainThreadQueue::getInstance()->post([=]() {
+            std::string name = "onVungleStarted";
+            invokeDelegate(name, 0);
+        });
     }
 
     void onVungleFinished() {
-        std::string name = "onVungleFinished";
-        invokeDelegate(name, 0);
+        MainThreadQueue::getInstance()->post([=]() {
+            std::string name = "onVungleFinished";
+            invokeDelegate(name, 0);
+        });
     }
 
     void onVungleAdViewed(bool isComplete) {
-        std::string name = "onVungleAdViewed";
-        if (isComplete) {
-            invokeDelegate(name, 1);
-        } else {
-            invokeDelegate(name, 2);
-        }
+        MainThreadQueue::getInstance()->post([=]() {
+            std::string name = "onVungleAdViewed";
+            if (isComplete) {
+                invokeDelegate(name, 1);
+            } else {
+                invokeDelegate(name, 2);
+            }
+        });
     }
     
 private:
@@ -1,6 +1,8 @@
 #include "SDKBoxJSHelper.h"
 #include <string>
 #include <sstream>
+#include <stdio.h>
+#include <string.h>
 #include "cocos2d_specifics.hpp"
 #include "Sdkbox/Sdkbox.h"
 
@@ -11,6 +13,73 @@
 namespace sdkbox
 {
 
+#if !defined(MOZJS_MAJOR_VERSION) || MOZJS_MAJOR_VERSION < 26
+    // for_each_string_property() on the jsval API of the older engines
+    template <typename Fn>
+    static JSBool for_each_string_property_jsval(JSContext *cx, jsval v, Fn fn)
+    {
+        if (JSVAL_IS_NULL(v) || JSVAL_IS_VOID(v))
+        {
+            return JS_TRUE;
+        }
+        if (JSVAL_IS_PRIMITIVE(v))
+        {
+            return JS_FALSE;
+        }
+
+        JSObject* obj = JSVAL_TO_OBJECT(v);
+        JSObject* it = JS_NewPropertyIterator(cx, obj);
+        if (!it)
+        {
+            return JS_FALSE;
+        }
+        while (true)
+        {
+            jsid idp;
+            jsval key;
+            if (!JS_NextProperty(cx, it, &idp) || !JS_IdToValue(cx, idp, &key))
+            {
+                return JS_FALSE;
+            }
+            if (JSVAL_IS_VOID(key))
+            {
+                break;
+            }
+            if (!JSVAL_IS_STRING(key))
+            {
+                continue;
+            }
+
+            JSStringWrapper keyWrapper(JSVAL_TO_STRING(key), cx);
+            const char* k = keyWrapper.get();
+
+            jsval value;
+            if (!JS_GetPropertyById(cx, obj, idp, &value))
+            {
+                continue;
+            }
+            if (JSVAL_IS_STRING(value))
+            {
+                JSStringWrapper valueWrapper(JSVAL_TO_STRING(value), cx);
+                fn(k, strlen(k), valueWrapper.get(), strlen(valueWrapper.get()));
+            }
+            else if (JSVAL_IS_NUMBER(value))
+            {
+                double d = JSVAL_IS_INT(value) ? JSVAL_TO_INT(value) : JSVAL_TO_DOUBLE(value);
+                char buf[64];
+                int n = snprintf(buf, sizeof(buf), "%.7f", d);
+                fn(k, strlen(k), buf, (size_t)n);
+            }
+            else if (JSVAL_IS_BOOLEAN(value))
+            {
+                const char* b = JSVAL_TO_BOOLEAN(value) ? "true" : "false";
+                fn(k, strlen(k), b, strlen(b));
+            }
+        }
+        return JS_TRUE;
+    }
+#endif
+
     // Spidermonkey v186+
 #if defined(MOZJS_MAJOR_VERSION)
 #if MOZJS_MAJOR_VERSION >= 26
@@ -19,23 +88,79 @@ namespace sdkbox
         return JS::ToNumber( cx, v, dp) && !isnan(*dp);
     }
 
-    bool jsval_to_std_map_string_string(JSContext *cx, JS::HandleValue v, std::map<std::string,std::string> *ret)
+    // Walks the own string-keyed properties of a plain object and hands each
+    // one to fn as (key, keyLength, value, valueLength), formatting numbers
+    // and booleans the way cocos2d::Value::asString() does. Nested objects
+    // are skipped.
+    template <typename Fn>
+    static bool for_each_string_property(JSContext *cx, JS::HandleValue v, Fn fn)
     {
-        cocos2d::ValueMap value;
-        bool ok = jsval_to_ccvaluemap(cx, v, &value);
-        if (!ok)
+        if (v.isNullOrUndefined())
         {
-            return ok;
+            return true;
         }
-        else
+
+        JS::RootedObject obj(cx, v.toObjectOrNull());
+        if (!obj)
         {
-            for (cocos2d::ValueMap::iterator it = value.begin(); it != value.end(); it++)
+            return false;
+        }
+
+        JS::RootedObject it(cx, JS_NewPropertyIterator(cx, obj));
+        while (true)
+        {
+            JS::RootedId idp(cx);
+            JS::RootedValue key(cx);
+            if (!JS_NextProperty(cx, it, idp.address()) || !JS_IdToValue(cx, idp, &key))
             {
-                ret->insert(std::make_pair(it->first, it->second.asString()));
+                return false;
+            }
+            if (key.isUndefined())
+            {
+                break;
+            }
+            if (!key.isString())
+            {
+                continue;
+            }
+
+            JSStringWrapper keyWrapper(key.toString(), cx);
+            const char* k = keyWrapper.get();
+
+            JS::RootedValue value(cx);
+            JS_GetPropertyById(cx, obj, idp, &value);
+            if (value.isString())
+            {
+                JSStringWrapper valueWrapper(value.toString(), cx);
+                fn(k, strlen(k), valueWrapper.get(), strlen(valueWrapper.get()));
+            }
+            else if (value.isNumber())
+            {
+                char buf[64];
+                int n = snprintf(buf, sizeof(buf), "%.7f", value.toNumber());
+                fn(k, strlen(k), buf, (size_t)n);
+            }
+            else if (value.isBoolean())
+            {
+                const char* b = value.toBoolean() ? "true" : "false";
+                fn(k, strlen(k), b, strlen(b));
             }
         }
+        return true;
+    }
 
-        return ok;
+    bool jsval_to_std_map_string_string(JSContext *cx, JS::HandleValue v, std::map<std::string,std::string> *ret)
+    {
+        return for_each_string_property(cx, v, [ret](const char* key, size_t keyLength, const char* value, size_t valueLength) {
+            ret->insert(std::make_pair(std::string(key, keyLength), std::string(value, valueLength)));
+        });
+    }
+
+    bool jsval_to_event_params(JSContext *cx, JS::HandleValue v, EventParams *ret)
+    {
+        return for_each_string_property(cx, v, [ret](const char* key, size_t keyLength, const char* value, size_t valueLength) {
+            ret->set(key, keyLength, value, valueLength);
+        });
     }
 
 #if MOZJS_MAJOR_VERSION < 33
@@ -102,6 +227,13 @@ namespace sdkbox
         return ok;
     }
 
+    bool jsval_to_event_params(JSContext *cx, JS::HandleValue v, EventParams *ret)
+    {
+        return for_each_string_property_jsval(cx, v, [ret](const char* key, size_t keyLength, const char* value, size_t valueLength) {
+            ret->set(key, keyLength, value, valueLength);
+        });
+    }
+
     jsval getJsObjOrCreat(JSContext* cx, JSObject* jsObj, const char* name, JSObject** retObj) {
         JSObject* parent = NULL;
         JSObject* tempObj = jsObj;
@@ -160,6 +292,13 @@ namespace sdkbox
         return ok;
     }
 
+    JSBool jsval_to_event_params(JSContext *cx, jsval v, EventParams *ret)
+    {
+        return for_each_string_property_jsval(cx, v, [ret](const char* key, size_t keyLength, const char* value, size_t valueLength) {
+            ret->set(key, keyLength, value, valueLength);
+        });
+    }
+
     jsval getJsObjOrCreat(JSContext* cx, JSObject* jsObj, const char* name, JSObject** retObj) {
         JSObject* parent = NULL;
         JSObject* tempObj = jsObj;
@@ -0,0 +1,205 @@
+#include "SpatialAggregatorJSHelper.h"
+#include "cocos2d_specifics.hpp"
+#include "SpatialAggregator.h"
+
+#include <vector>
+
+static const char* kAxes[] = { "x", "y", "z" };
+
+// positions as a flat array, [x0, y0, z0, x1, ...], or as an array of
+// {x, y, z} objects such as cc.math.vec3()
+#if MOZJS_MAJOR_VERSION >= 31
+static bool jsval_to_positions(JSContext *cx, JS::HandleValue v, std::vector<float>* ret)
+{
+    if (!v.isObject())
+    {
+        return false;
+    }
+    JS::RootedObject array(cx, v.toObjectOrNull());
+    uint32_t length = 0;
+    if (!JS_IsArrayObject(cx, array) || !JS_GetArrayLength(cx, array, &length))
+    {
+        return false;
+    }
+
+    ret->reserve(length * 3);
+    JS::RootedValue element(cx);
+    JS::RootedValue component(cx);
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (!JS_GetElement(cx, array, i, &element))
+        {
+            return false;
+        }
+        if (element.isNumber())
+        {
+            ret->push_back((float)element.toNumber());
+            continue;
+        }
+        if (!element.isObject())
+        {
+            return false;
+        }
+        JS::RootedObject position(cx, element.toObjectOrNull());
+        for (int axis = 0; axis < 3; axis++)
+        {
+            double d;
+            if (!JS_GetProperty(cx, position, kAxes[axis], &component) || !sdkbox::js_to_number(cx, component, &d))
+            {
+                return false;
+            }
+            ret->push_back((float)d);
+        }
+    }
+    return ret->size() % 3 == 0;
+}
+#else
+static JSBool jsval_to_positions(JSContext *cx, jsval v, std::vector<float>* ret)
+{
+    if (!JSVAL_IS_OBJECT(v) || JSVAL_IS_NULL(v))
+    {
+        return false;
+    }
+    JSObject* array = JSVAL_TO_OBJECT(v);
+    uint32_t length = 0;
+    if (!JS_IsArrayObject(cx, array) || !JS_GetArrayLength(cx, array, &length))
+    {
+        return false;
+    }
+
+    ret->reserve(length * 3);
+    jsval element;
+    jsval component;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        double d;
+        if (!JS_GetElement(cx, array, i, &element))
+        {
+            return false;
+        }
+        if (JSVAL_IS_NUMBER(element))
+        {
+            if (!JS_ValueToNumber(cx, element, &d))
+            {
+                return false;
+            }
+            ret->push_back((float)d);
+            continue;
+        }
+        if (!JSVAL_IS_OBJECT(element) || JSVAL_IS_NULL(element))
+        {
+            return false;
+        }
+        JSObject* position = JSVAL_TO_OBJECT(element);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (!JS_GetProperty(cx, position, kAxes[axis], &component) || !sdkbox::js_to_number(cx, component, &d))
+            {
+                return false;
+            }
+            ret->push_back((float)d);
+        }
+    }
+    return ret->size() % 3 == 0;
+}
+#endif
+
+// sdkbox.SpatialAggregator.add(title, positions), positions as above
+// sdkbox.SpatialAggregator.add(title, x, y, z)
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_SpatialAggregatorJS_add(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_SpatialAggregatorJS_add(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 2) {
+        std::string arg0;
+        std::vector<float> arg1;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_positions(cx, args.get(1), &arg1);
+        JSB_PRECONDITION2(ok, cx, false, "js_SpatialAggregatorJS_add : Error processing arguments");
+        SpatialAggregator::getInstance()->add(arg0, arg1.data(), arg1.size() / 3);
+        args.rval().setUndefined();
+        return true;
+    }
+    if (argc == 4) {
+        std::string arg0;
+        double arg1, arg2, arg3;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= sdkbox::js_to_number(cx, args.get(1), &arg1);
+        ok &= sdkbox::js_to_number(cx, args.get(2), &arg2);
+        ok &= sdkbox::js_to_number(cx, args.get(3), &arg3);
+        JSB_PRECONDITION2(ok, cx, false, "js_SpatialAggregatorJS_add : Error processing arguments");
+        SpatialAggregator::getInstance()->add(arg0, (float)arg1, (float)arg2, (float)arg3);
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_SpatialAggregatorJS_add : wrong number of arguments");
+    return false;
+}
+
+// sdkbox.SpatialAggregator.setGrid(title, [minX, minY, minZ], [maxX, maxY, maxZ], [cellsX, cellsY, cellsZ])
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_SpatialAggregatorJS_setGrid(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_SpatialAggregatorJS_setGrid(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    bool ok = true;
+    if (argc == 4) {
+        std::string arg0;
+        std::vector<float> arg1, arg2, arg3;
+        ok &= jsval_to_std_string(cx, args.get(0), &arg0);
+        ok &= jsval_to_positions(cx, args.get(1), &arg1) && arg1.size() == 3;
+        ok &= jsval_to_positions(cx, args.get(2), &arg2) && arg2.size() == 3;
+        ok &= jsval_to_positions(cx, args.get(3), &arg3) && arg3.size() == 3;
+        JSB_PRECONDITION2(ok, cx, false, "js_SpatialAggregatorJS_setGrid : Error processing arguments");
+        int cells[3] = { (int)arg3[0], (int)arg3[1], (int)arg3[2] };
+        bool ret = SpatialAggregator::getInstance()->setGrid(arg0, arg1.data(), arg2.data(), cells);
+        args.rval().set(BOOLEAN_TO_JSVAL(ret));
+        return true;
+    }
+    JS_ReportError(cx, "js_SpatialAggregatorJS_setGrid : wrong number of arguments");
+    return false;
+}
+
+// sdkbox.SpatialAggregator.flush()
+#if MOZJS_MAJOR_VERSION >= 31
+bool js_SpatialAggregatorJS_flush(JSContext *cx, uint32_t argc, jsval *vp)
+#else
+JSBool js_SpatialAggregatorJS_flush(JSContext *cx, uint32_t argc, jsval *vp)
+#endif
+{
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+    if (argc == 0) {
+        SpatialAggregator::getInstance()->flush();
+        args.rval().setUndefined();
+        return true;
+    }
+    JS_ReportError(cx, "js_SpatialAggregatorJS_flush : wrong number of arguments");
+    return false;
+}
+
+#if MOZJS_MAJOR_VERSION >= 31
+void register_all_SpatialAggregatorJS_helper(JSContext* cx, JS::HandleObject global) {
+    JS::RootedObject pluginObj(cx);
+    sdkbox::getJsObjOrCreat(cx, global, "sdkbox.SpatialAggregator", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "add", js_SpatialAggregatorJS_add, 4, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "setGrid", js_SpatialAggregatorJS_setGrid, 4, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "flush", js_SpatialAggregatorJS_flush, 0, JSPROP_READONLY | JSPROP_PERMANENT);
+}
+#else
+void register_all_SpatialAggregatorJS_helper(JSContext* cx, JSObject* global) {
+    jsval pluginVal;
+    JSObject* pluginObj;
+    pluginVal = sdkbox::getJsObjOrCreat(cx, global, "sdkbox.SpatialAggregator", &pluginObj);
+
+    JS_DefineFunction(cx, pluginObj, "add", js_SpatialAggregatorJS_add, 4, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "setGrid", js_SpatialAggregatorJS_setGrid, 4, JSPROP_READONLY | JSPROP_PERMANENT);
+    JS_DefineFunction(cx, pluginObj, "flush", js_SpatialAggregatorJS_flush, 0, JSPROP_READONLY | JSPROP_PERMANENT);
+}
+#endif
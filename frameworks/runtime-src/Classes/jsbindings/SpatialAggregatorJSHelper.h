@@ -0,0 +1,10 @@
+#ifndef __SPATIAL_AGGREGATOR_JS_HELPER_H__
+#define __SPATIAL_AGGREGATOR_JS_HELPER_H__
+
+#include "jsapi.h"
+#include "jsfriendapi.h"
+#include "SDKBoxJSHelper.h"
+
+void register_all_SpatialAggregatorJS_helper(JSContext* cx, one_JSObject global);
+
+#endif /* defined(__SPATIAL_AGGREGATOR_JS_HELPER_H__) */
@@ -25,6 +25,7 @@
 
 // google analytics
 #include "luabindings/PluginGoogleAnalyticsLua.hpp"
+#include "luabindings/PluginGoogleAnalyticsLuaHelper.h"
 
 // iap
 #include "luabindings/PluginIAPLua.hpp"
@@ -32,6 +33,7 @@
 
 // kochava
 #include "luabindings/PluginKochavaLua.hpp"
+#include "luabindings/PluginKochavaLuaHelper.h"
 
 // tune
 #include "luabindings/PluginTuneLua.hpp"
@@ -41,6 +43,15 @@
 #include "luabindings/PluginVungleLua.hpp"
 #include "luabindings/PluginVungleLuaHelper.h"
 
+// metrics
+#include "luabindings/MetricsLuaHelper.h"
+
+// spatial heat maps
+#include "luabindings/SpatialAggregatorLuaHelper.h"
+
+// analytics event catalog
+#include "luabindings/AnalyticsCatalogLuaHelper.h"
+
 //// facebook
 //#include "luabindings/PluginFacebookLua.hpp"
 //#include "luabindings/PluginFacebookLuaHelper.h"
@@ -76,6 +87,7 @@ static int lua_module_register(lua_State* L)
 
     // google analytics
     register_all_PluginGoogleAnalyticsLua(L);
+    register_PluginGoogleAnalyticsLua_helper(L);
 
     // iap
     register_all_PluginIAPLua(L);
@@ -83,6 +95,7 @@ static int lua_module_register(lua_State* L)
 
     // kochava
     register_all_PluginKochavaLua(L);
+    register_PluginKochavaLua_helper(L);
 
     // tune
     register_all_PluginTuneLua(L);
@@ -91,6 +104,15 @@ static int lua_module_register(lua_State* L)
     // vungle
     register_all_PluginVungleLua(L);
     register_PluginVungleLua_helper(L);
+
+    // metrics
+    register_MetricsLua_helper(L);
+
+    // spatial heat maps
+    register_SpatialAggregatorLua_helper(L);
+
+    // analytics event catalog
+    register_AnalyticsCatalogLua_helper(L);
 //
 //    // facebook
 //    register_all_PluginFacebookLua(L);
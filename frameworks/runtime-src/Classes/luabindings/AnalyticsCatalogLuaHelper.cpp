@@ -0,0 +1,101 @@
+#include "AnalyticsCatalogLuaHelper.h"
+#include "AnalyticsCatalog.h"
+#include "tolua_fix.h"
+#include "SDKBoxLuaHelper.h"
+
+// sdkbox.AnalyticsCatalog:<Id>(params...), one function per catalog event,
+// params in the order of the catalog; returns the number of providers the
+// event was queued for
+static int lua_AnalyticsCatalogLua_AnalyticsCatalog_emitEvent(lua_State* tolua_S, AnalyticsCatalog::EventId id)
+{
+    int argc = 0;
+    bool ok  = true;
+    const CatalogEventSpec& spec = AnalyticsCatalog::getSpec(id);
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.AnalyticsCatalog",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == (int)spec.paramCount)
+    {
+        CatalogValue values[AnalyticsCatalog::kMaxParams];
+        std::string strings[AnalyticsCatalog::kMaxParams];
+        for (int i = 0; i < argc && ok; i++)
+        {
+            int lo = i + 2;
+            switch (spec.params[i].type)
+            {
+                case CatalogType::Int:
+                {
+                    int n = 0;
+                    ok &= luaval_to_int32(tolua_S, lo, &n, "sdkbox.AnalyticsCatalog:emit");
+                    values[i] = CatalogValue(n);
+                    break;
+                }
+                case CatalogType::Double:
+                {
+                    double d = 0;
+                    ok &= luaval_to_number(tolua_S, lo, &d, "sdkbox.AnalyticsCatalog:emit");
+                    values[i] = CatalogValue(d);
+                    break;
+                }
+                case CatalogType::Bool:
+                {
+                    bool b = false;
+                    ok &= luaval_to_boolean(tolua_S, lo, &b, "sdkbox.AnalyticsCatalog:emit");
+                    values[i] = CatalogValue(b);
+                    break;
+                }
+                case CatalogType::String:
+                    ok &= luaval_to_std_string(tolua_S, lo, &strings[i], "sdkbox.AnalyticsCatalog:emit");
+                    values[i] = CatalogValue(StringRef(strings[i]));
+                    break;
+            }
+        }
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_AnalyticsCatalogLua_AnalyticsCatalog_emit'", nullptr);
+            return 0;
+        }
+        int ret = AnalyticsCatalog::emit(id, values, argc);
+        tolua_pushnumber(tolua_S,(lua_Number)ret);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", spec.id, argc, (int)spec.paramCount);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_AnalyticsCatalogLua_AnalyticsCatalog_emit'.",&tolua_err);
+#endif
+    return 0;
+}
+
+template <int Id>
+int lua_AnalyticsCatalogLua_AnalyticsCatalog_emit(lua_State* tolua_S)
+{
+    return lua_AnalyticsCatalogLua_AnalyticsCatalog_emitEvent(tolua_S, (AnalyticsCatalog::EventId)Id);
+}
+
+#define SDKBOX_CATALOG_LUA_FUNCTION(id, name, category, providers, params) \
+        tolua_function(L, #id, lua_AnalyticsCatalogLua_AnalyticsCatalog_emit<AnalyticsCatalog::k##id>);
+
+TOLUA_API int register_AnalyticsCatalogLua_helper(lua_State* L) {
+	tolua_module(L,"sdkbox",0);
+	tolua_beginmodule(L,"sdkbox");
+
+    tolua_usertype(L,"sdkbox.AnalyticsCatalog");
+    tolua_cclass(L,"AnalyticsCatalog","sdkbox.AnalyticsCatalog","",nullptr);
+
+    tolua_beginmodule(L,"AnalyticsCatalog");
+        SDKBOX_ANALYTICS_CATALOG(SDKBOX_CATALOG_LUA_FUNCTION, SDKBOX_CATALOG_NO_PARAM)
+    tolua_endmodule(L);
+
+	tolua_endmodule(L);
+	return 1;
+}
@@ -0,0 +1,14 @@
+#ifndef __ANALYTICS_CATALOG_LUA_HELPER_H__
+#define __ANALYTICS_CATALOG_LUA_HELPER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "tolua++.h"
+#ifdef __cplusplus
+}
+#endif
+
+TOLUA_API int register_AnalyticsCatalogLua_helper(lua_State* L);
+
+#endif
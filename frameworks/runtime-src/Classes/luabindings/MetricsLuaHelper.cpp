@@ -0,0 +1,176 @@
+#include "MetricsLuaHelper.h"
+#include "Metrics.h"
+#include "tolua_fix.h"
+#include "SDKBoxLuaHelper.h"
+
+// sdkbox.Metrics:increment(name[, delta])
+int lua_MetricsLua_Metrics_increment(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.Metrics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 1 || argc == 2)
+    {
+        std::string arg0;
+        long long arg1 = 1;
+        ok &= luaval_to_std_string(tolua_S, 2, &arg0, "sdkbox.Metrics:increment");
+        if (argc == 2)
+        {
+            ok &= luaval_to_long_long(tolua_S, 3, &arg1, "sdkbox.Metrics:increment");
+        }
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_MetricsLua_Metrics_increment'", nullptr);
+            return 0;
+        }
+        Metrics::getInstance()->increment(arg0, arg1);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.Metrics:increment",argc, 2);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_MetricsLua_Metrics_increment'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// sdkbox.Metrics:setGauge(name, value)
+int lua_MetricsLua_Metrics_setGauge(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.Metrics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 2)
+    {
+        std::string arg0;
+        long long arg1;
+        ok &= luaval_to_std_string(tolua_S, 2, &arg0, "sdkbox.Metrics:setGauge");
+        ok &= luaval_to_long_long(tolua_S, 3, &arg1, "sdkbox.Metrics:setGauge");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_MetricsLua_Metrics_setGauge'", nullptr);
+            return 0;
+        }
+        Metrics::getInstance()->setGauge(arg0, arg1);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.Metrics:setGauge",argc, 2);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_MetricsLua_Metrics_setGauge'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// sdkbox.Metrics:record(name, value), adds a sample to a histogram
+int lua_MetricsLua_Metrics_record(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.Metrics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 2)
+    {
+        std::string arg0;
+        long long arg1;
+        ok &= luaval_to_std_string(tolua_S, 2, &arg0, "sdkbox.Metrics:record");
+        ok &= luaval_to_long_long(tolua_S, 3, &arg1, "sdkbox.Metrics:record");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_MetricsLua_Metrics_record'", nullptr);
+            return 0;
+        }
+        Metrics::getInstance()->record(arg0, arg1);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.Metrics:record",argc, 2);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_MetricsLua_Metrics_record'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// sdkbox.Metrics:flush()
+int lua_MetricsLua_Metrics_flush(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.Metrics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        Metrics::getInstance()->flush();
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.Metrics:flush",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_MetricsLua_Metrics_flush'.",&tolua_err);
+#endif
+    return 0;
+}
+
+TOLUA_API int register_MetricsLua_helper(lua_State* L) {
+	tolua_module(L,"sdkbox",0);
+	tolua_beginmodule(L,"sdkbox");
+
+    tolua_usertype(L,"sdkbox.Metrics");
+    tolua_cclass(L,"Metrics","sdkbox.Metrics","",nullptr);
+
+    tolua_beginmodule(L,"Metrics");
+        tolua_function(L,"increment", lua_MetricsLua_Metrics_increment);
+        tolua_function(L,"setGauge", lua_MetricsLua_Metrics_setGauge);
+        tolua_function(L,"record", lua_MetricsLua_Metrics_record);
+        tolua_function(L,"flush", lua_MetricsLua_Metrics_flush);
+    tolua_endmodule(L);
+
+	tolua_endmodule(L);
+	return 1;
+}
@@ -0,0 +1,14 @@
+#ifndef __METRICS_LUA_HELPER_H__
+#define __METRICS_LUA_HELPER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "tolua++.h"
+#ifdef __cplusplus
+}
+#endif
+
+TOLUA_API int register_MetricsLua_helper(lua_State* L);
+
+#endif
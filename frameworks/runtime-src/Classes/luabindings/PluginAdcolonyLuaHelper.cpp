@@ -1,6 +1,8 @@
 
 #include "PluginAdcolonyLuaHelper.h"
 #include "PluginAdColony/PluginAdColony.h"
+#include "DeviceIdentifiers.h"
+#include "MainThreadQueue.h"
 #include "CCLuaEngine.h"
 #include "tolua_fix.h"
 #include "SDKBoxLuaHelper.h"
@@ -32,43 +34,51 @@ public:
 	}
 
     void onAdColonyChange(const sdkbox::AdColonyAdInfo& info, bool available) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyChange")));
-        dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
-        dict.insert(std::make_pair("available", LuaValue::booleanValue(available)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyChange")));
+            dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
+            dict.insert(std::make_pair("available", LuaValue::booleanValue(available)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onAdColonyReward(const sdkbox::AdColonyAdInfo& info, const std::string& currencyName, int amount, bool success) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyReward")));
-        dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
-        dict.insert(std::make_pair("currencyName", LuaValue::stringValue(currencyName)));
-        dict.insert(std::make_pair("amount", LuaValue::intValue(amount)));
-        dict.insert(std::make_pair("success", LuaValue::booleanValue(success)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyReward")));
+            dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
+            dict.insert(std::make_pair("currencyName", LuaValue::stringValue(currencyName)));
+            dict.insert(std::make_pair("amount", LuaValue::intValue(amount)));
+            dict.insert(std::make_pair("success", LuaValue::booleanValue(success)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onAdColonyStarted(const sdkbox::AdColonyAdInfo& info) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyStarted")));
-        dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyStarted")));
+            dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onAdColonyFinished(const sdkbox::AdColonyAdInfo& info) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        LuaValueDict dict;
-        dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyFinished")));
-        dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            LuaValueDict dict;
+            dict.insert(std::make_pair("name", LuaValue::stringValue("onAdColonyFinished")));
+            dict.insert(std::make_pair("info", adInfo2LuaValue(info)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
 
 
@@ -132,6 +142,123 @@ tolua_lerror:
 
 
 
+int lua_PluginAdColonyLua_PluginAdColony_init_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginAdColony",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        sdkbox::PluginAdColony::init();
+        DeviceIdentifiers::getInstance()->setProviderReady(SdkPlugin::AdColony);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginAdColony:init",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginAdColonyLua_PluginAdColony_init'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginAdColonyLua_PluginAdColony_getVendorIdentifier_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginAdColony",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        std::string ret = DeviceIdentifiers::getInstance()->vendorId();
+        tolua_pushcppstring(tolua_S,ret);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginAdColony:getVendorIdentifier",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginAdColonyLua_PluginAdColony_getVendorIdentifier'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginAdColonyLua_PluginAdColony_getUniqueDeviceID_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginAdColony",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        std::string ret = DeviceIdentifiers::getInstance()->adColonyDeviceId();
+        tolua_pushcppstring(tolua_S,ret);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginAdColony:getUniqueDeviceID",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginAdColonyLua_PluginAdColony_getUniqueDeviceID'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginAdColonyLua_PluginAdColony_getAdvertisingIdentifier_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginAdColony",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        std::string ret = DeviceIdentifiers::getInstance()->adColonyAdvertisingId();
+        tolua_pushcppstring(tolua_S,ret);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginAdColony:getAdvertisingIdentifier",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginAdColonyLua_PluginAdColony_getAdvertisingIdentifier'.",&tolua_err);
+#endif
+    return 0;
+}
+
 int extern_PluginAdcolony(lua_State* L) {
 	if (nullptr == L) {
 		return 0;
@@ -142,6 +269,10 @@ int extern_PluginAdcolony(lua_State* L) {
     if (lua_istable(L,-1))
     {
         tolua_function(L,"setListener", lua_PluginAdColonyLua_PluginAdColony_setListener);
+        tolua_function(L,"init", lua_PluginAdColonyLua_PluginAdColony_init_helper);
+        tolua_function(L,"getVendorIdentifier", lua_PluginAdColonyLua_PluginAdColony_getVendorIdentifier_helper);
+        tolua_function(L,"getUniqueDeviceID", lua_PluginAdColonyLua_PluginAdColony_getUniqueDeviceID_helper);
+        tolua_function(L,"getAdvertisingIdentifier", lua_PluginAdColonyLua_PluginAdColony_getAdvertisingIdentifier_helper);
     }
      lua_pop(L, 1);
 
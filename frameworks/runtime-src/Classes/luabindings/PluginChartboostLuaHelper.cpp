@@ -1,6 +1,7 @@
 
 #include "PluginChartboostLuaHelper.h"
 #include "PluginChartboost/PluginChartboost.h"
+#include "MainThreadQueue.h"
 #include "CCLuaEngine.h"
 #include "tolua_fix.h"
 #include "SDKBoxLuaHelper.h"
@@ -31,58 +32,80 @@ public:
 	}
     
     void onChartboostCached(const std::string& name) {
-        invokeLuaHandler("onChartboostCached", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostCached", name.c_str());
+        });
     }
     bool onChartboostShouldDisplay(const std::string& name) {
-        invokeLuaHandler("onChartboostShouldDisplay", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostShouldDisplay", name.c_str());
+        });
         return true;
     }
     void onChartboostDisplay(const std::string& name) {
-        invokeLuaHandler("onChartboostDisplay", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostDisplay", name.c_str());
+        });
     }
     void onChartboostDismiss(const std::string& name) {
-        invokeLuaHandler("onChartboostDismiss", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostDismiss", name.c_str());
+        });
     }
     void onChartboostClose(const std::string& name) {
-        invokeLuaHandler("onChartboostClose", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostClose", name.c_str());
+        });
     }
     void onChartboostClick(const std::string& name) {
-        invokeLuaHandler("onChartboostClick", name.c_str());
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostClick", name.c_str());
+        });
     }
     void onChartboostReward(const std::string& name, int reward) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        LuaValueDict dict;
-        dict.insert(std::make_pair("func", LuaValue::stringValue("onChartboostReward")));
-        dict.insert(std::make_pair("name", LuaValue::stringValue(name)));
-        dict.insert(std::make_pair("reward", LuaValue::intValue(reward)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            LuaValueDict dict;
+            dict.insert(std::make_pair("func", LuaValue::stringValue("onChartboostReward")));
+            dict.insert(std::make_pair("name", LuaValue::stringValue(name)));
+            dict.insert(std::make_pair("reward", LuaValue::intValue(reward)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onChartboostFailedToLoad(const std::string& name, sdkbox::CB_LoadError e) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        LuaValueDict dict;
-        dict.insert(std::make_pair("func", LuaValue::stringValue("onChartboostFailedToLoad")));
-        dict.insert(std::make_pair("name", LuaValue::stringValue(name)));
-        dict.insert(std::make_pair("e", LuaValue::intValue(e)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            LuaValueDict dict;
+            dict.insert(std::make_pair("func", LuaValue::stringValue("onChartboostFailedToLoad")));
+            dict.insert(std::make_pair("name", LuaValue::stringValue(name)));
+            dict.insert(std::make_pair("e", LuaValue::intValue(e)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onChartboostFailToRecordClick(const std::string& name, sdkbox::CB_ClickError e) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        LuaValueDict dict;
-        dict.insert(std::make_pair("func", LuaValue::stringValue("onChartboostFailToRecordClick")));
-        dict.insert(std::make_pair("name", LuaValue::stringValue(name)));
-        dict.insert(std::make_pair("e", LuaValue::intValue(e)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            LuaValueDict dict;
+            dict.insert(std::make_pair("func", LuaValue::stringValue("onChartboostFailToRecordClick")));
+            dict.insert(std::make_pair("name", LuaValue::stringValue(name)));
+            dict.insert(std::make_pair("e", LuaValue::intValue(e)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     
     //Miscellaneous callbacks
     void onChartboostConfirmation() {
-        invokeLuaHandler("onChartboostConfirmation", nullptr);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostConfirmation", nullptr);
+        });
     }
     void onChartboostCompleteStore() {
-        invokeLuaHandler("onChartboostCompleteStore", nullptr);
+        MainThreadQueue::getInstance()->post([=]() {
+            invokeLuaHandler("onChartboostCompleteStore", nullptr);
+        });
     }
 
 
@@ -1,6 +1,9 @@
 
 #include "PluginFlurryAnalyticsLuaHelper.h"
 #include "PluginFlurryAnalytics/PluginFlurryAnalytics.h"
+#include "AnalyticsPipeline.h"
+#include "SessionManager.h"
+#include "MainThreadQueue.h"
 #include "CCLuaEngine.h"
 #include "tolua_fix.h"
 #include "SDKBoxLuaHelper.h"
@@ -35,9 +38,11 @@ public:
 	void flurrySessionDidCreateWithInfo(std::map<std::string, std::string>& info) {
 
 		std::string jsonStr = map2JsonString(info);
-		LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString(jsonStr.c_str());
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString(jsonStr.c_str());
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
 	}
 
 private:
@@ -100,7 +105,18 @@ int lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_logEvent(lua_State* tolua
     {
         if (argc == 2)
         {
-        	if (lua_isboolean(tolua_S, 3)) {
+        	if (lua_istable(tolua_S, 3)) {
+	            std::string arg0;
+	            ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginFlurryAnalytics:logEvent");
+	            if (!ok) { break; }
+	            EventParams arg1;
+	            ok &= luaval_to_event_params(tolua_S, 3, &arg1, "sdkbox.PluginFlurryAnalytics:logEvent");
+	            if (!ok) { break; }
+	            std::map<std::string, std::string> params = arg1.toMap();
+	            int ret = sdkbox::PluginFlurryAnalytics::logEvent(arg0, params);
+	            tolua_pushnumber(tolua_S,(lua_Number)ret);
+	            return 1;
+        	} else if (lua_isboolean(tolua_S, 3)) {
         		std::string arg0;
 	            ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginFlurryAnalytics:logEvent");
 	            if (!ok) { break; }
@@ -124,6 +140,27 @@ int lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_logEvent(lua_State* tolua
         }
     } while (0);
 
+    ok  = true;
+    do
+    {
+        if (argc == 3 && lua_istable(tolua_S, 3))
+        {
+            std::string arg0;
+            ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginFlurryAnalytics:logEvent");
+            if (!ok) { break; }
+            EventParams arg1;
+            ok &= luaval_to_event_params(tolua_S, 3, &arg1, "sdkbox.PluginFlurryAnalytics:logEvent");
+            if (!ok) { break; }
+            bool arg2;
+            ok &= luaval_to_boolean(tolua_S, 4,&arg2, "sdkbox.PluginFlurryAnalytics:logEvent");
+            if (!ok) { break; }
+            std::map<std::string, std::string> params = arg1.toMap();
+            int ret = sdkbox::PluginFlurryAnalytics::logEvent(arg0, params, arg2);
+            tolua_pushnumber(tolua_S,(lua_Number)ret);
+            return 1;
+        }
+    } while (0);
+
     ok  = true;
     do
     {
@@ -239,6 +276,23 @@ int lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_endTimedEvent(lua_State*
     } while (0);
     ok  = true;
     do
+    {
+        if (argc == 2 && lua_istable(tolua_S, 3))
+        {
+            std::string arg0;
+            ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginFlurryAnalytics:endTimedEvent");
+            if (!ok) { break; }
+            EventParams arg1;
+            ok &= luaval_to_event_params(tolua_S, 3, &arg1, "sdkbox.PluginFlurryAnalytics:endTimedEvent");
+            if (!ok) { break; }
+            std::map<std::string, std::string> params = arg1.toMap();
+            sdkbox::PluginFlurryAnalytics::endTimedEvent(arg0, params);
+            lua_settop(tolua_S, 1);
+            return 1;
+        }
+    } while (0);
+    ok  = true;
+    do
     {
         if (argc == 2)
         {
@@ -304,6 +358,37 @@ tolua_lerror:
     return 0;
 }
 
+int lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_startSession_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginFlurryAnalytics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        sdkbox::PluginFlurryAnalytics::startSession();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
+        SessionManager::getInstance()->setProviderReady(SdkPlugin::FlurryAnalytics);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginFlurryAnalytics:startSession",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_startSession'.",&tolua_err);
+#endif
+    return 0;
+}
+
 int extern_PluginFlurryAnalytics(lua_State* L) {
 	if (NULL == L) {
 		return 0;
@@ -317,6 +402,7 @@ int extern_PluginFlurryAnalytics(lua_State* L) {
         tolua_function(L,"addOrigin", lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_addOrigin);
         tolua_function(L,"endTimedEvent", lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_endTimedEvent);
         tolua_function(L,"setListener", lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_setListener);
+        tolua_function(L,"startSession", lua_PluginFlurryAnalyticsLua_PluginFlurryAnalytics_startSession_helper);
     }
     lua_pop(L, 1);
 
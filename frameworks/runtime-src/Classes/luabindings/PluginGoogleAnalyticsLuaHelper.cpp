@@ -0,0 +1,191 @@
+
+#include "PluginGoogleAnalyticsLuaHelper.h"
+#include "PluginGoogleAnalytics/PluginGoogleAnalytics.h"
+#include "AnalyticsPipeline.h"
+#include "SessionManager.h"
+#include "CCLuaEngine.h"
+#include "tolua_fix.h"
+#include "SDKBoxLuaHelper.h"
+
+int lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_init_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginGoogleAnalytics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        sdkbox::PluginGoogleAnalytics::init();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::GoogleAnalytics);
+        SessionManager::getInstance()->setProviderReady(SdkPlugin::GoogleAnalytics);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginGoogleAnalytics:init",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_init'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logTiming_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginGoogleAnalytics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 4)
+    {
+        std::string arg0;
+        int arg1;
+        std::string arg2;
+        std::string arg3;
+        ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginGoogleAnalytics:logTiming");
+        ok &= luaval_to_int32(tolua_S, 3,(int *)&arg1, "sdkbox.PluginGoogleAnalytics:logTiming");
+        ok &= luaval_to_std_string(tolua_S, 4,&arg2, "sdkbox.PluginGoogleAnalytics:logTiming");
+        ok &= luaval_to_std_string(tolua_S, 5,&arg3, "sdkbox.PluginGoogleAnalytics:logTiming");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logTiming'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->gaLogTiming(arg0, arg1, arg2, arg3);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginGoogleAnalytics:logTiming",argc, 4);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logTiming'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logEvent_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginGoogleAnalytics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 4)
+    {
+        std::string arg0;
+        std::string arg1;
+        std::string arg2;
+        int arg3;
+        ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginGoogleAnalytics:logEvent");
+        ok &= luaval_to_std_string(tolua_S, 3,&arg1, "sdkbox.PluginGoogleAnalytics:logEvent");
+        ok &= luaval_to_std_string(tolua_S, 4,&arg2, "sdkbox.PluginGoogleAnalytics:logEvent");
+        ok &= luaval_to_int32(tolua_S, 5,(int *)&arg3, "sdkbox.PluginGoogleAnalytics:logEvent");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logEvent'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->gaLogEvent(arg0, arg1, arg2, arg3);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginGoogleAnalytics:logEvent",argc, 4);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logEvent'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logScreen_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginGoogleAnalytics",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 1)
+    {
+        std::string arg0;
+        ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginGoogleAnalytics:logScreen");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logScreen'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->gaLogScreen(arg0);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginGoogleAnalytics:logScreen",argc, 1);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logScreen'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int extern_PluginGoogleAnalytics(lua_State* L) {
+    if (nullptr == L) {
+        return 0;
+    }
+
+    lua_pushstring(L, "sdkbox.PluginGoogleAnalytics");
+    lua_rawget(L, LUA_REGISTRYINDEX);
+    if (lua_istable(L,-1))
+    {
+        tolua_function(L,"init", lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_init_helper);
+        tolua_function(L,"logTiming", lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logTiming_helper);
+        tolua_function(L,"logEvent", lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logEvent_helper);
+        tolua_function(L,"logScreen", lua_PluginGoogleAnalyticsLua_PluginGoogleAnalytics_logScreen_helper);
+    }
+    lua_pop(L, 1);
+
+    return 1;
+}
+
+TOLUA_API int register_PluginGoogleAnalyticsLua_helper(lua_State* L) {
+    tolua_module(L,"sdkbox",0);
+    tolua_beginmodule(L,"sdkbox");
+
+    extern_PluginGoogleAnalytics(L);
+
+    tolua_endmodule(L);
+    return 1;
+}
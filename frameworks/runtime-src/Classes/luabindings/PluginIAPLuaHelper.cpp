@@ -1,6 +1,7 @@
 
 #include "PluginIAPLuaHelper.hpp"
 #include "PluginIAP/PluginIAP.h"
+#include "MainThreadQueue.h"
 #include "CCLuaEngine.h"
 #include "tolua_fix.h"
 #include "SDKBoxLuaHelper.h"
@@ -33,61 +34,72 @@ public:
 	}
 
     void onSuccess(const sdkbox::Product& p) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("event", LuaValue::stringValue("onSuccess")));
-        dict.insert(std::make_pair("product", prouct2LuaValue(p)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("event", LuaValue::stringValue("onSuccess")));
+            dict.insert(std::make_pair("product", prouct2LuaValue(p)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
 
     void onFailure(const sdkbox::Product& p, const std::string& msg) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("event", LuaValue::stringValue("onFailure")));
-        dict.insert(std::make_pair("product", prouct2LuaValue(p)));
-        dict.insert(std::make_pair("msg", LuaValue::stringValue(msg)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("event", LuaValue::stringValue("onFailure")));
+            dict.insert(std::make_pair("product", prouct2LuaValue(p)));
+            dict.insert(std::make_pair("msg", LuaValue::stringValue(msg)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onCanceled(const sdkbox::Product& p) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("event", LuaValue::stringValue("onCanceled")));
-        dict.insert(std::make_pair("product", prouct2LuaValue(p)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("event", LuaValue::stringValue("onCanceled")));
+            dict.insert(std::make_pair("product", prouct2LuaValue(p)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onRestored(const sdkbox::Product& p) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("event", LuaValue::stringValue("onRestored")));
-        dict.insert(std::make_pair("product", prouct2LuaValue(p)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("event", LuaValue::stringValue("onRestored")));
+            dict.insert(std::make_pair("product", prouct2LuaValue(p)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onProductRequestSuccess(const std::vector<sdkbox::Product>& products) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("event", LuaValue::stringValue("onProductRequestSuccess")));
-        dict.insert(std::make_pair("products", proucts2LuaValue(products)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
-        
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("event", LuaValue::stringValue("onProductRequestSuccess")));
+            dict.insert(std::make_pair("products", proucts2LuaValue(products)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onProductRequestFailure(const std::string& msg) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        
-        LuaValueDict dict;
-        dict.insert(std::make_pair("event", LuaValue::stringValue("onProductRequestFailure")));
-        dict.insert(std::make_pair("msg", LuaValue::stringValue(msg)));
-        stack->pushLuaValueDict(dict);
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+
+            LuaValueDict dict;
+            dict.insert(std::make_pair("event", LuaValue::stringValue("onProductRequestFailure")));
+            dict.insert(std::make_pair("msg", LuaValue::stringValue(msg)));
+            stack->pushLuaValueDict(dict);
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
 
 private:
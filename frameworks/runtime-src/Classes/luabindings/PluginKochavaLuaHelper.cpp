@@ -0,0 +1,147 @@
+
+#include "PluginKochavaLuaHelper.h"
+#include "PluginKochava/PluginKochava.h"
+#include "AnalyticsPipeline.h"
+#include "CCLuaEngine.h"
+#include "tolua_fix.h"
+#include "SDKBoxLuaHelper.h"
+
+int lua_PluginKochavaLua_PluginKochava_init_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginKochava",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        sdkbox::PluginKochava::init();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::Kochava);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginKochava:init",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginKochavaLua_PluginKochava_init'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginKochavaLua_PluginKochava_trackEvent_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginKochava",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 2)
+    {
+        std::string arg0;
+        std::string arg1;
+        ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginKochava:trackEvent");
+        ok &= luaval_to_std_string(tolua_S, 3,&arg1, "sdkbox.PluginKochava:trackEvent");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginKochavaLua_PluginKochava_trackEvent'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->kochavaTrackEvent(arg0, arg1);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginKochava:trackEvent",argc, 2);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginKochavaLua_PluginKochava_trackEvent'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginKochavaLua_PluginKochava_spatialEvent_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginKochava",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 4)
+    {
+        std::string arg0;
+        double arg1;
+        double arg2;
+        double arg3;
+        ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginKochava:spatialEvent");
+        ok &= luaval_to_number(tolua_S, 3,&arg1, "sdkbox.PluginKochava:spatialEvent");
+        ok &= luaval_to_number(tolua_S, 4,&arg2, "sdkbox.PluginKochava:spatialEvent");
+        ok &= luaval_to_number(tolua_S, 5,&arg3, "sdkbox.PluginKochava:spatialEvent");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginKochavaLua_PluginKochava_spatialEvent'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->kochavaSpatialEvent(arg0, arg1, arg2, arg3);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginKochava:spatialEvent",argc, 4);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginKochavaLua_PluginKochava_spatialEvent'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int extern_PluginKochava(lua_State* L) {
+    if (nullptr == L) {
+        return 0;
+    }
+
+    lua_pushstring(L, "sdkbox.PluginKochava");
+    lua_rawget(L, LUA_REGISTRYINDEX);
+    if (lua_istable(L,-1))
+    {
+        tolua_function(L,"init", lua_PluginKochavaLua_PluginKochava_init_helper);
+        tolua_function(L,"trackEvent", lua_PluginKochavaLua_PluginKochava_trackEvent_helper);
+        tolua_function(L,"spatialEvent", lua_PluginKochavaLua_PluginKochava_spatialEvent_helper);
+    }
+    lua_pop(L, 1);
+
+    return 1;
+}
+
+TOLUA_API int register_PluginKochavaLua_helper(lua_State* L) {
+    tolua_module(L,"sdkbox",0);
+    tolua_beginmodule(L,"sdkbox");
+
+    extern_PluginKochava(L);
+
+    tolua_endmodule(L);
+    return 1;
+}
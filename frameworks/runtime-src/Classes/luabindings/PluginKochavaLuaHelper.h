@@ -0,0 +1,15 @@
+
+#ifndef __PLUGIN_KOCHAVA_LUA_HELPER_H__
+#define __PLUGIN_KOCHAVA_LUA_HELPER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "tolua++.h"
+#ifdef __cplusplus
+}
+#endif
+
+TOLUA_API int register_PluginKochavaLua_helper(lua_State* L);
+
+#endif //  __PLUGIN_KOCHAVA_LUA_HELPER_H__
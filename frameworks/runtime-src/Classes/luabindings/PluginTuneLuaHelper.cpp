@@ -1,6 +1,10 @@
 
 #include "PluginTuneLuaHelper.h"
 #include "PluginTune/PluginTune.h"
+#include "AnalyticsPipeline.h"
+#include "DeviceIdentifiers.h"
+#include "SessionManager.h"
+#include "MainThreadQueue.h"
 #include "CCLuaEngine.h"
 #include "tolua_fix.h"
 #include "SDKBoxLuaHelper.h"
@@ -34,31 +38,39 @@ public:
 
     virtual void onMobileAppTrackerEnqueuedActionWithReferenceId(const std::string &referenceId)
     {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onEnqueuedAction");
-        stack->pushString(referenceId.c_str());
-        stack->executeFunctionByHandler(m_luaHandler, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onEnqueuedAction");
+            stack->pushString(referenceId.c_str());
+            stack->executeFunctionByHandler(m_luaHandler, 2);
+        });
     }
     virtual void onMobileAppTrackerDidSucceedWithData(const std::string &data)
     {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onSucceed");
-        stack->pushString(data.c_str());
-        stack->executeFunctionByHandler(m_luaHandler, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onSucceed");
+            stack->pushString(data.c_str());
+            stack->executeFunctionByHandler(m_luaHandler, 2);
+        });
     }
     virtual void onMobileAppTrackerDidFailWithError(const std::string &errorString)
     {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onFailed");
-        stack->pushString(errorString.c_str());
-        stack->executeFunctionByHandler(m_luaHandler, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onFailed");
+            stack->pushString(errorString.c_str());
+            stack->executeFunctionByHandler(m_luaHandler, 2);
+        });
     }
     virtual void onMobileAppTrackerDidReceiveDeeplink(const std::string &deeplink)
     {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onReceiveDeeplink");
-        stack->pushString(deeplink.c_str());
-        stack->executeFunctionByHandler(m_luaHandler, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onReceiveDeeplink");
+            stack->pushString(deeplink.c_str());
+            stack->executeFunctionByHandler(m_luaHandler, 2);
+        });
     }
 
 private:
@@ -130,7 +142,7 @@ int lua_PluginTuneLua_PluginTune_measureEvent(lua_State* tolua_S)
             tolua_error(tolua_S,"invalid arguments in function 'lua_PluginTuneLua_PluginTune_measureEvent'", nullptr);
             return 0;
         }
-        sdkbox::PluginTune::measureEventForScript(arg0);
+        AnalyticsPipeline::getInstance()->tuneMeasureEventJson(arg0);
         lua_settop(tolua_S, 1);
         return 1;
     }
@@ -180,6 +192,170 @@ int lua_PluginTuneLua_PluginTune_setPreloadData(lua_State* tolua_S)
     return 0;
 }
 
+int lua_PluginTuneLua_PluginTune_init_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginTune",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        sdkbox::PluginTune::init();
+        AnalyticsPipeline::getInstance()->setProviderReady(SdkPlugin::Tune);
+        SessionManager::getInstance()->setProviderReady(SdkPlugin::Tune);
+        DeviceIdentifiers::getInstance()->setProviderReady(SdkPlugin::Tune);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginTune:init",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginTuneLua_PluginTune_init'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginTuneLua_PluginTune_measureEventName_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginTune",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 1)
+    {
+        std::string arg0;
+        ok &= luaval_to_std_string(tolua_S, 2,&arg0, "sdkbox.PluginTune:measureEventName");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginTuneLua_PluginTune_measureEventName'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->tuneMeasureEventName(arg0);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginTune:measureEventName",argc, 1);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginTuneLua_PluginTune_measureEventName'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginTuneLua_PluginTune_measureSession_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginTune",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        AnalyticsPipeline::getInstance()->tuneMeasureSession();
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginTune:measureSession",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginTuneLua_PluginTune_measureSession'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginTuneLua_PluginTune_measureEventId_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginTune",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 1)
+    {
+        int arg0;
+        ok &= luaval_to_int32(tolua_S, 2,(int *)&arg0, "sdkbox.PluginTune:measureEventId");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_PluginTuneLua_PluginTune_measureEventId'", nullptr);
+            return 0;
+        }
+        AnalyticsPipeline::getInstance()->tuneMeasureEventId(arg0);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginTune:measureEventId",argc, 1);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginTuneLua_PluginTune_measureEventId'.",&tolua_err);
+#endif
+    return 0;
+}
+
+int lua_PluginTuneLua_PluginTune_matId_helper(lua_State* tolua_S)
+{
+    int argc = 0;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.PluginTune",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        std::string ret = DeviceIdentifiers::getInstance()->matId();
+        tolua_pushcppstring(tolua_S,ret);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.PluginTune:matId",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_PluginTuneLua_PluginTune_matId'.",&tolua_err);
+#endif
+    return 0;
+}
+
 int extern_PluginTune(lua_State* L) {
 	if (nullptr == L) {
 		return 0;
@@ -192,6 +368,11 @@ int extern_PluginTune(lua_State* L) {
         tolua_function(L,"setListener", lua_PluginTuneLua_PluginTune_setListener);
         tolua_function(L,"measureEvent", lua_PluginTuneLua_PluginTune_measureEvent);
         tolua_function(L,"setPreloadData", lua_PluginTuneLua_PluginTune_setPreloadData);
+        tolua_function(L,"init", lua_PluginTuneLua_PluginTune_init_helper);
+        tolua_function(L,"measureEventName", lua_PluginTuneLua_PluginTune_measureEventName_helper);
+        tolua_function(L,"measureSession", lua_PluginTuneLua_PluginTune_measureSession_helper);
+        tolua_function(L,"measureEventId", lua_PluginTuneLua_PluginTune_measureEventId_helper);
+        tolua_function(L,"matId", lua_PluginTuneLua_PluginTune_matId_helper);
     }
     lua_pop(L, 1);
 
@@ -1,6 +1,7 @@
 
 #include "PluginVungleLuaHelper.h"
 #include "PluginVungle/PluginVungle.h"
+#include "MainThreadQueue.h"
 #include "CCLuaEngine.h"
 #include "tolua_fix.h"
 #include "SDKBoxLuaHelper.h"
@@ -32,25 +33,33 @@ public:
 	}
 
     void onVungleCacheAvailable() {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onVungleCacheAvailable");
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onVungleCacheAvailable");
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onVungleStarted() {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onVungleStarted");
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onVungleStarted");
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onVungleFinished() {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onVungleFinished");
-        stack->executeFunctionByHandler(mLuaHandler, 1);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onVungleFinished");
+            stack->executeFunctionByHandler(mLuaHandler, 1);
+        });
     }
     void onVungleAdViewed(bool isComplete) {
-        LuaStack* stack = LUAENGINE->getLuaStack();
-        stack->pushString("onVungleAdViewed");
-        stack->pushBoolean(isComplete);
-        stack->executeFunctionByHandler(mLuaHandler, 2);
+        MainThreadQueue::getInstance()->post([=]() {
+            LuaStack* stack = LUAENGINE->getLuaStack();
+            stack->pushString("onVungleAdViewed");
+            stack->pushBoolean(isComplete);
+            stack->executeFunctionByHandler(mLuaHandler, 2);
+        });
     }
 
 private:
@@ -565,6 +565,53 @@ bool luaval_to_ccluavaluemap(lua_State* L, int lo, LuaValueDict* ret, const char
     return ok;
 }
 
+bool luaval_to_event_params(lua_State* L, int lo, EventParams* ret, const char* funcName)
+{
+    if ( nullptr == L || nullptr == ret)
+        return false;
+
+    tolua_Error tolua_err;
+    if (!tolua_istable(L, lo, 0, &tolua_err))
+    {
+#if COCOS2D_DEBUG >=1
+        // luaval_to_native_err(L,"#ferror:",&tolua_err);
+#endif
+        return false;
+    }
+
+    if (lo < 0)
+    {
+        lo = lua_gettop(L) + lo + 1;                                /* lua_next below pushes onto the stack */
+    }
+
+    size_t keyLength = 0;
+    size_t valueLength = 0;
+    lua_pushnil(L);                                                 /* first key L: lotable ..... nil */
+    while ( 0 != lua_next(L, lo ) )                                 /* L: lotable ..... key value */
+    {
+        /* lua_tolstring on a number key would break lua_next */
+        if (lua_type(L, -2) == LUA_TSTRING)
+        {
+            const char* key = lua_tolstring(L, -2, &keyLength);
+            int type = lua_type(L, -1);
+            if (type == LUA_TSTRING || type == LUA_TNUMBER)
+            {
+                const char* value = lua_tolstring(L, -1, &valueLength);
+                ret->set(key, keyLength, value, valueLength);
+            }
+            else if (type == LUA_TBOOLEAN)
+            {
+                const char* value = lua_toboolean(L, -1) ? "true" : "false";
+                ret->set(key, keyLength, value, strlen(value));
+            }
+        }
+
+        lua_pop(L, 1);                                              /* L: lotable ..... key */
+    }
+
+    return true;
+}
+
 bool luaval_to_ccluavaluevector(lua_State* L, int lo, LuaValueArray* ret, const char* funcName)
 {
     if (nullptr == L || nullptr == ret)
@@ -3,6 +3,7 @@
 
 #include "cocos2d.h"
 #include "CCLuaValue.h"
+#include "EventParams.h"
 
 #if COCOS2D_VERSION >= 0x00030000
 #include "LuaBasicConversions.h"
@@ -84,6 +85,10 @@ void ccvector_ushort_to_luaval(lua_State* L, const std::vector<unsigned short>&
 
 extern bool luaval_to_ccluavaluemap(lua_State* L, int lo, LuaValueDict* ret, const char* funcName = "");
 
+// reads string keys with string, number or boolean values straight into
+// the params, without building a LuaValueDict first
+extern bool luaval_to_event_params(lua_State* L, int lo, EventParams* ret, const char* funcName = "");
+
 extern bool luaval_to_ccluavaluevector(lua_State* L, int lo, LuaValueArray* ret, const char* funcName = "'");
 
 #endif //__SDKBOX_LUA_HELPER_H__
@@ -0,0 +1,198 @@
+#include "SpatialAggregatorLuaHelper.h"
+#include "SpatialAggregator.h"
+#include "tolua_fix.h"
+#include "SDKBoxLuaHelper.h"
+
+#include <vector>
+
+// positions as a flat table, {x0, y0, z0, x1, ...}, or as a table of
+// {x = , y = , z = } such as cc.vec3()
+static bool luaval_to_positions(lua_State* L, int lo, std::vector<float>* ret, const char* funcName)
+{
+    tolua_Error tolua_err;
+    if (!tolua_istable(L, lo, 0, &tolua_err))
+    {
+#if COCOS2D_DEBUG >=1
+        luaval_to_native_err(L,"#ferror:",&tolua_err,funcName);
+#endif
+        return false;
+    }
+
+    static const char* axes[] = { "x", "y", "z" };
+    size_t len = lua_objlen(L, lo);
+    ret->reserve(len * 3);
+    bool ok = true;
+    for (size_t i = 0; i < len && ok; i++)
+    {
+        lua_rawgeti(L, lo, (int)i + 1);
+        if (lua_type(L, -1) == LUA_TNUMBER)
+        {
+            ret->push_back((float)lua_tonumber(L, -1));
+        }
+        else if (lua_istable(L, -1))
+        {
+            for (int axis = 0; axis < 3 && ok; axis++)
+            {
+                lua_getfield(L, -1, axes[axis]);
+                ok = lua_type(L, -1) == LUA_TNUMBER;
+                ret->push_back((float)lua_tonumber(L, -1));
+                lua_pop(L, 1);
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+        lua_pop(L, 1);
+    }
+    return ok && ret->size() % 3 == 0;
+}
+
+// sdkbox.SpatialAggregator:add(title, positions), positions as above
+// sdkbox.SpatialAggregator:add(title, x, y, z)
+int lua_SpatialAggregatorLua_SpatialAggregator_add(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.SpatialAggregator",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 2)
+    {
+        std::string arg0;
+        std::vector<float> arg1;
+        ok &= luaval_to_std_string(tolua_S, 2, &arg0, "sdkbox.SpatialAggregator:add");
+        ok &= luaval_to_positions(tolua_S, 3, &arg1, "sdkbox.SpatialAggregator:add");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_SpatialAggregatorLua_SpatialAggregator_add'", nullptr);
+            return 0;
+        }
+        SpatialAggregator::getInstance()->add(arg0, arg1.data(), arg1.size() / 3);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    if (argc == 4)
+    {
+        std::string arg0;
+        double arg1, arg2, arg3;
+        ok &= luaval_to_std_string(tolua_S, 2, &arg0, "sdkbox.SpatialAggregator:add");
+        ok &= luaval_to_number(tolua_S, 3, &arg1, "sdkbox.SpatialAggregator:add");
+        ok &= luaval_to_number(tolua_S, 4, &arg2, "sdkbox.SpatialAggregator:add");
+        ok &= luaval_to_number(tolua_S, 5, &arg3, "sdkbox.SpatialAggregator:add");
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_SpatialAggregatorLua_SpatialAggregator_add'", nullptr);
+            return 0;
+        }
+        SpatialAggregator::getInstance()->add(arg0, (float)arg1, (float)arg2, (float)arg3);
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.SpatialAggregator:add",argc, 2);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_SpatialAggregatorLua_SpatialAggregator_add'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// sdkbox.SpatialAggregator:setGrid(title, {minX, minY, minZ}, {maxX, maxY, maxZ}, {cellsX, cellsY, cellsZ})
+int lua_SpatialAggregatorLua_SpatialAggregator_setGrid(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.SpatialAggregator",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 4)
+    {
+        std::string arg0;
+        std::vector<float> arg1, arg2, arg3;
+        ok &= luaval_to_std_string(tolua_S, 2, &arg0, "sdkbox.SpatialAggregator:setGrid");
+        ok &= luaval_to_positions(tolua_S, 3, &arg1, "sdkbox.SpatialAggregator:setGrid") && arg1.size() == 3;
+        ok &= luaval_to_positions(tolua_S, 4, &arg2, "sdkbox.SpatialAggregator:setGrid") && arg2.size() == 3;
+        ok &= luaval_to_positions(tolua_S, 5, &arg3, "sdkbox.SpatialAggregator:setGrid") && arg3.size() == 3;
+        if(!ok)
+        {
+            tolua_error(tolua_S,"invalid arguments in function 'lua_SpatialAggregatorLua_SpatialAggregator_setGrid'", nullptr);
+            return 0;
+        }
+        int cells[3] = { (int)arg3[0], (int)arg3[1], (int)arg3[2] };
+        bool ret = SpatialAggregator::getInstance()->setGrid(arg0, arg1.data(), arg2.data(), cells);
+        tolua_pushboolean(tolua_S,(bool)ret);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.SpatialAggregator:setGrid",argc, 4);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_SpatialAggregatorLua_SpatialAggregator_setGrid'.",&tolua_err);
+#endif
+    return 0;
+}
+
+// sdkbox.SpatialAggregator:flush()
+int lua_SpatialAggregatorLua_SpatialAggregator_flush(lua_State* tolua_S)
+{
+    int argc = 0;
+    bool ok  = true;
+
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+#endif
+
+#if COCOS2D_DEBUG >= 1
+    if (!tolua_isusertable(tolua_S,1,"sdkbox.SpatialAggregator",0,&tolua_err)) goto tolua_lerror;
+#endif
+
+    argc = lua_gettop(tolua_S) - 1;
+
+    if (argc == 0)
+    {
+        SpatialAggregator::getInstance()->flush();
+        lua_settop(tolua_S, 1);
+        return 1;
+    }
+    luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n ", "sdkbox.SpatialAggregator:flush",argc, 0);
+    return 0;
+#if COCOS2D_DEBUG >= 1
+    tolua_lerror:
+    tolua_error(tolua_S,"#ferror in function 'lua_SpatialAggregatorLua_SpatialAggregator_flush'.",&tolua_err);
+#endif
+    return 0;
+}
+
+TOLUA_API int register_SpatialAggregatorLua_helper(lua_State* L) {
+	tolua_module(L,"sdkbox",0);
+	tolua_beginmodule(L,"sdkbox");
+
+    tolua_usertype(L,"sdkbox.SpatialAggregator");
+    tolua_cclass(L,"SpatialAggregator","sdkbox.SpatialAggregator","",nullptr);
+
+    tolua_beginmodule(L,"SpatialAggregator");
+        tolua_function(L,"add", lua_SpatialAggregatorLua_SpatialAggregator_add);
+        tolua_function(L,"setGrid", lua_SpatialAggregatorLua_SpatialAggregator_setGrid);
+        tolua_function(L,"flush", lua_SpatialAggregatorLua_SpatialAggregator_flush);
+    tolua_endmodule(L);
+
+	tolua_endmodule(L);
+	return 1;
+}
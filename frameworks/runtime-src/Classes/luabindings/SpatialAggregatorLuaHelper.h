@@ -0,0 +1,14 @@
+#ifndef __SPATIAL_AGGREGATOR_LUA_HELPER_H__
+#define __SPATIAL_AGGREGATOR_LUA_HELPER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "tolua++.h"
+#ifdef __cplusplus
+}
+#endif
+
+TOLUA_API int register_SpatialAggregatorLua_helper(lua_State* L);
+
+#endif
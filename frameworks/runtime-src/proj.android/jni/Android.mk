@@ -12,6 +12,30 @@ LOCAL_SRC_FILES += \
 ../../Classes/AppDelegate.cpp \
 ../../Classes/HelloWorldScene.cpp \
 ../../Classes/MyPluginsMgr.cpp \
+../../Classes/PluginInitGraph.cpp \
+../../Classes/PluginProxy.cpp \
+../../Classes/MenuEvent.cpp \
+../../Classes/PluginEventBus.cpp \
+../../Classes/MainThreadQueue.cpp \
+../../Classes/AnalyticsPipeline.cpp \
+../../Classes/AnalyticsJournal.cpp \
+../../Classes/EventParams.cpp \
+../../Classes/AnalyticsRouter.cpp \
+../../Classes/StringInterner.cpp \
+../../Classes/AnalyticsSampler.cpp \
+../../Classes/ScopedAnalyticsTimer.cpp \
+../../Classes/AnalyticsCoalescer.cpp \
+../../Classes/AnalyticsCodec.cpp \
+../../Classes/Metrics.cpp \
+../../Classes/FrameTimeCollector.cpp \
+../../Classes/SceneLoadTracker.cpp \
+../../Classes/SpatialAggregator.cpp \
+../../Classes/UserProfile.cpp \
+../../Classes/LocationSink.cpp \
+../../Classes/AnalyticsCatalog.cpp \
+../../Classes/SessionManager.cpp \
+../../Classes/AttributionCache.cpp \
+../../Classes/DeviceIdentifiers.cpp \
 ../../Classes/ide-support/SimpleConfigParser.cpp
 
 LOCAL_SRC_FILES += \
@@ -22,13 +46,18 @@ LOCAL_SRC_FILES += \
 ../../Classes/luabindings/PluginFlurryAnalyticsLua.cpp \
 ../../Classes/luabindings/PluginFlurryAnalyticsLuaHelper.cpp \
 ../../Classes/luabindings/PluginGoogleAnalyticsLua.cpp \
+../../Classes/luabindings/PluginGoogleAnalyticsLuaHelper.cpp \
 ../../Classes/luabindings/PluginIAPLua.cpp \
 ../../Classes/luabindings/PluginIAPLuaHelper.cpp \
 ../../Classes/luabindings/PluginKochavaLua.cpp \
+../../Classes/luabindings/PluginKochavaLuaHelper.cpp \
 ../../Classes/luabindings/PluginTuneLua.cpp \
 ../../Classes/luabindings/PluginTuneLuaHelper.cpp \
 ../../Classes/luabindings/PluginVungleLua.cpp \
 ../../Classes/luabindings/PluginVungleLuaHelper.cpp \
+../../Classes/luabindings/MetricsLuaHelper.cpp \
+../../Classes/luabindings/SpatialAggregatorLuaHelper.cpp \
+../../Classes/luabindings/AnalyticsCatalogLuaHelper.cpp \
 ../../Classes/luabindings/SDKBoxLuaHelper.cpp
 
 LOCAL_SRC_FILES += \
@@ -39,13 +68,18 @@ LOCAL_SRC_FILES += \
 ../../Classes/jsbindings/PluginFlurryAnalyticsJS.cpp \
 ../../Classes/jsbindings/PluginFlurryAnalyticsJSHelper.cpp \
 ../../Classes/jsbindings/PluginGoogleAnalyticsJS.cpp \
+../../Classes/jsbindings/PluginGoogleAnalyticsJSHelper.cpp \
 ../../Classes/jsbindings/PluginIAPJS.cpp \
 ../../Classes/jsbindings/PluginIAPJSHelper.cpp \
 ../../Classes/jsbindings/PluginKochavaJS.cpp \
+../../Classes/jsbindings/PluginKochavaJSHelper.cpp \
 ../../Classes/jsbindings/PluginTuneJS.cpp \
 ../../Classes/jsbindings/PluginTuneJSHelper.cpp \
 ../../Classes/jsbindings/PluginVungleJS.cpp \
 ../../Classes/jsbindings/PluginVungleJSHelper.cpp \
+../../Classes/jsbindings/MetricsJSHelper.cpp \
+../../Classes/jsbindings/SpatialAggregatorJSHelper.cpp \
+../../Classes/jsbindings/AnalyticsCatalogJSHelper.cpp \
 ../../Classes/jsbindings/SDKBoxJSHelper.cpp
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes
@@ -224,12 +224,12 @@ end
 function MyPluginMgr:onKochavaTest()
     print("Kochava: test")
     sdkbox.PluginKochava:trackEvent("KochavaCustomEvent", "HelloWorld")
-    sdkbox.PluginKochava:spatialEvent("test", 100, 101, 102)
+    sdkbox.SpatialAggregator:add("test", {100, 101, 102})
 end
 function MyPluginMgr:onTuneTest()
     print("Tune: test")
 
-    sdkbox.PluginTune:measureEventName("login")
+    sdkbox.AnalyticsCatalog:Login()
     sdkbox.PluginTune:measureEventId(0123456789)
 end
 function MyPluginMgr:onVungleVideo()
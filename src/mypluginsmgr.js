@@ -40,7 +40,7 @@ var MyPluginsMgr = {
                 var jsonInfo = JSON.parse(info)
                 console.log("session started")
                 console.log("APIKey :" + jsonInfo.apiKey + " session id :" + jsonInfo.sessionId);
-                sdkbox.PluginFlurryAnalytics.logEvent("test event2 js", JSON.stringify({"eKey1":"eVal1", "eKey2":"eVal2"}));
+                sdkbox.AnalyticsCatalog.FlurryTest("eVal1", "eVal2");
             }
         });
         sdkbox.PluginFlurryAnalytics.startSession();
@@ -161,12 +161,12 @@ var MyPluginsMgr = {
     onKochavaTest:function(sender) {
         console.log("Kochava: test");
         sdkbox.PluginKochava.trackEvent("KochavaCustomEvent", "HelloWorld");
-        sdkbox.PluginKochava.spatialEvent("test", 100, 101, 102);
+        sdkbox.SpatialAggregator.add("test", [100, 101, 102]);
     },
     onTuneTest:function(sender) {
         console.log("Tune: test");
 
-        sdkbox.PluginTune.measureEventName("login");
+        sdkbox.AnalyticsCatalog.Login();
         sdkbox.PluginTune.measureEventId(0123456789);
 
         var event = {};